@@ -35,15 +35,15 @@ if (system.args.length < 3 || system.args.length > 5) {
     if (system.args.length > 4) {
         page.zoomFactor = system.args[4];
     }
+    // Render once the page and whatever it fetches after loading are in, instead of sleeping for a guessed time.
+    page.settings.waitUntil = 'networkidle';
     page.open(address, function (status) {
         if (status !== 'success') {
             console.log('Unable to load the address!');
             phantom.exit(1);
         } else {
-            window.setTimeout(function () {
-                page.render(output);
-                phantom.exit();
-            }, 200);
+            page.render(output);
+            phantom.exit();
         }
     });
 }
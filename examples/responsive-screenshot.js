@@ -94,9 +94,9 @@ page.open(urlAddress, function (status) {
         var folder = urlToDir(urlAddress);
         var output, key;
 
-        function render(n) {
-            if ( !!n ) {
-                key = n - 1;
+        if ( '.pdf' === ext ) {
+            // PDFs are paginated by paper size, so each viewport still needs its own render.
+            for ( key = viewports.length - 1; key >= 0; key-- ) {
                 page.viewportSize = viewports[key];
                 if ( clipping ) {
                     page.clipRect = viewports[key];
@@ -104,11 +104,19 @@ page.open(urlAddress, function (status) {
                 output = folder + "/" + getFileName(viewports[key]);
                 console.log('Saving ' + output);
                 page.render(output);
-                render(key);
             }
+        } else {
+            /**
+             * Resizes the already loaded page to every viewport and captures it, without reloading in between.
+             * With clipping only the visible viewport is captured, otherwise the full document height.
+             */
+            var targets = viewports.map(function (viewport) {
+                output = folder + "/" + getFileName(viewport);
+                console.log('Saving ' + output);
+                return { width: viewport.width, height: viewport.height, file: output };
+            });
+            page.renderViewports(targets, { onlyViewport: clipping });
         }
-
-        render(viewports.length);
     }
     phantom.exit();
 });
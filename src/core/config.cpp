@@ -79,6 +79,9 @@ const QCommandLine::ConfigEntry flags[] = {
     { "max-disk-cache-size", QCommandLine::Param, QCommandLine::Optional,
         "Sets the maximum size of the disk cache in MB", "size", "" },
     { "disk-cache-path", QCommandLine::Param, QCommandLine::Optional, "Sets the path for the disk cache", "path", "" },
+    { "memory-cache-size", QCommandLine::Param, QCommandLine::Optional,
+        "Sets the size in MB of the in-memory cache of static resources shared by all pages (default: 0, disabled)",
+        "size", "" },
 
     // Script and page settings (many correspond to WebPage/EngineBackend settings)
     { "load-images", QCommandLine::Switch, QCommandLine::Optional,
@@ -97,6 +100,19 @@ const QCommandLine::ConfigEntry flags[] = {
         "timeout", "" },
     { "max-auth-attempts", QCommandLine::Param, QCommandLine::Optional,
         "Sets the maximum authentication attempts for network requests", "attempts", "" },
+    { "backend-heartbeat-interval", QCommandLine::Param, QCommandLine::Optional,
+        "Sets how often the engine backend process is pinged, in milliseconds (0 disables the heartbeat)", "interval",
+        "" },
+    { "backend-heartbeat-misses", QCommandLine::Param, QCommandLine::Optional,
+        "Sets how many heartbeats may go unanswered before the engine backend is considered unhealthy", "misses", "" },
+    { "backend-max-restarts", QCommandLine::Param, QCommandLine::Optional,
+        "Sets how often a crashed engine backend is restarted and its page state replayed (0 disables)", "restarts",
+        "" },
+    { "shutdown-timeout", QCommandLine::Param, QCommandLine::Optional,
+        "Sets how long exiting waits for all engine backends before killing them, in milliseconds", "timeout", "" },
+    { "fast-exit", QCommandLine::Switch, QCommandLine::Optional,
+        "Exits without closing the browsers cleanly, for scripts whose outputs are already written", nullptr,
+        nullptr },
     { "javascript-enabled", QCommandLine::Switch, QCommandLine::Optional,
         "Enables or disables JavaScript (default: enabled)", nullptr, nullptr },
     { "web-security", QCommandLine::Switch, QCommandLine::Optional,
@@ -138,6 +154,7 @@ Config::Config(QObject* parent)
     m_settings["disk-cache-enabled"] = false;
     m_settings["max-disk-cache-size"] = 0; // MB
     m_settings["disk-cache-path"] = "";
+    m_settings["memory-cache-size"] = 0; // MB
     m_settings["ignore-ssl-errors"] = false;
     m_settings["ssl-protocol"] = "ANY";
     m_settings["ssl-ciphers"] = "";
@@ -147,6 +164,11 @@ Config::Config(QObject* parent)
     m_settings["ssl-client-key-passphrase"] = QByteArray();
     m_settings["resource-timeout"] = 0; // ms, 0 means no timeout
     m_settings["max-auth-attempts"] = 3;
+    m_settings["backend-heartbeat-interval"] = 1000; // ms, 0 disables the heartbeat
+    m_settings["backend-heartbeat-misses"] = 3;
+    m_settings["backend-max-restarts"] = 3;
+    m_settings["shutdown-timeout"] = 3000; // ms, shared by all backends
+    m_settings["fast-exit"] = false;
 
     m_settings["javascript-enabled"] = true;
     m_settings["web-security"] = true;
@@ -195,6 +217,9 @@ Config::Config(QObject* parent)
     defaultPageSettingsMap[PAGE_SETTINGS_LOCAL_STORAGE_QUOTA] = m_settings["local-storage-quota"];
     defaultPageSettingsMap[PAGE_SETTINGS_RESOURCE_TIMEOUT] = m_settings["resource-timeout"];
     defaultPageSettingsMap[PAGE_SETTINGS_MAX_AUTH_ATTEMPTS] = m_settings["max-auth-attempts"];
+    defaultPageSettingsMap[PAGE_SETTINGS_DISK_CACHE_ENABLED] = m_settings["disk-cache-enabled"];
+    defaultPageSettingsMap[PAGE_SETTINGS_MAX_DISK_CACHE_SIZE] = m_settings["max-disk-cache-size"];
+    defaultPageSettingsMap[PAGE_SETTINGS_DISK_CACHE_PATH] = m_settings["disk-cache-path"];
 
     m_settings["defaultPageSettings"] = defaultPageSettingsMap;
 
@@ -263,6 +288,21 @@ Config::Config(QObject* parent)
         currentSettings[PAGE_SETTINGS_MAX_AUTH_ATTEMPTS] = value;
         setDefaultPageSettings(currentSettings);
     });
+    connect(this, &Config::diskCacheEnabledChanged, this, [this](bool value) {
+        QVariantMap currentSettings = defaultPageSettings();
+        currentSettings[PAGE_SETTINGS_DISK_CACHE_ENABLED] = value;
+        setDefaultPageSettings(currentSettings);
+    });
+    connect(this, &Config::maxDiskCacheSizeChanged, this, [this](int value) {
+        QVariantMap currentSettings = defaultPageSettings();
+        currentSettings[PAGE_SETTINGS_MAX_DISK_CACHE_SIZE] = value;
+        setDefaultPageSettings(currentSettings);
+    });
+    connect(this, &Config::diskCachePathChanged, this, [this](const QString& value) {
+        QVariantMap currentSettings = defaultPageSettings();
+        currentSettings[PAGE_SETTINGS_DISK_CACHE_PATH] = value;
+        setDefaultPageSettings(currentSettings);
+    });
 
     // Also connect proxy changes if they are reflected in page settings
     // This assumes there's a way to get current proxy settings into the map, perhaps via phantom.setProxy
@@ -400,6 +440,9 @@ void Config::setDiskCachePath(const QString& path) {
     }
 }
 
+IMPLEMENT_CONFIG_GETTER(int, memoryCacheSize, "memory-cache-size")
+IMPLEMENT_CONFIG_SETTER_BY_VALUE(int, MemoryCacheSize, "memory-cache-size", memoryCacheSizeChanged)
+
 IMPLEMENT_CONFIG_GETTER(bool, ignoreSslErrors, "ignore-ssl-errors")
 IMPLEMENT_CONFIG_SETTER_BY_VALUE(bool, IgnoreSslErrors, "ignore-ssl-errors", ignoreSslErrorsChanged)
 
@@ -466,6 +509,22 @@ IMPLEMENT_CONFIG_SETTER_BY_VALUE(int, ResourceTimeout, "resource-timeout", resou
 IMPLEMENT_CONFIG_GETTER(int, maxAuthAttempts, "max-auth-attempts")
 IMPLEMENT_CONFIG_SETTER_BY_VALUE(int, MaxAuthAttempts, "max-auth-attempts", maxAuthAttemptsChanged)
 
+IMPLEMENT_CONFIG_GETTER(int, backendHeartbeatInterval, "backend-heartbeat-interval")
+IMPLEMENT_CONFIG_SETTER_BY_VALUE(
+    int, BackendHeartbeatInterval, "backend-heartbeat-interval", backendHeartbeatIntervalChanged)
+
+IMPLEMENT_CONFIG_GETTER(int, backendHeartbeatMisses, "backend-heartbeat-misses")
+IMPLEMENT_CONFIG_SETTER_BY_VALUE(int, BackendHeartbeatMisses, "backend-heartbeat-misses", backendHeartbeatMissesChanged)
+
+IMPLEMENT_CONFIG_GETTER(int, backendMaxRestarts, "backend-max-restarts")
+IMPLEMENT_CONFIG_SETTER_BY_VALUE(int, BackendMaxRestarts, "backend-max-restarts", backendMaxRestartsChanged)
+
+IMPLEMENT_CONFIG_GETTER(int, shutdownTimeout, "shutdown-timeout")
+IMPLEMENT_CONFIG_SETTER_BY_VALUE(int, ShutdownTimeout, "shutdown-timeout", shutdownTimeoutChanged)
+
+IMPLEMENT_CONFIG_GETTER(bool, fastExit, "fast-exit")
+IMPLEMENT_CONFIG_SETTER_BY_VALUE(bool, FastExit, "fast-exit", fastExitChanged)
+
 IMPLEMENT_CONFIG_GETTER(bool, javascriptEnabled, "javascript-enabled")
 IMPLEMENT_CONFIG_SETTER_BY_VALUE(bool, JavascriptEnabled, "javascript-enabled", javascriptEnabledChanged)
 
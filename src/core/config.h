@@ -32,6 +32,7 @@ public:
     Q_PROPERTY(bool diskCacheEnabled READ diskCacheEnabled WRITE setDiskCacheEnabled NOTIFY diskCacheEnabledChanged)
     Q_PROPERTY(int maxDiskCacheSize READ maxDiskCacheSize WRITE setMaxDiskCacheSize NOTIFY maxDiskCacheSizeChanged)
     Q_PROPERTY(QString diskCachePath READ diskCachePath WRITE setDiskCachePath NOTIFY diskCachePathChanged)
+    Q_PROPERTY(int memoryCacheSize READ memoryCacheSize WRITE setMemoryCacheSize NOTIFY memoryCacheSizeChanged)
     Q_PROPERTY(bool ignoreSslErrors READ ignoreSslErrors WRITE setIgnoreSslErrors NOTIFY ignoreSslErrorsChanged)
     Q_PROPERTY(QString sslProtocol READ sslProtocol WRITE setSslProtocol NOTIFY sslProtocolChanged)
     Q_PROPERTY(QString sslCiphers READ sslCiphers WRITE setSslCiphers NOTIFY sslCiphersChanged)
@@ -44,6 +45,15 @@ public:
             sslClientKeyPassphraseChanged)
     Q_PROPERTY(int resourceTimeout READ resourceTimeout WRITE setResourceTimeout NOTIFY resourceTimeoutChanged)
     Q_PROPERTY(int maxAuthAttempts READ maxAuthAttempts WRITE setMaxAuthAttempts NOTIFY maxAuthAttemptsChanged)
+    // --- Engine Backend Settings ---
+    Q_PROPERTY(int backendHeartbeatInterval READ backendHeartbeatInterval WRITE setBackendHeartbeatInterval NOTIFY
+            backendHeartbeatIntervalChanged)
+    Q_PROPERTY(int backendHeartbeatMisses READ backendHeartbeatMisses WRITE setBackendHeartbeatMisses NOTIFY
+            backendHeartbeatMissesChanged)
+    Q_PROPERTY(
+        int backendMaxRestarts READ backendMaxRestarts WRITE setBackendMaxRestarts NOTIFY backendMaxRestartsChanged)
+    Q_PROPERTY(int shutdownTimeout READ shutdownTimeout WRITE setShutdownTimeout NOTIFY shutdownTimeoutChanged)
+    Q_PROPERTY(bool fastExit READ fastExit WRITE setFastExit NOTIFY fastExitChanged)
 
     // --- JavaScript / Page Security Settings ---
     Q_PROPERTY(bool javascriptEnabled READ javascriptEnabled WRITE setJavascriptEnabled NOTIFY javascriptEnabledChanged)
@@ -85,6 +95,7 @@ public:
     bool diskCacheEnabled() const;
     int maxDiskCacheSize() const;
     QString diskCachePath() const;
+    int memoryCacheSize() const;
     bool ignoreSslErrors() const;
     QString sslProtocol() const;
     QString sslCiphers() const;
@@ -94,6 +105,11 @@ public:
     QByteArray sslClientKeyPassphrase() const;
     int resourceTimeout() const;
     int maxAuthAttempts() const;
+    int backendHeartbeatInterval() const;
+    int backendHeartbeatMisses() const;
+    int backendMaxRestarts() const;
+    int shutdownTimeout() const;
+    bool fastExit() const;
     bool javascriptEnabled() const;
     bool webSecurityEnabled() const;
     bool webGLEnabled() const;
@@ -120,6 +136,7 @@ public:
     void setDiskCacheEnabled(bool enabled);
     void setMaxDiskCacheSize(int size);
     void setDiskCachePath(const QString& path);
+    void setMemoryCacheSize(int size);
     void setIgnoreSslErrors(bool ignore);
     void setSslProtocol(const QString& protocol);
     void setSslCiphers(const QString& ciphers);
@@ -129,6 +146,11 @@ public:
     void setSslClientKeyPassphrase(const QByteArray& passphrase);
     void setResourceTimeout(int timeout);
     void setMaxAuthAttempts(int attempts);
+    void setBackendHeartbeatInterval(int interval);
+    void setBackendHeartbeatMisses(int misses);
+    void setBackendMaxRestarts(int restarts);
+    void setShutdownTimeout(int timeout);
+    void setFastExit(bool enabled);
     void setJavascriptEnabled(bool enabled);
     void setWebSecurityEnabled(bool enabled);
     void setWebGLEnabled(bool enabled);
@@ -155,6 +177,7 @@ signals:
     void diskCacheEnabledChanged(bool enabled);
     void maxDiskCacheSizeChanged(int size);
     void diskCachePathChanged(const QString& path);
+    void memoryCacheSizeChanged(int size);
     void ignoreSslErrorsChanged(bool ignore);
     void sslProtocolChanged(const QString& protocol);
     void sslCiphersChanged(const QString& ciphers);
@@ -164,6 +187,11 @@ signals:
     void sslClientKeyPassphraseChanged(const QByteArray& passphrase);
     void resourceTimeoutChanged(int timeout);
     void maxAuthAttemptsChanged(int attempts);
+    void backendHeartbeatIntervalChanged(int interval);
+    void backendHeartbeatMissesChanged(int misses);
+    void backendMaxRestartsChanged(int restarts);
+    void shutdownTimeoutChanged(int timeout);
+    void fastExitChanged(bool enabled);
     void javascriptEnabledChanged(bool enabled);
     void webSecurityEnabledChanged(bool enabled);
     void webGLEnabledChanged(bool enabled);
@@ -13,6 +13,7 @@
 #include <QNetworkAccessManager>
 #include <QNetworkProxy>
 #include <QByteArray>
+#include <QImage>
 
 class CookieJar; // Forward declare CookieJar
 
@@ -32,8 +33,10 @@ public:
     virtual QString windowName() const = 0;
 
     // --- Navigation ---
-    virtual void load(
-        const QNetworkRequest& request, QNetworkAccessManager::Operation operation, const QByteArray& body)
+    // `waitUntil` is the load-completion strategy (see PAGE_SETTINGS_WAIT_UNTIL); loadFinished is emitted once it
+    // is met, and only once per load.
+    virtual void load(const QNetworkRequest& request, QNetworkAccessManager::Operation operation,
+        const QByteArray& body, const QVariantMap& waitUntil)
         = 0;
     virtual void setHtml(const QString& html, const QUrl& baseUrl) = 0;
     virtual void reload() = 0;
@@ -52,9 +55,39 @@ public:
     virtual void setScrollPosition(const QPoint& pos) = 0;
     virtual QPoint scrollPosition() const = 0;
     virtual QByteArray renderPdf(const QVariantMap& paperSize, const QRect& clipRect) = 0;
+    // Writes the PDF to `device` chunk by chunk as the backend produces it, emitting pdfProgress along the way.
+    // The whole document is printed; like renderPdf, it has no notion of a clip rect.
+    virtual bool renderPdfToDevice(const QVariantMap& paperSize, QIODevice* device) = 0;
+    // Prints the page as consecutive page ranges on `workers` copies of it, each range into its own file in
+    // `directory`. Returns the files in page order, or an empty list on failure.
+    virtual QStringList renderPdfParts(
+        const QVariantMap& paperSize, int workers, int pagesPerPart, const QString& directory) = 0;
+    // Template mode: hands `data` to the loaded template and waits until the template reports it is ready (or
+    // `timeout` ms pass) and the result has been painted.
+    virtual bool applyTemplateData(const QVariantMap& data, int timeout) = 0;
+    // Fills and captures the template once per job ({ data, file, format, quality }) on up to `workers` pooled
+    // copies of the page. Returns one error message per job, empty for the files that were written.
+    virtual QStringList renderTemplateBatch(
+        const QVariantList& jobs, int workers, const QVariantMap& paperSize, int timeout) = 0;
     virtual QByteArray renderImage(const QRect& clipRect, bool onlyViewport, const QPoint& scrollPosition) = 0;
+    // Low-latency capture of the viewport as it is currently scrolled, encoded as "png" or "jpeg" by the browser.
+    virtual QByteArray captureViewportFast(const QRect& clipRect, const QByteArray& format, int quality) = 0;
+    // Decoded pixels (QImage::Format_ARGB32) for callers that encode or post-process the capture themselves.
+    virtual QImage captureFrame(const QRect& clipRect, bool onlyViewport, const QPoint& scrollPosition) = 0;
+    // One frame per viewport size, taken from the current document (no reload); the viewport is restored after.
+    virtual QList<QImage> captureViewports(const QList<QSize>& sizes, bool onlyViewport, int settleTime) = 0;
+    // Document-coordinate boxes of the elements matching each selector (first match only unless `all`).
+    virtual QList<QList<QRect>> elementRects(const QStringList& selectors, bool all) = 0;
     virtual qreal zoomFactor() const = 0;
     virtual void setZoomFactor(qreal zoom) = 0;
+    // Paint tracking has a cost in the browser, so repaintRequested is only emitted while this is on.
+    virtual void setRepaintTracking(bool enabled) = 0;
+    // Paints not yet delivered through repaintRequested (an empty rect means everything); they are not emitted later.
+    virtual QList<QRect> takeRepaints() = 0;
+    // Pushes a JPEG screencastFrame at most `fps` times a second (0: every paint), scaled to fit maxWidth/maxHeight
+    // when those are set.
+    virtual bool startScreencast(int fps, int quality, const QSize& maxSize) = 0;
+    virtual void stopScreencast() = 0;
 
     // --- JavaScript Execution ---
     virtual QVariant evaluateJavaScript(const QString& code) = 0;
@@ -71,6 +104,22 @@ public:
     virtual bool navigationLocked() const = 0;
     virtual QVariantMap customHeaders() const = 0;
     virtual void setCustomHeaders(const QVariantMap& headers) = 0;
+    // Installs blocking rules compiled by UrlFilter::compile(); an empty map removes them.
+    virtual void setRequestFilter(const QVariantMap& tables) = 0;
+    // While enabled, resourceRequested carries a JsNetworkRequest through which the receiver can abort or change
+    // the request. Requests without a decision after `deadline` ms continue unchanged.
+    virtual void setRequestInterception(bool enabled, int deadline) = 0;
+    // Writes every response the page receives into a network archive until stopNetworkRecording(), which returns
+    // the number of responses written.
+    virtual bool startNetworkRecording(const QString& fileName) = 0;
+    virtual int stopNetworkRecording() = 0;
+    // Serves requests from a network archive; a request it doesn't hold fails, or goes to the network with
+    // `fallThrough`. An empty file name stops the replay. Returns the archive's response count, -1 on error.
+    virtual int setNetworkReplay(const QString& fileName, bool fallThrough) = 0;
+    // Streams a HAR of the page's requests to the file until stopHar(), which returns the number of entries written
+    // (-1 if the file could not be completed). The entries never leave the backend.
+    virtual bool startHar(const QString& fileName) = 0;
+    virtual int stopHar() = 0;
     virtual void applySettings(const QVariantMap& settings) = 0;
 
     // --- Network / Caching / SSL Settings ---
@@ -123,6 +172,15 @@ public:
     // --- DevTools ---
     virtual int showInspector(int port) = 0;
 
+    // --- Health ---
+    // False once the backend stopped answering; every command then fails immediately.
+    virtual bool isHealthy() const = 0;
+
+    // --- Shutdown (driven by ShutdownCoordinator) ---
+    virtual void requestShutdown(bool graceful) = 0; // Starts shutting down and returns immediately
+    virtual bool waitForShutdown(int msecs) = 0; // True once the backend has exited
+    virtual void kill() = 0; // Last resort for a backend that missed the deadline
+
 signals:
     // Signals to communicate with WebPage
     void loadStarted(const QUrl& url);
@@ -152,11 +210,15 @@ signals:
     void resourceError(const QVariantMap& errorData);
     void resourceTimeout(const QVariantMap& errorData);
 
-    // Rendering
+    // Rendering (page coordinates; an empty rect means the whole page)
     void repaintRequested(const QRect& dirtyRect);
+    void pdfProgress(qint64 bytesWritten, bool done);
+    void screencastFrame(const QByteArray& jpeg, qreal timestamp);
 
     // Backend Initialization
     void initialized(); // Emitted when the backend is ready to accept commands
+    void healthChanged(bool healthy); // Emitted when the backend process stops (or resumes) answering
+    void backendRestarted(int attempt); // A replacement process is up and the page state has been replayed to it
 };
 
 #endif // IENGINEBACKEND_H
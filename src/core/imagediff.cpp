@@ -0,0 +1,276 @@
+#include "imagediff.h"
+#include "imagescaler.h"
+
+#include <QFile>
+#include <bitset>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGEDIFF_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Largest possible YIQ delta (black against white); thresholds are expressed relative to it.
+const double MaxYiqDelta = 35215.0;
+
+const QRgb AntiAliasedColor = qRgb(255, 255, 0);
+const QRgb DiffColor = qRgb(255, 0, 0);
+
+inline double blend(int channel, double alpha) { return 255.0 + (channel - 255.0) * alpha; }
+
+inline double luma(double r, double g, double b) { return r * 0.29889531 + g * 0.58662247 + b * 0.11448223; }
+
+// Alpha is resolved against a white background before comparing, like a viewer would show the capture.
+inline double pixelLuma(QRgb p) {
+    const double a = qAlpha(p) / 255.0;
+    return luma(blend(qRed(p), a), blend(qGreen(p), a), blend(qBlue(p), a));
+}
+
+// Signed so the anti-aliasing check can tell darker from brighter neighbours.
+double colorDelta(QRgb p1, QRgb p2, bool lumaOnly) {
+    if (p1 == p2) {
+        return 0.0;
+    }
+    const double a1 = qAlpha(p1) / 255.0;
+    const double a2 = qAlpha(p2) / 255.0;
+    const double r1 = blend(qRed(p1), a1), g1 = blend(qGreen(p1), a1), b1 = blend(qBlue(p1), a1);
+    const double r2 = blend(qRed(p2), a2), g2 = blend(qGreen(p2), a2), b2 = blend(qBlue(p2), a2);
+
+    const double y1 = luma(r1, g1, b1);
+    const double y2 = luma(r2, g2, b2);
+    const double y = y1 - y2;
+    if (lumaOnly) {
+        return y;
+    }
+    const double i = (r1 * 0.59597799 - g1 * 0.27417610 - b1 * 0.32180189)
+        - (r2 * 0.59597799 - g2 * 0.27417610 - b2 * 0.32180189);
+    const double q = (r1 * 0.21147017 - g1 * 0.52261711 + b1 * 0.31114694)
+        - (r2 * 0.21147017 - g2 * 0.52261711 + b2 * 0.31114694);
+    const double delta = 0.5053 * y * y + 0.299 * i * i + 0.1957 * q * q;
+    return y1 > y2 ? -delta : delta;
+}
+
+class Pixels {
+public:
+    explicit Pixels(const QImage& image)
+        : m_image(image)
+        , m_width(image.width())
+        , m_height(image.height()) { }
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    const QRgb* row(int y) const { return reinterpret_cast<const QRgb*>(m_image.constScanLine(y)); }
+    QRgb at(int x, int y) const { return row(y)[x]; }
+
+    // More than two identical pixels in the 3x3 neighbourhood: part of a flat area, not an edge ramp.
+    bool hasManySiblings(int x, int y) const {
+        const QRgb p = at(x, y);
+        int zeroes = (x == 0 || x == m_width - 1 || y == 0 || y == m_height - 1) ? 1 : 0;
+        for (int ny = qMax(0, y - 1); ny <= qMin(m_height - 1, y + 1); ++ny) {
+            for (int nx = qMax(0, x - 1); nx <= qMin(m_width - 1, x + 1); ++nx) {
+                if ((nx != x || ny != y) && at(nx, ny) == p && ++zeroes > 2) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    QImage m_image;
+    int m_width;
+    int m_height;
+};
+
+// A pixel is considered anti-aliasing when it sits on a brightness ramp between a darkest and a brightest
+// neighbour, and that neighbour is part of a flat area in both images.
+bool isAntiAliased(const Pixels& image, const Pixels& other, int x, int y) {
+    const QRgb p = image.at(x, y);
+    int zeroes = (x == 0 || x == image.width() - 1 || y == 0 || y == image.height() - 1) ? 1 : 0;
+    double minDelta = 0, maxDelta = 0;
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;
+
+    for (int ny = qMax(0, y - 1); ny <= qMin(image.height() - 1, y + 1); ++ny) {
+        for (int nx = qMax(0, x - 1); nx <= qMin(image.width() - 1, x + 1); ++nx) {
+            if (nx == x && ny == y) {
+                continue;
+            }
+            const double delta = colorDelta(p, image.at(nx, ny), true);
+            if (delta == 0) {
+                if (++zeroes > 2) {
+                    return false;
+                }
+            } else if (delta < minDelta) {
+                minDelta = delta;
+                minX = nx;
+                minY = ny;
+            } else if (delta > maxDelta) {
+                maxDelta = delta;
+                maxX = nx;
+                maxY = ny;
+            }
+        }
+    }
+    if (minDelta == 0 || maxDelta == 0) {
+        return false;
+    }
+    return (image.hasManySiblings(minX, minY) && other.hasManySiblings(minX, minY))
+        || (image.hasManySiblings(maxX, maxY) && other.hasManySiblings(maxX, maxY));
+}
+
+// Length of the run of identical pixels starting at `x`.
+int equalRun(const QRgb* a, const QRgb* b, int x, int width) {
+    const int start = x;
+#ifdef IMAGEDIFF_USE_SSE2
+    for (; x + 4 <= width; x += 4) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(va, vb)) != 0xffff) {
+            break;
+        }
+    }
+#endif
+    while (x < width && a[x] == b[x]) {
+        ++x;
+    }
+    return x - start;
+}
+
+QRgb fadedPixel(QRgb p) {
+    // Unchanged pixels are drawn as a light grey version of the first image, so the red stands out.
+    const int grey = qBound(0, qRound(255.0 + (pixelLuma(p) - 255.0) * 0.1), 255);
+    return qRgb(grey, grey, grey);
+}
+
+} // namespace
+
+ImageDiff::Options ImageDiff::Options::fromMap(const QVariantMap& options) {
+    Options result;
+    if (options.contains("threshold")) {
+        result.threshold = qBound(0.0, options.value("threshold").toDouble(), 1.0);
+    }
+    result.includeAntiAliased = options.value("includeAA", false).toBool();
+    result.diffMask = options.value("diffMask").toString();
+    return result;
+}
+
+QVariantMap ImageDiff::Result::toMap() const {
+    QVariantMap map;
+    map["width"] = width;
+    map["height"] = height;
+    map["diffPixels"] = diffPixels;
+    map["antiAliasedPixels"] = antiAliasedPixels;
+    const qint64 total = qint64(width) * height;
+    map["diffRatio"] = total > 0 ? double(diffPixels) / total : 0.0;
+    map["identical"] = error.isEmpty() && diffPixels == 0;
+    if (!error.isEmpty()) {
+        map["error"] = error;
+    }
+    return map;
+}
+
+ImageDiff::Result ImageDiff::compare(const QImage& a, const QImage& b, const Options& options) {
+    Result result;
+    if (a.isNull() || b.isNull()) {
+        result.error = "cannot compare an empty image";
+        return result;
+    }
+    if (a.size() != b.size()) {
+        result.error = QString("image sizes differ: %1x%2 vs %3x%4")
+                           .arg(a.width())
+                           .arg(a.height())
+                           .arg(b.width())
+                           .arg(b.height());
+        return result;
+    }
+    result.width = a.width();
+    result.height = a.height();
+
+    const Pixels img1(a.convertToFormat(QImage::Format_ARGB32));
+    const Pixels img2(b.convertToFormat(QImage::Format_ARGB32));
+    const double maxDelta = MaxYiqDelta * options.threshold * options.threshold;
+    const bool wantMask = !options.diffMask.isEmpty();
+    if (wantMask) {
+        result.mask = QImage(a.size(), QImage::Format_RGB32);
+    }
+
+    for (int y = 0; y < result.height; ++y) {
+        const QRgb* row1 = img1.row(y);
+        const QRgb* row2 = img2.row(y);
+        QRgb* maskRow = wantMask ? reinterpret_cast<QRgb*>(result.mask.scanLine(y)) : nullptr;
+
+        int x = 0;
+        while (x < result.width) {
+            const int run = equalRun(row1, row2, x, result.width);
+            if (maskRow) {
+                for (int i = x; i < x + run; ++i) {
+                    maskRow[i] = fadedPixel(row1[i]);
+                }
+            }
+            x += run;
+            if (x >= result.width) {
+                break;
+            }
+
+            const double delta = colorDelta(row1[x], row2[x], false);
+            QRgb maskColor;
+            if (qAbs(delta) <= maxDelta) {
+                maskColor = fadedPixel(row1[x]);
+            } else if (!options.includeAntiAliased
+                && (isAntiAliased(img1, img2, x, y) || isAntiAliased(img2, img1, x, y))) {
+                ++result.antiAliasedPixels;
+                maskColor = AntiAliasedColor;
+            } else {
+                ++result.diffPixels;
+                maskColor = DiffColor;
+            }
+            if (maskRow) {
+                maskRow[x] = maskColor;
+            }
+            ++x;
+        }
+    }
+
+    if (wantMask && !result.mask.save(options.diffMask, "PNG")) {
+        result.error = "could not write diff mask to " + options.diffMask;
+    }
+    return result;
+}
+
+quint64 ImageDiff::perceptualHash(const QImage& image) {
+    if (image.isNull()) {
+        return 0;
+    }
+    const QImage small
+        = ImageScaler::scale(image, QSize(9, 8), ImageScaler::Area).convertToFormat(QImage::Format_ARGB32);
+    quint64 hash = 0;
+    for (int y = 0; y < 8; ++y) {
+        const QRgb* row = reinterpret_cast<const QRgb*>(small.constScanLine(y));
+        for (int x = 0; x < 8; ++x) {
+            hash = (hash << 1) | (pixelLuma(row[x]) < pixelLuma(row[x + 1]) ? 1 : 0);
+        }
+    }
+    return hash;
+}
+
+int ImageDiff::hashDistance(quint64 a, quint64 b) { return static_cast<int>(std::bitset<64>(a ^ b).count()); }
+
+QImage ImageDiff::load(const QString& source, QString* error) {
+    QImage image;
+    if (source.startsWith("data:")) {
+        const int comma = source.indexOf(',');
+        if (comma >= 0) {
+            image.loadFromData(QByteArray::fromBase64(source.mid(comma + 1).toLatin1()));
+        }
+    } else if (QFile::exists(source)) {
+        image.load(source);
+    } else {
+        *error = "no such file: " + source;
+        return image;
+    }
+    if (image.isNull()) {
+        *error = "could not decode image: " + source.left(64);
+    }
+    return image;
+}
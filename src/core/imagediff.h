@@ -0,0 +1,45 @@
+#ifndef IMAGEDIFF_H
+#define IMAGEDIFF_H
+
+#include <QImage>
+#include <QString>
+#include <QVariantMap>
+
+// Pixel comparison for render regression tests.
+//
+// Identical runs of pixels are skipped four at a time with SSE2 compares; only pixels that differ pay for the
+// perceptual colour delta (YIQ, weighted as in "Measuring perceived color difference using YIQ NTSC transmission
+// color space in mobile applications", Kotsarenko & Ramos 2010) and the anti-aliasing check.
+class ImageDiff {
+public:
+    struct Options {
+        double threshold = 0.1; // 0 (exact) .. 1 (anything goes); the YIQ delta a pixel must exceed to count
+        bool includeAntiAliased = false; // Count pixels that look like anti-aliasing as differences
+        QString diffMask; // When set, a PNG marking differences (red) and anti-aliasing (yellow) is written here
+
+        static Options fromMap(const QVariantMap& options);
+    };
+
+    struct Result {
+        int width = 0;
+        int height = 0;
+        qint64 diffPixels = 0;
+        qint64 antiAliasedPixels = 0;
+        QImage mask; // Only produced when Options::diffMask is set
+        QString error;
+
+        QVariantMap toMap() const;
+    };
+
+    static Result compare(const QImage& a, const QImage& b, const Options& options);
+
+    // 64-bit difference hash: brightness gradients of a 9x8 greyscale thumbnail. Near-identical captures hash to
+    // values a few bits apart, so it is a cheap bucketing key ahead of a full compare().
+    static quint64 perceptualHash(const QImage& image);
+    static int hashDistance(quint64 a, quint64 b);
+
+    // Accepts a file name or a data: URL (as produced by renderBase64 with a "data:image/png;base64," prefix).
+    static QImage load(const QString& source, QString* error);
+};
+
+#endif // IMAGEDIFF_H
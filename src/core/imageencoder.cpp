@@ -0,0 +1,204 @@
+#include "imageencoder.h"
+
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageWriter>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+namespace {
+
+QThreadPool* encoderPool() {
+    static QThreadPool pool;
+    return &pool;
+}
+
+// Qt's PNG writer takes a 0-100 "quality" and maps it onto zlib levels as (100 - quality) * 9 / 91.
+int pngQualityForLevel(int level) {
+    level = qBound(0, level, 9);
+    return 100 - (level * 91 + 8) / 9;
+}
+
+QSize outputSize(const QSize& requested, qreal scale, const QSize& frame) {
+    if (requested.width() <= 0 && requested.height() <= 0) {
+        if (scale > 0) {
+            return QSize(qMax(1, qRound(frame.width() * scale)), qMax(1, qRound(frame.height() * scale)));
+        }
+        return frame;
+    }
+    if (requested.height() <= 0) {
+        return QSize(requested.width(), qMax(1, qRound(qreal(requested.width()) * frame.height() / frame.width())));
+    }
+    if (requested.width() <= 0) {
+        return QSize(qMax(1, qRound(qreal(requested.height()) * frame.width() / frame.height())), requested.height());
+    }
+    return requested;
+}
+
+class EncodeTask : public QRunnable {
+public:
+    EncodeTask(const QImage& frame, ImageEncodeJob* job, QSemaphore* done)
+        : m_frame(frame)
+        , m_job(job)
+        , m_done(done) { }
+
+    void run() override {
+        ImageEncoder::encode(m_frame, *m_job);
+        m_done->release();
+    }
+
+private:
+    QImage m_frame;
+    ImageEncodeJob* m_job;
+    QSemaphore* m_done;
+};
+
+} // namespace
+
+ImageEncodeJob ImageEncodeJob::fromOptions(const QVariantMap& options, const QString& fileName) {
+    ImageEncodeJob job;
+    job.fileName = fileName;
+    const QString format = options.value("format").toString();
+    job.format = format.isEmpty() ? ImageEncoder::formatForFileName(fileName) : ImageEncoder::normalizeFormat(format);
+    if (options.contains("quality")) {
+        job.quality = qBound(0, options.value("quality").toInt(), 100);
+    }
+    if (options.contains("compressionLevel")) {
+        job.compressionLevel = qBound(0, options.value("compressionLevel").toInt(), 9);
+    }
+    if (options.contains("size")) {
+        const QVariantMap size = options.value("size").toMap();
+        job.size = QSize(size.value("width").toInt(), size.value("height").toInt());
+    }
+    if (options.contains("scale")) {
+        job.scale = qMax(0.0, options.value("scale").toReal());
+    }
+    job.filter = ImageScaler::filterFromString(options.value("filter").toString());
+    return job;
+}
+
+QList<ImageEncodeJob> ImageEncodeJob::thumbnailsFromOptions(const QVariant& thumbnail, const ImageEncodeJob& base) {
+    QList<ImageEncodeJob> jobs;
+    const QVariantList specs = thumbnail.type() == QVariant::List ? thumbnail.toList() : QVariantList { thumbnail };
+    for (const QVariant& spec : specs) {
+        QVariantMap options;
+        if (spec.canConvert<QVariantMap>() && spec.type() != QVariant::String) {
+            options = spec.toMap();
+        } else {
+            options.insert("width", spec.toInt());
+        }
+
+        ImageEncodeJob job = base;
+        job.size = QSize(options.value("width").toInt(), options.value("height").toInt());
+        job.scale = 0;
+        if (job.size.width() <= 0 && job.size.height() <= 0) {
+            continue;
+        }
+        job.fileName = options.value("file").toString();
+        if (options.contains("format")) {
+            job.format = ImageEncoder::normalizeFormat(options.value("format").toString());
+        } else if (!job.fileName.isEmpty()) {
+            job.format = ImageEncoder::formatForFileName(job.fileName);
+        }
+        if (options.contains("quality")) {
+            job.quality = qBound(0, options.value("quality").toInt(), 100);
+        }
+        if (options.contains("filter")) {
+            job.filter = ImageScaler::filterFromString(options.value("filter").toString(), base.filter);
+        }
+
+        if (job.fileName.isEmpty() && !base.fileName.isEmpty()) {
+            const QFileInfo info(base.fileName);
+            QString suffix;
+            if (job.size.height() <= 0) {
+                suffix = QString::number(job.size.width()) + "w";
+            } else if (job.size.width() <= 0) {
+                suffix = QString::number(job.size.height()) + "h";
+            } else {
+                suffix = QString::number(job.size.width()) + "x" + QString::number(job.size.height());
+            }
+            job.fileName = info.path() + "/" + info.completeBaseName() + "-" + suffix
+                + (info.suffix().isEmpty() ? QString() : "." + info.suffix());
+        }
+        jobs.append(job);
+    }
+    return jobs;
+}
+
+QByteArray ImageEncoder::normalizeFormat(const QString& format) {
+    QByteArray name = format.toLower().toLatin1();
+    if (name == "jpg") {
+        name = "jpeg";
+    }
+    return QImageWriter::supportedImageFormats().contains(name) ? name : QByteArray();
+}
+
+QByteArray ImageEncoder::formatForFileName(const QString& fileName) {
+    const QByteArray format = normalizeFormat(QFileInfo(fileName).suffix());
+    return format.isEmpty() ? QByteArray("png") : format;
+}
+
+bool ImageEncoder::encode(const QImage& frame, ImageEncodeJob& job) {
+    job.data.clear();
+    job.error.clear();
+    if (job.format.isEmpty()) {
+        job.error = "unsupported image format";
+        return false;
+    }
+
+    const QSize size = outputSize(job.size, job.scale, frame.size());
+    const QImage image = size == frame.size() ? frame : ImageScaler::scale(frame, size, job.filter);
+
+    QBuffer buffer(&job.data);
+    buffer.open(QIODevice::WriteOnly);
+    QImageWriter writer(&buffer, job.format);
+    if (job.format == "png") {
+        if (job.compressionLevel >= 0) {
+            writer.setQuality(pngQualityForLevel(job.compressionLevel));
+        }
+    } else if (job.quality >= 0) {
+        writer.setQuality(job.quality);
+    }
+    if (!writer.write(image)) {
+        job.error = writer.errorString();
+        return false;
+    }
+
+    if (!job.fileName.isEmpty()) {
+        QFile file(job.fileName);
+        if (!file.open(QIODevice::WriteOnly) || file.write(job.data) != job.data.size()) {
+            job.error = "could not write " + job.fileName + ": " + file.errorString();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ImageEncoder::encode(const QImage& frame, QList<ImageEncodeJob>& jobs) {
+    QList<QImage> frames;
+    for (int i = 0; i < jobs.size(); ++i) {
+        frames.append(frame); // Implicitly shared, no copy
+    }
+    return encode(frames, jobs);
+}
+
+bool ImageEncoder::encode(const QList<QImage>& frames, QList<ImageEncodeJob>& jobs) {
+    Q_ASSERT(frames.size() == jobs.size());
+    if (jobs.size() == 1) {
+        return encode(frames.first(), jobs.first()); // Not worth a thread hop
+    }
+
+    QSemaphore done;
+    for (int i = 0; i < jobs.size(); ++i) {
+        encoderPool()->start(new EncodeTask(frames.at(i), &jobs[i], &done));
+    }
+    done.acquire(jobs.size());
+
+    bool ok = true;
+    for (const ImageEncodeJob& job : jobs) {
+        ok = ok && job.error.isEmpty();
+    }
+    return ok;
+}
@@ -0,0 +1,51 @@
+#ifndef IMAGEENCODER_H
+#define IMAGEENCODER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QSize>
+#include <QString>
+#include <QVariantMap>
+
+#include "imagescaler.h"
+
+// One encoded rendition of a captured frame: a format, its encoder settings and an optional output size.
+struct ImageEncodeJob {
+    QByteArray format; // "png", "jpeg" or "webp"
+    int quality = -1; // JPEG/WebP quality 0-100; -1 keeps the encoder default
+    int compressionLevel = -1; // PNG zlib level 0-9; -1 keeps the encoder default
+    QSize size; // Output size; a zero dimension follows the frame's aspect ratio, invalid keeps the frame size
+    qreal scale = 0; // Factor applied to the frame size when no size is given; 0 keeps the frame size
+    ImageScaler::Filter filter = ImageScaler::Area;
+    QString fileName; // Written here when set
+
+    QByteArray data; // Encoded bytes, filled by ImageEncoder
+    QString error; // Set when encoding or writing failed
+
+    // Reads the render() option keys (format, quality, compressionLevel, size, scale, filter). Without a format
+    // option the format is derived from the file name, defaulting to PNG.
+    static ImageEncodeJob fromOptions(const QVariantMap& options, const QString& fileName = QString());
+
+    // Expands the render() "thumbnail" option: a width, a { width, height, file, format, quality, filter } map or a
+    // list of either. Unset keys are inherited from `base`; thumbnails without a file are written next to
+    // `base.fileName` with the requested size appended ("shot.png" -> "shot-200w.png").
+    static QList<ImageEncodeJob> thumbnailsFromOptions(const QVariant& thumbnail, const ImageEncodeJob& base);
+};
+
+// Encodes a captured frame into one or more outputs. Several jobs run concurrently on a dedicated QThreadPool, so
+// fanning one capture out into PNG + JPEG + a thumbnail costs about as much wall time as the slowest of them.
+class ImageEncoder {
+public:
+    // Lower-cased Qt image format name ("jpg" becomes "jpeg"); empty if Qt has no writer for it.
+    static QByteArray normalizeFormat(const QString& format);
+    static QByteArray formatForFileName(const QString& fileName);
+
+    // Blocks until every job has finished. Returns false if any of them failed; see ImageEncodeJob::error.
+    static bool encode(const QImage& frame, QList<ImageEncodeJob>& jobs);
+    // jobs[i] encodes frames[i], e.g. one crop per element.
+    static bool encode(const QList<QImage>& frames, QList<ImageEncodeJob>& jobs);
+    static bool encode(const QImage& frame, ImageEncodeJob& job);
+};
+
+#endif // IMAGEENCODER_H
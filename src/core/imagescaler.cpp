@@ -0,0 +1,201 @@
+#include "imagescaler.h"
+
+#include <QVector>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGESCALER_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const double Pi = 3.14159265358979323846;
+
+// For every output pixel: the first contributing input pixel and its normalised weights.
+struct Contributions {
+    QVector<int> first;
+    QVector<int> count;
+    QVector<int> offset; // Into weights
+    QVector<float> weights;
+};
+
+double sinc(double x) {
+    if (x == 0.0) {
+        return 1.0;
+    }
+    x *= Pi;
+    return std::sin(x) / x;
+}
+
+double lanczos3(double x) { return (x > -3.0 && x < 3.0) ? sinc(x) * sinc(x / 3.0) : 0.0; }
+
+Contributions computeContributions(int srcSize, int dstSize, ImageScaler::Filter filter) {
+    Contributions c;
+    c.first.resize(dstSize);
+    c.count.resize(dstSize);
+    c.offset.resize(dstSize);
+
+    const double ratio = double(srcSize) / dstSize;
+    // Widening the kernel by the ratio when shrinking is what makes it an anti-aliasing filter.
+    const double stretch = qMax(ratio, 1.0);
+    const double support = filter == ImageScaler::Lanczos3 ? 3.0 * stretch : 0.5 * stretch + 0.5;
+
+    for (int i = 0; i < dstSize; ++i) {
+        const double center = (i + 0.5) * ratio;
+        const int first = qMax(0, int(std::floor(center - support)));
+        const int last = qMin(srcSize, int(std::ceil(center + support)));
+
+        c.first[i] = first;
+        c.offset[i] = c.weights.size();
+        double total = 0.0;
+        for (int j = first; j < last; ++j) {
+            double w;
+            if (filter == ImageScaler::Lanczos3) {
+                w = lanczos3((j + 0.5 - center) / stretch);
+            } else {
+                // Overlap of source pixel [j, j + 1) with the output pixel's footprint.
+                const double lo = qMax(double(j), center - 0.5 * stretch);
+                const double hi = qMin(double(j + 1), center + 0.5 * stretch);
+                w = qMax(0.0, hi - lo);
+            }
+            c.weights.append(float(w));
+            total += w;
+        }
+        c.count[i] = last - first;
+        if (total != 0.0) {
+            for (int k = 0; k < c.count[i]; ++k) {
+                c.weights[c.offset[i] + k] = float(c.weights[c.offset[i] + k] / total);
+            }
+        }
+    }
+    return c;
+}
+
+#ifdef IMAGESCALER_USE_SSE2
+inline __m128 loadPixel(const quint32* p) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bytes = _mm_cvtsi32_si128(static_cast<int>(*p));
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+}
+
+inline quint32 storePixel(__m128 acc) {
+    // Round, then saturate to 0..255 on the way down (Lanczos weights can overshoot).
+    const __m128i v = _mm_cvtps_epi32(acc);
+    const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v, v), v);
+    return static_cast<quint32>(_mm_cvtsi128_si32(packed));
+}
+#else
+inline quint32 storeChannels(const float* acc) {
+    quint32 pixel = 0;
+    for (int ch = 0; ch < 4; ++ch) {
+        const int v = qBound(0, int(std::lround(acc[ch])), 255);
+        pixel |= quint32(v) << (8 * ch);
+    }
+    return pixel;
+}
+#endif
+
+void resampleRows(const QImage& src, QImage& dst, const Contributions& c) {
+    for (int y = 0; y < src.height(); ++y) {
+        const quint32* in = reinterpret_cast<const quint32*>(src.constScanLine(y));
+        quint32* out = reinterpret_cast<quint32*>(dst.scanLine(y));
+        for (int x = 0; x < dst.width(); ++x) {
+            const quint32* p = in + c.first[x];
+            const float* w = c.weights.constData() + c.offset[x];
+            const int n = c.count[x];
+#ifdef IMAGESCALER_USE_SSE2
+            __m128 acc = _mm_setzero_ps();
+            for (int k = 0; k < n; ++k) {
+                acc = _mm_add_ps(acc, _mm_mul_ps(loadPixel(p + k), _mm_set1_ps(w[k])));
+            }
+            out[x] = storePixel(acc);
+#else
+            float acc[4] = { 0, 0, 0, 0 };
+            for (int k = 0; k < n; ++k) {
+                for (int ch = 0; ch < 4; ++ch) {
+                    acc[ch] += float((p[k] >> (8 * ch)) & 0xff) * w[k];
+                }
+            }
+            out[x] = storeChannels(acc);
+#endif
+        }
+    }
+}
+
+void resampleColumns(const QImage& src, QImage& dst, const Contributions& c) {
+    const int width = dst.width();
+#ifdef IMAGESCALER_USE_SSE2
+    QVector<__m128> acc(width);
+#else
+    QVector<float> acc(width * 4);
+#endif
+    // Row by row, so every input row is read sequentially.
+    for (int y = 0; y < dst.height(); ++y) {
+#ifdef IMAGESCALER_USE_SSE2
+        acc.fill(_mm_setzero_ps());
+#else
+        acc.fill(0.0f);
+#endif
+        for (int k = 0; k < c.count[y]; ++k) {
+            const quint32* in = reinterpret_cast<const quint32*>(src.constScanLine(c.first[y] + k));
+            const float w = c.weights[c.offset[y] + k];
+#ifdef IMAGESCALER_USE_SSE2
+            const __m128 wv = _mm_set1_ps(w);
+            for (int x = 0; x < width; ++x) {
+                acc[x] = _mm_add_ps(acc[x], _mm_mul_ps(loadPixel(in + x), wv));
+            }
+#else
+            for (int x = 0; x < width; ++x) {
+                for (int ch = 0; ch < 4; ++ch) {
+                    acc[x * 4 + ch] += float((in[x] >> (8 * ch)) & 0xff) * w;
+                }
+            }
+#endif
+        }
+        quint32* out = reinterpret_cast<quint32*>(dst.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+#ifdef IMAGESCALER_USE_SSE2
+            out[x] = storePixel(acc[x]);
+#else
+            out[x] = storeChannels(acc.constData() + x * 4);
+#endif
+        }
+    }
+}
+
+} // namespace
+
+ImageScaler::Filter ImageScaler::filterFromString(const QString& name, Filter fallback) {
+    const QString lower = name.toLower();
+    if (lower == "area" || lower == "box") {
+        return Area;
+    }
+    if (lower == "lanczos" || lower == "lanczos3") {
+        return Lanczos3;
+    }
+    return fallback;
+}
+
+QImage ImageScaler::scale(const QImage& source, const QSize& size, Filter filter) {
+    if (source.isNull() || size.isEmpty()) {
+        return QImage();
+    }
+    // Filtering premultiplied pixels keeps transparent areas from bleeding their colour into neighbours.
+    const QImage src = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    if (src.size() == size) {
+        return src;
+    }
+
+    QImage horizontal = src;
+    if (size.width() != src.width()) {
+        horizontal = QImage(size.width(), src.height(), QImage::Format_ARGB32_Premultiplied);
+        resampleRows(src, horizontal, computeContributions(src.width(), size.width(), filter));
+    }
+    if (size.height() == src.height()) {
+        return horizontal;
+    }
+    QImage result(size, QImage::Format_ARGB32_Premultiplied);
+    resampleColumns(horizontal, result, computeContributions(src.height(), size.height(), filter));
+    return result;
+}
@@ -0,0 +1,26 @@
+#ifndef IMAGESCALER_H
+#define IMAGESCALER_H
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+// Resamples captured frames for scaled renders and thumbnails.
+//
+// The filter is separable: a horizontal pass into an 8-bit intermediate image followed by a vertical pass, each
+// driven by a precomputed table of per-output-pixel weights. Pixels are filtered in premultiplied ARGB, one pixel
+// (all four channels) per SSE2 vector where available.
+class ImageScaler {
+public:
+    enum Filter {
+        Area, // Box filter weighted by pixel coverage; fast and alias-free for downscaling
+        Lanczos3, // Sharper, slightly slower; may ring a little around hard edges
+    };
+
+    // "area" or "lanczos"; anything else yields `fallback`.
+    static Filter filterFromString(const QString& name, Filter fallback = Area);
+
+    static QImage scale(const QImage& source, const QSize& size, Filter filter = Area);
+};
+
+#endif // IMAGESCALER_H
@@ -0,0 +1,293 @@
+#include "ipcframe.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IPCFRAME_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+#ifdef IPCFRAME_USE_SSE2
+inline int firstSetBit(int mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, static_cast<unsigned long>(mask));
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(static_cast<unsigned int>(mask));
+#endif
+}
+#endif
+
+inline bool isWhitespace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+inline int skipWhitespace(const char* p, int i, int n) {
+    while (i < n && isWhitespace(p[i])) {
+        ++i;
+    }
+    return i;
+}
+
+// Position of the next '"' or '\\' at or after i, or n.
+inline int nextQuoteOrBackslash(const char* p, int i, int n) {
+#ifdef IPCFRAME_USE_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for (; i + 16 <= n; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+        if (mask) {
+            return i + firstSetBit(mask);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (p[i] == '"' || p[i] == '\\') {
+            return i;
+        }
+    }
+    return n;
+}
+
+// Position of the next structural character ('"', '\\', '{', '}', '[' or ']') at or after i, or n.
+inline int nextStructural(const char* p, int i, int n) {
+#ifdef IPCFRAME_USE_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    // '[' and ']' differ from '{' and '}' only in bit 0x20, so folding it in needs two compares instead of four.
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    for (; i + 16 <= n; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i folded = _mm_or_si128(chunk, caseBit);
+        const __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close)));
+        const int mask = _mm_movemask_epi8(hits);
+        if (mask) {
+            return i + firstSetBit(mask);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        switch (p[i]) {
+        case '"':
+        case '\\':
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+            return i;
+        default:
+            break;
+        }
+    }
+    return n;
+}
+
+// i points at an opening quote; returns the position just past the closing quote, or -1.
+int skipString(const char* p, int i, int n) {
+    ++i;
+    while (true) {
+        i = nextQuoteOrBackslash(p, i, n);
+        if (i >= n) {
+            return -1;
+        }
+        if (p[i] == '"') {
+            return i + 1;
+        }
+        i += 2; // Escaped character
+    }
+}
+
+// i points at the first character of a value; returns the position just past it, or -1.
+int skipValue(const char* p, int i, int n) {
+    if (i >= n) {
+        return -1;
+    }
+
+    const char c = p[i];
+    if (c == '"') {
+        return skipString(p, i, n);
+    }
+
+    if (c == '{' || c == '[') {
+        int depth = 1;
+        ++i;
+        while (depth > 0) {
+            i = nextStructural(p, i, n);
+            if (i >= n) {
+                return -1;
+            }
+            switch (p[i]) {
+            case '"':
+                i = skipString(p, i, n);
+                if (i < 0) {
+                    return -1;
+                }
+                break;
+            case '{':
+            case '[':
+                ++depth;
+                ++i;
+                break;
+            case '}':
+            case ']':
+                --depth;
+                ++i;
+                break;
+            default:
+                return -1; // Backslash outside a string
+            }
+        }
+        return i;
+    }
+
+    // Number, true, false or null
+    while (i < n && p[i] != ',' && p[i] != '}' && p[i] != ']' && !isWhitespace(p[i])) {
+        ++i;
+    }
+    return i;
+}
+
+inline bool rawEquals(const char* p, int offset, int length, const char* literal) {
+    return static_cast<int>(std::strlen(literal)) == length && std::memcmp(p + offset, literal, length) == 0;
+}
+
+} // namespace
+
+IpcFrame::IpcFrame()
+    : m_memberCount(0)
+    , m_valid(false)
+    , m_type(Unknown)
+    , m_hasId(false)
+    , m_id(0)
+    , m_event(-1)
+    , m_dataDecoded(false) { }
+
+IpcFrame IpcFrame::scan(const QByteArray& message) {
+    IpcFrame frame;
+    frame.m_message = message;
+
+    const char* p = message.constData();
+    const int n = message.size();
+
+    int i = skipWhitespace(p, 0, n);
+    if (i >= n || p[i] != '{') {
+        return frame;
+    }
+    i = skipWhitespace(p, i + 1, n);
+    if (i < n && p[i] == '}') {
+        frame.m_valid = true;
+        return frame;
+    }
+
+    while (i < n) {
+        if (p[i] != '"') {
+            return frame;
+        }
+        const int keyEnd = skipString(p, i, n);
+        if (keyEnd < 0) {
+            return frame;
+        }
+        const int keyOffset = i + 1;
+        const int keyLength = keyEnd - 1 - keyOffset;
+
+        i = skipWhitespace(p, keyEnd, n);
+        if (i >= n || p[i] != ':') {
+            return frame;
+        }
+        const int valueOffset = skipWhitespace(p, i + 1, n);
+        const int valueEnd = skipValue(p, valueOffset, n);
+        if (valueEnd < 0) {
+            return frame;
+        }
+        const int valueLength = valueEnd - valueOffset;
+
+        if (rawEquals(p, keyOffset, keyLength, "type")) {
+            if (rawEquals(p, valueOffset, valueLength, "\"event\"")) {
+                frame.m_type = Event;
+            } else if (rawEquals(p, valueOffset, valueLength, "\"response\"")) {
+                frame.m_type = Response;
+            } else if (rawEquals(p, valueOffset, valueLength, "\"reply\"")) {
+                frame.m_type = Reply;
+            }
+        } else if (rawEquals(p, keyOffset, keyLength, "id")) {
+            frame.m_id = QByteArray::fromRawData(p + valueOffset, valueLength).toULongLong(&frame.m_hasId);
+        } else if (rawEquals(p, keyOffset, keyLength, "event")) {
+            bool ok;
+            const int event = QByteArray::fromRawData(p + valueOffset, valueLength).toInt(&ok);
+            frame.m_event = ok ? event : -1;
+        }
+
+        if (frame.m_memberCount < MaxMembers) {
+            frame.m_members[frame.m_memberCount++] = { keyOffset, keyLength, valueOffset, valueLength };
+        }
+
+        i = skipWhitespace(p, valueEnd, n);
+        if (i < n && p[i] == ',') {
+            i = skipWhitespace(p, i + 1, n);
+        } else if (i < n && p[i] == '}') {
+            frame.m_valid = true;
+            return frame;
+        } else {
+            return frame;
+        }
+    }
+    return frame;
+}
+
+const IpcFrame::Member* IpcFrame::findMember(const char* key) const {
+    const char* p = m_message.constData();
+    for (int i = 0; i < m_memberCount; ++i) {
+        if (rawEquals(p, m_members[i].keyOffset, m_members[i].keyLength, key)) {
+            return &m_members[i];
+        }
+    }
+    return nullptr;
+}
+
+bool IpcFrame::hasMember(const char* key) const { return findMember(key) != nullptr; }
+
+QByteArray IpcFrame::rawValue(const char* key) const {
+    const Member* member = findMember(key);
+    if (!member) {
+        return QByteArray();
+    }
+    return m_message.mid(member->valueOffset, member->valueLength);
+}
+
+QJsonObject IpcFrame::data() const {
+    if (!m_dataDecoded) {
+        m_dataDecoded = true;
+        m_data = value("data").toObject();
+    }
+    return m_data;
+}
+
+QJsonValue IpcFrame::value(const char* key) const {
+    const Member* member = findMember(key);
+    if (!member) {
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    const char* raw = m_message.constData() + member->valueOffset;
+    if (raw[0] == '{' || raw[0] == '[') {
+        const QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromRawData(raw, member->valueLength));
+        return doc.isObject() ? QJsonValue(doc.object()) : QJsonValue(doc.array());
+    }
+
+    // QJsonDocument only parses objects and arrays, so scalars are wrapped in one.
+    QByteArray wrapped;
+    wrapped.reserve(member->valueLength + 2);
+    wrapped.append('[').append(raw, member->valueLength).append(']');
+    return QJsonDocument::fromJson(wrapped).array().at(0);
+}
@@ -0,0 +1,67 @@
+#ifndef IPCFRAME_H
+#define IPCFRAME_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QJsonValue>
+
+// A single JSON message received from the Node.js backend, decoded lazily.
+//
+// scan() only walks the top level of the object: it reads the small envelope members ("type", "id", "event")
+// and records where every other member's value starts and ends, skipping nested objects and strings without building
+// anything. The payload is parsed by data()/value() only when a caller asks for it, so events nobody listens to cost
+// a single pass over the bytes.
+class IpcFrame {
+public:
+    enum Type {
+        Unknown,
+        Response,
+        Event,
+        Reply,
+    };
+
+    IpcFrame();
+
+    // The frame keeps a reference to `message`; QByteArray's implicit sharing keeps that cheap.
+    static IpcFrame scan(const QByteArray& message);
+
+    bool isValid() const { return m_valid; }
+    Type type() const { return m_type; }
+    bool hasId() const { return m_hasId; }
+    quint64 id() const { return m_id; }
+    int event() const { return m_event; }
+    bool hasMember(const char* key) const;
+
+    // Decodes the "data" member (events) on first use; later calls return the cached object.
+    QJsonObject data() const;
+    // Decodes any other top-level member, e.g. "result" or "error" of a response.
+    QJsonValue value(const char* key) const;
+
+    // Byte range of a top-level member's value inside the frame, for callers that want to forward it undecoded.
+    QByteArray rawValue(const char* key) const;
+
+private:
+    struct Member {
+        int keyOffset;
+        int keyLength;
+        int valueOffset;
+        int valueLength;
+    };
+    static const int MaxMembers = 8;
+
+    const Member* findMember(const char* key) const;
+
+    QByteArray m_message;
+    Member m_members[MaxMembers];
+    int m_memberCount;
+    bool m_valid;
+    Type m_type;
+    bool m_hasId;
+    quint64 m_id;
+    int m_event;
+
+    mutable bool m_dataDecoded;
+    mutable QJsonObject m_data;
+};
+
+#endif // IPCFRAME_H
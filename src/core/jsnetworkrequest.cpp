@@ -0,0 +1,25 @@
+#include "jsnetworkrequest.h"
+
+JsNetworkRequest::JsNetworkRequest(qint64 id, QObject* parent)
+    : QObject(parent)
+    , m_id(id)
+    , m_aborted(false) { }
+
+void JsNetworkRequest::abort() { m_aborted = true; }
+
+void JsNetworkRequest::changeUrl(const QString& url) { m_url = url; }
+
+void JsNetworkRequest::setHeader(const QString& name, const QVariant& value) {
+    m_headers.insert(name, value.isNull() ? QVariant() : QVariant(value.toString()));
+}
+
+QVariantMap JsNetworkRequest::decision() const {
+    QVariantMap decision { { "id", m_id }, { "action", m_aborted ? "abort" : "continue" } };
+    if (!m_aborted && !m_url.isEmpty()) {
+        decision.insert("url", m_url);
+    }
+    if (!m_aborted && !m_headers.isEmpty()) {
+        decision.insert("headers", m_headers);
+    }
+    return decision;
+}
@@ -0,0 +1,33 @@
+#ifndef JSNETWORKREQUEST_H
+#define JSNETWORKREQUEST_H
+
+#include <QObject>
+#include <QString>
+#include <QVariantMap>
+
+// The `request` argument of onResourceRequested for an intercepted request. The calls only record what should
+// happen to the request; the engine backend collects the decisions of one event-loop turn and sends them to the
+// browser together. Like in PhantomJS, calls made after the callback has returned have no effect; the object is
+// deleted once the event that created it has been handled.
+class JsNetworkRequest : public QObject {
+    Q_OBJECT
+
+public:
+    explicit JsNetworkRequest(qint64 id, QObject* parent = nullptr);
+
+    Q_INVOKABLE void abort();
+    Q_INVOKABLE void changeUrl(const QString& url);
+    // A null value removes the header.
+    Q_INVOKABLE void setHeader(const QString& name, const QVariant& value);
+
+    // { id, action: "continue" | "abort", url, headers } as the backend's resolveRequests command expects it.
+    QVariantMap decision() const;
+
+private:
+    qint64 m_id;
+    bool m_aborted;
+    QString m_url;
+    QVariantMap m_headers;
+};
+
+#endif // JSNETWORKREQUEST_H
@@ -9,11 +9,26 @@
 #define PAGE_SETTINGS_ZOOM_FACTOR "zoomFactor"
 #define PAGE_SETTINGS_CUSTOM_HEADERS "customHeaders"
 #define PAGE_SETTINGS_NAVIGATION_LOCKED "navigationLocked"
+// When open() reports loadFinished: "domcontentloaded", "load" (default), "networkidle", or
+// { event, connections, idleTime, selector, predicate, timeout }
+#define PAGE_SETTINGS_WAIT_UNTIL "waitUntil"
 #define PAGE_SETTINGS_PAPER_SIZE "paperSize"
 
 // Render-related
 #define PAGE_SETTINGS_ONLY_VIEWPORT "onlyViewport" // For render() options
 #define PAGE_SETTINGS_FORMAT "format" // For render() options
+#define PAGE_SETTINGS_QUALITY "quality" // JPEG/WebP quality, 0-100
+#define PAGE_SETTINGS_COMPRESSION_LEVEL "compressionLevel" // PNG zlib level, 0-9
+#define PAGE_SETTINGS_SCALE "scale" // Resize factor for the capture, e.g. 0.5
+#define PAGE_SETTINGS_THUMBNAIL "thumbnail" // Width, { width, height, file } or a list of them
+#define PAGE_SETTINGS_FILTER "filter" // Resampling filter: "area" (default) or "lanczos"
+#define PAGE_SETTINGS_INCREMENTAL "incremental" // Re-capture only repainted viewport tiles since the last render
+#define PAGE_SETTINGS_TILE_SIZE "tileSize" // Tile edge in pixels for incremental capture (default 256)
+#define PAGE_SETTINGS_TILED "tiled" // Full-page PNG captured in bands and streamed to the file
+#define PAGE_SETTINGS_BAND_HEIGHT "bandHeight" // Band height in pixels for tiled capture (default 2048)
+#define PAGE_SETTINGS_SETTLE_TIME "settleTime" // renderViewports(): extra ms to wait after each resize
+#define PAGE_SETTINGS_FAST "fast" // Viewport capture encoded by the browser from the compositor surface
+#define PAGE_SETTINGS_OUTPUTS "outputs" // Extra renditions of the same capture: [{ file, format, quality, size }]
 
 // Network/Cache related
 #define PAGE_SETTINGS_DISK_CACHE_ENABLED "diskCacheEnabled"
@@ -28,6 +43,7 @@
 #define PAGE_SETTINGS_SSL_CLIENT_KEY_PASSPHRASE "sslClientKeyPassphrase"
 #define PAGE_SETTINGS_RESOURCE_TIMEOUT "resourceTimeout"
 #define PAGE_SETTINGS_MAX_AUTH_ATTEMPTS "maxAuthAttempts"
+#define PAGE_SETTINGS_INTERCEPT_DEADLINE "interceptDeadline" // ms onResourceRequested has to decide (default 500)
 
 // JavaScript/Security related
 #define PAGE_SETTINGS_JAVASCRIPT_ENABLED "javascriptEnabled"
@@ -0,0 +1,311 @@
+#include "pdfmerger.h"
+
+#include <QByteArray>
+#include <QMap>
+#include <QRegularExpression>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Object numbers of the merged document's own catalog and page tree root.
+const int CatalogObject = 1;
+const int PagesObject = 2;
+
+inline bool isWhitespace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\0'; }
+inline bool isDelimiter(char c) { return c != '\0' && std::strchr("()<>[]{}/%", c) != nullptr; }
+inline bool isRegular(char c) { return !isWhitespace(c) && !isDelimiter(c); }
+
+const char* skipWhitespace(const char* pos, const char* end) {
+    while (pos < end && isWhitespace(*pos)) {
+        ++pos;
+    }
+    return pos;
+}
+
+const char* tokenEnd(const char* pos, const char* end) {
+    while (pos < end && isRegular(*pos)) {
+        ++pos;
+    }
+    return pos;
+}
+
+bool isInteger(const char* begin, const char* end) {
+    if (begin == end) {
+        return false;
+    }
+    for (const char* p = begin; p < end; ++p) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads an unsigned integer token at `pos` (after whitespace), advancing `pos` past it.
+bool readInteger(const char*& pos, const char* end, qint64* value) {
+    pos = skipWhitespace(pos, end);
+    const char* last = tokenEnd(pos, end);
+    if (!isInteger(pos, last)) {
+        return false;
+    }
+    *value = QByteArray(pos, int(last - pos)).toLongLong();
+    pos = last;
+    return true;
+}
+
+// Copies PDF object syntax from `pos` to `out`, adding `delta` to the object number of every indirect reference
+// ("12 0 R"). Strings, names and comments are copied verbatim. Stops at the top-level `stream` keyword, whose
+// data must not be touched, and returns where it stopped.
+const char* rewriteReferences(const char* pos, const char* end, int delta, QByteArray* out) {
+    while (pos < end) {
+        const char c = *pos;
+        const char* start = pos;
+        if (c == '(') {
+            int depth = 0;
+            for (; pos < end; ++pos) {
+                if (*pos == '\\') {
+                    ++pos;
+                } else if (*pos == '(') {
+                    ++depth;
+                } else if (*pos == ')' && --depth == 0) {
+                    ++pos;
+                    break;
+                }
+            }
+        } else if (c == '%') {
+            while (pos < end && *pos != '\r' && *pos != '\n') {
+                ++pos;
+            }
+        } else if (c == '<' && pos + 1 < end && pos[1] == '<') {
+            pos += 2;
+        } else if (c == '<') {
+            while (pos < end && *pos != '>') {
+                ++pos;
+            }
+            pos = qMin(end, pos + 1);
+        } else if (c == '/') {
+            pos = tokenEnd(pos + 1, end);
+        } else if (isRegular(c)) {
+            const char* last = tokenEnd(pos, end);
+            if (last - pos == 6 && std::memcmp(pos, "stream", 6) == 0) {
+                return pos;
+            }
+            if (isInteger(pos, last)) {
+                const char* next = last;
+                qint64 generation;
+                if (readInteger(next, end, &generation)) {
+                    next = skipWhitespace(next, end);
+                    if (next < end && *next == 'R' && (next + 1 == end || !isRegular(next[1]))) {
+                        const qint64 number = QByteArray(pos, int(last - pos)).toLongLong();
+                        out->append(QByteArray::number(number + delta) + ' ' + QByteArray::number(generation) + " R");
+                        pos = next + 1;
+                        continue;
+                    }
+                }
+            }
+            pos = last;
+        } else {
+            ++pos;
+        }
+        out->append(start, int(pos - start));
+    }
+    return end;
+}
+
+} // namespace
+
+PdfMerger::PdfMerger()
+    : m_pageCount(0) { }
+
+bool PdfMerger::fail(const QString& error) {
+    m_error = error;
+    return false;
+}
+
+bool PdfMerger::write(const QByteArray& data) {
+    if (m_file.write(data) != data.size()) {
+        return fail("could not write " + m_file.fileName() + ": " + m_file.errorString());
+    }
+    return true;
+}
+
+bool PdfMerger::writeObject(int number, int generation, const QByteArray& body) {
+    if (m_offsets.size() <= number) {
+        m_offsets.resize(number + 1);
+        m_generations.resize(number + 1);
+    }
+    m_offsets[number] = m_file.pos();
+    m_generations[number] = generation;
+    return write(QByteArray::number(number) + ' ' + QByteArray::number(generation) + " obj\n" + body);
+}
+
+bool PdfMerger::open(const QString& fileName) {
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly)) {
+        return fail("could not open " + fileName + ": " + m_file.errorString());
+    }
+    m_offsets = QVector<qint64>(PagesObject + 1, -1);
+    m_generations = QVector<int>(PagesObject + 1, 0);
+    m_partRoots.clear();
+    m_pageCount = 0;
+    // The comment with high-bit bytes marks the file as binary for transfer tools.
+    return write("%PDF-1.7\n%\xE2\xE3\xCF\xD3\n");
+}
+
+bool PdfMerger::append(const QString& partFileName) {
+    QFile part(partFileName);
+    if (!part.open(QIODevice::ReadOnly)) {
+        return fail("could not open " + partFileName + ": " + part.errorString());
+    }
+    const qint64 size = part.size();
+    const char* data = size > 0 ? reinterpret_cast<const char*>(part.map(0, size)) : nullptr;
+    if (!data) {
+        return fail("could not map " + partFileName);
+    }
+    const char* end = data + size;
+
+    // startxref near the end points at the cross-reference table.
+    const QByteArray tail = QByteArray::fromRawData(end - qMin<qint64>(size, 1024), int(qMin<qint64>(size, 1024)));
+    const int startxref = tail.lastIndexOf("startxref");
+    qint64 xrefOffset = -1;
+    const char* pos = tail.constData() + startxref + 9;
+    if (startxref < 0 || !readInteger(pos, end, &xrefOffset) || xrefOffset <= 0 || xrefOffset >= size) {
+        return fail(partFileName + ": no cross-reference table found");
+    }
+    pos = skipWhitespace(data + xrefOffset, end);
+    if (end - pos < 4 || std::memcmp(pos, "xref", 4) != 0) {
+        return fail(partFileName + ": cross-reference streams are not supported");
+    }
+    pos += 4;
+
+    QMap<qint64, QPair<int, int>> objects; // Offset -> (number, generation), in file order
+    int maxNumber = 0;
+    for (;;) {
+        pos = skipWhitespace(pos, end);
+        if (end - pos >= 7 && std::memcmp(pos, "trailer", 7) == 0) {
+            break;
+        }
+        qint64 first, count;
+        if (!readInteger(pos, end, &first) || !readInteger(pos, end, &count)) {
+            return fail(partFileName + ": malformed cross-reference table");
+        }
+        for (qint64 i = 0; i < count; ++i) {
+            qint64 offset, generation;
+            if (!readInteger(pos, end, &offset) || !readInteger(pos, end, &generation)) {
+                return fail(partFileName + ": malformed cross-reference entry");
+            }
+            pos = skipWhitespace(pos, end);
+            if (pos < end && *pos == 'n' && offset > 0) {
+                objects.insert(offset, qMakePair(int(first + i), int(generation)));
+                maxNumber = qMax(maxNumber, int(first + i));
+            }
+            ++pos;
+        }
+    }
+    const QByteArray trailer = QByteArray::fromRawData(pos, int(end - pos));
+    if (trailer.contains("/Prev")) {
+        return fail(partFileName + ": incrementally updated PDFs are not supported");
+    }
+    const QRegularExpressionMatch root = QRegularExpression("/Root\\s+(\\d+)\\s+\\d+\\s+R").match(trailer);
+    if (!root.hasMatch()) {
+        return fail(partFileName + ": no document catalog");
+    }
+    const int catalogNumber = root.captured(1).toInt();
+
+    // Object n of the part becomes n + delta here.
+    const int delta = m_offsets.size() - 1;
+    const QList<qint64> offsets = objects.keys();
+    int pagesNumber = -1;
+    for (int i = 0; i < offsets.size(); ++i) {
+        if (objects.value(offsets.at(i)).first == catalogNumber) {
+            const char* objectEnd = i + 1 < offsets.size() ? data + offsets.at(i + 1) : data + xrefOffset;
+            const char* start = data + offsets.at(i);
+            const QByteArray catalog = QByteArray::fromRawData(start, int(objectEnd - start));
+            const QRegularExpressionMatch pages = QRegularExpression("/Pages\\s+(\\d+)\\s+\\d+\\s+R").match(catalog);
+            pagesNumber = pages.hasMatch() ? pages.captured(1).toInt() : -1;
+        }
+    }
+    if (pagesNumber < 0) {
+        return fail(partFileName + ": no page tree");
+    }
+
+    for (int i = 0; i < offsets.size(); ++i) {
+        const int number = objects.value(offsets.at(i)).first;
+        const int generation = objects.value(offsets.at(i)).second;
+        if (number == catalogNumber) {
+            continue; // Replaced by the merged document's catalog
+        }
+        const char* objectEnd = i + 1 < offsets.size() && offsets.at(i + 1) < xrefOffset ? data + offsets.at(i + 1)
+                                                                                         : data + xrefOffset;
+        // Skip the "n g obj" header; the object gets its new number from writeObject().
+        const char* body = data + offsets.at(i);
+        qint64 ignored;
+        if (!readInteger(body, objectEnd, &ignored) || !readInteger(body, objectEnd, &ignored)) {
+            return fail(partFileName + ": malformed object at offset " + QString::number(offsets.at(i)));
+        }
+        body = skipWhitespace(body, objectEnd);
+        if (objectEnd - body < 3 || std::memcmp(body, "obj", 3) != 0) {
+            return fail(partFileName + ": malformed object at offset " + QString::number(offsets.at(i)));
+        }
+        body += 3;
+
+        QByteArray rewritten;
+        const char* streamStart = rewriteReferences(body, objectEnd, delta, &rewritten);
+        if (number == pagesNumber) {
+            // The part's page tree root becomes an intermediate node of the merged tree.
+            const int dictionary = rewritten.indexOf("<<");
+            if (dictionary < 0) {
+                return fail(partFileName + ": malformed page tree root");
+            }
+            rewritten.insert(dictionary + 2, " /Parent " + QByteArray::number(PagesObject) + " 0 R");
+            const QRegularExpressionMatch count = QRegularExpression("/Count\\s+(\\d+)").match(rewritten);
+            m_pageCount += count.hasMatch() ? count.captured(1).toInt() : 0;
+        }
+        // Stream data goes straight from the mapped part to the output.
+        const QByteArray stream = QByteArray::fromRawData(streamStart, int(objectEnd - streamStart));
+        const bool endsWithNewline = stream.isEmpty() ? rewritten.endsWith('\n') : stream.endsWith('\n');
+        if (!writeObject(number + delta, generation, rewritten) || !write(stream)
+            || (!endsWithNewline && !write("\n"))) {
+            return false;
+        }
+    }
+    if (m_offsets.size() < delta + maxNumber + 1) {
+        m_offsets.resize(delta + maxNumber + 1);
+        m_generations.resize(delta + maxNumber + 1);
+    }
+    m_partRoots.append(pagesNumber + delta);
+    return true;
+}
+
+bool PdfMerger::close() {
+    QByteArray kids;
+    for (int root : m_partRoots) {
+        kids += QByteArray::number(root) + " 0 R ";
+    }
+    if (!writeObject(CatalogObject, 0,
+            "<< /Type /Catalog /Pages " + QByteArray::number(PagesObject) + " 0 R >>\nendobj\n")
+        || !writeObject(PagesObject, 0,
+            "<< /Type /Pages /Kids [ " + kids + "] /Count " + QByteArray::number(m_pageCount) + " >>\nendobj\n")) {
+        return false;
+    }
+
+    const qint64 xrefOffset = m_file.pos();
+    QByteArray xref = "xref\n0 " + QByteArray::number(m_offsets.size()) + "\n";
+    for (int i = 0; i < m_offsets.size(); ++i) {
+        // Fixed 20-byte entries; free (or skipped) numbers are listed as free.
+        if (i == 0 || m_offsets.at(i) <= 0) {
+            xref += "0000000000 65535 f \n";
+        } else {
+            xref += QByteArray::number(m_offsets.at(i)).rightJustified(10, '0') + ' '
+                + QByteArray::number(m_generations.at(i)).rightJustified(5, '0') + " n \n";
+        }
+    }
+    xref += "trailer\n<< /Size " + QByteArray::number(m_offsets.size()) + " /Root "
+        + QByteArray::number(CatalogObject) + " 0 R >>\nstartxref\n" + QByteArray::number(xrefOffset) + "\n%%EOF\n";
+    if (!write(xref)) {
+        return false;
+    }
+    m_file.close();
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef PDFMERGER_H
+#define PDFMERGER_H
+
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+// Concatenates PDF documents page-wise by copying their objects into one file.
+//
+// Objects are copied one at a time from a memory-mapped part to the output: only their dictionaries are parsed
+// (to renumber indirect references), stream data is passed through untouched. Each part's page tree becomes a
+// child of a new root page tree, so page objects themselves are not modified.
+//
+// Parts must use a classic cross-reference table without incremental updates, which is what Chromium (Skia)
+// writes. Document-level catalog entries of the parts (outlines, named destinations) are not carried over.
+class PdfMerger {
+public:
+    PdfMerger();
+
+    bool open(const QString& fileName);
+    bool append(const QString& partFileName);
+    bool close();
+
+    int pageCount() const { return m_pageCount; }
+    qint64 bytesWritten() const { return m_file.pos(); }
+    QString errorString() const { return m_error; }
+
+private:
+    struct XrefEntry {
+        qint64 offset;
+        int generation;
+    };
+
+    bool fail(const QString& error);
+    bool write(const QByteArray& data);
+    bool writeObject(int number, int generation, const QByteArray& body);
+
+    QFile m_file;
+    QVector<qint64> m_offsets; // Output offset per object number; -1 for free entries
+    QVector<int> m_generations;
+    QList<int> m_partRoots; // Output object numbers of the parts' page tree roots
+    int m_pageCount;
+    QString m_error;
+};
+
+#endif // PDFMERGER_H
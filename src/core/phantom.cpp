@@ -10,6 +10,8 @@
 #include "webserver.h"
 #include "qcommandline/qcommandline.h"
 #include "ienginebackend.h"
+#include "shutdowncoordinator.h"
+#include "imagediff.h"
 
 #include <QCoreApplication>
 #include <QDebug>
@@ -79,6 +81,8 @@ bool Phantom::init(int argc, char** argv) {
             m_config->setMaxDiskCacheSize(value.toInt());
         } else if (name == "disk-cache-path") {
             m_config->setDiskCachePath(value.toString());
+        } else if (name == "memory-cache-size") {
+            m_config->setMemoryCacheSize(value.toInt());
         } else if (name == "ignore-ssl-errors") {
             m_config->setIgnoreSslErrors(value.toBool());
         } else if (name == "local-storage-path") {
@@ -113,6 +117,16 @@ bool Phantom::init(int argc, char** argv) {
             m_config->setResourceTimeout(value.toInt());
         } else if (name == "max-auth-attempts") {
             m_config->setMaxAuthAttempts(value.toInt());
+        } else if (name == "backend-heartbeat-interval") {
+            m_config->setBackendHeartbeatInterval(value.toInt());
+        } else if (name == "backend-heartbeat-misses") {
+            m_config->setBackendHeartbeatMisses(value.toInt());
+        } else if (name == "backend-max-restarts") {
+            m_config->setBackendMaxRestarts(value.toInt());
+        } else if (name == "shutdown-timeout") {
+            m_config->setShutdownTimeout(value.toInt());
+        } else if (name == "fast-exit") {
+            m_config->setFastExit(value.toBool());
         } else if (name == "javascript-enabled") {
             m_config->setJavascriptEnabled(value.toBool());
         } else if (name == "web-security") {
@@ -369,6 +383,8 @@ QObject* Phantom::createWebPage() {
 void Phantom::exit(int code) {
     qDebug() << "Phantom::exit(" << code << ") called. Shutting down application.";
     emit aboutToExit(); // Emit the signal
+    // Stop all backends together under one deadline; the page destructors then find nothing left to wait for.
+    ShutdownCoordinator::instance()->shutdownAll(m_config->shutdownTimeout(), !m_config->fastExit());
     QCoreApplication::exit(code);
 }
 
@@ -451,6 +467,38 @@ QVariant Phantom::evaluate(const QString& func, const QVariantList& args) {
     return QVariant();
 }
 
+QVariantMap Phantom::imageDiff(const QString& a, const QString& b, const QVariantMap& options) {
+    QString error;
+    const QImage imageA = ImageDiff::load(a, &error);
+    const QImage imageB = error.isEmpty() ? ImageDiff::load(b, &error) : QImage();
+    if (!error.isEmpty()) {
+        Terminal::instance()->cerr("phantom.imageDiff: " + error);
+        return QVariantMap { { "identical", false }, { "error", error } };
+    }
+
+    const ImageDiff::Result result = ImageDiff::compare(imageA, imageB, ImageDiff::Options::fromMap(options));
+    QVariantMap map = result.toMap();
+    const quint64 hashA = ImageDiff::perceptualHash(imageA);
+    const quint64 hashB = ImageDiff::perceptualHash(imageB);
+    map["hashA"] = QString("%1").arg(hashA, 16, 16, QChar('0'));
+    map["hashB"] = QString("%1").arg(hashB, 16, 16, QChar('0'));
+    map["hashDistance"] = ImageDiff::hashDistance(hashA, hashB);
+    if (!result.error.isEmpty()) {
+        Terminal::instance()->cerr("phantom.imageDiff: " + result.error);
+    }
+    return map;
+}
+
+QString Phantom::imageHash(const QString& image) {
+    QString error;
+    const QImage loaded = ImageDiff::load(image, &error);
+    if (!error.isEmpty()) {
+        Terminal::instance()->cerr("phantom.imageHash: " + error);
+        return QString();
+    }
+    return QString("%1").arg(ImageDiff::perceptualHash(loaded), 16, 16, QChar('0'));
+}
+
 void Phantom::onPageCreated(WebPage* newPage) {
     qDebug() << "Phantom: A new WebPage was created by the backend.";
     if (newPage) {
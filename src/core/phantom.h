@@ -66,6 +66,8 @@ public:
     Q_INVOKABLE void addEventListener(const QString& name, QObject* callback);
     Q_INVOKABLE void removeEventListener(const QString& name, QObject* callback);
     Q_INVOKABLE QVariant evaluate(const QString& func, const QVariantList& args);
+    Q_INVOKABLE QVariantMap imageDiff(const QString& a, const QString& b, const QVariantMap& options = QVariantMap());
+    Q_INVOKABLE QString imageHash(const QString& image);
 
     // --- Getters for Q_PROPERTY ---
     QString version() const;
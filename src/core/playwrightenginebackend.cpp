@@ -1,22 +1,52 @@
 #include "playwrightenginebackend.h"
+#include "jsnetworkrequest.h"
+#include "responsecache.h"
+#include "config.h"
+#include "consts.h"
 #include "cookiejar.h" // Include if CookieJar methods are directly used or passed around
+#include "shutdowncoordinator.h"
 #include <QCoreApplication>
 #include <QDebug>
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QJsonParseError>
 #include <QJsonArray>
-#include <QEventLoop> // For waitForStarted/waitForFinished/waitForBytesWritten
+#include <QElapsedTimer>
+#include <QMetaMethod>
 #include <QTimer>
 #include <QNetworkProxy>
+#include <QStandardPaths>
 #include <QUrlQuery> // For parsing URL components if needed
+#include <algorithm>
+
+namespace {
+// How long a sync command may wait for the Node.js backend to answer.
+const int SyncCommandTimeoutMs = 5000;
+// Back-off between consecutive restarts of a crashing backend; the first restart is immediate.
+const int RestartBackoffMs = 500;
+// Size of the pdfChunk events a streamed PDF arrives in.
+const int PdfChunkSize = 1024 * 1024;
+}
 
 // Constructor
 PlaywrightEngineBackend::PlaywrightEngineBackend(QObject* parent)
     : IEngineBackend(parent)
     , m_playwrightProcess(nullptr)
-    , m_nextRequestId(1) {
+    , m_cookieJar(nullptr)
+    , m_nextRequestId(1)
+    , m_heartbeatTimer(new QTimer(this))
+    , m_heartbeatInterval(Config::instance()->backendHeartbeatInterval())
+    , m_heartbeatMisses(qMax(1, Config::instance()->backendHeartbeatMisses()))
+    , m_missedHeartbeats(0)
+    , m_heartbeatSeq(0)
+    , m_healthy(true)
+    , m_maxRestarts(qMax(0, Config::instance()->backendMaxRestarts()))
+    , m_restartCount(0)
+    , m_restarting(false)
+    , m_replaySequence(0)
+    , m_nextPdfStreamId(1)
+    , m_requestInterception(false)
+    , m_streamActivity(0) {
     // Initialize default cached values
     m_currentUrl = QUrl("about:blank");
     m_currentTitle = "";
@@ -65,12 +95,22 @@ PlaywrightEngineBackend::PlaywrightEngineBackend(QObject* parent)
         &PlaywrightEngineBackend::handleReadyReadStandardError);
     connect(m_playwrightProcess, &QProcess::errorOccurred, this, &PlaywrightEngineBackend::handleProcessErrorOccurred);
 
+    m_heartbeatTimer->setInterval(m_heartbeatInterval);
+    connect(m_heartbeatTimer, &QTimer::timeout, this, &PlaywrightEngineBackend::heartbeat);
+
+    ShutdownCoordinator::instance()->registerBackend(this);
+    startBackendProcess();
+}
+
+void PlaywrightEngineBackend::startBackendProcess() {
     qDebug() << "PlaywrightEngineBackend: Starting Node.js process:" << m_playwrightScriptPath;
     m_playwrightProcess->start("node", QStringList() << m_playwrightScriptPath);
 
     if (!m_playwrightProcess->waitForStarted(5000)) { // Wait up to 5 seconds for the process to start
         qCritical() << "PlaywrightEngineBackend: Failed to start Node.js backend process.";
-        emitInitialized(); // Emit initialized even on failure for now to unblock.
+        if (!m_restarting) {
+            emitInitialized(); // Emit initialized even on failure for now to unblock.
+        }
     } else {
         qDebug() << "PlaywrightEngineBackend: Node.js process started.";
     }
@@ -78,19 +118,20 @@ PlaywrightEngineBackend::PlaywrightEngineBackend(QObject* parent)
 
 // Destructor
 PlaywrightEngineBackend::~PlaywrightEngineBackend() {
-    if (m_playwrightProcess && m_playwrightProcess->state() == QProcess::Running) {
-        qDebug() << "PlaywrightEngineBackend: Terminating Playwright Node.js process.";
-        m_playwrightProcess->terminate();
-        if (!m_playwrightProcess->waitForFinished(3000)) {
-            m_playwrightProcess->kill();
-        }
+    ShutdownCoordinator::instance()->unregisterBackend(this);
+    m_heartbeatTimer->stop();
+    // Normally Phantom::exit() has already stopped every backend; this covers pages closed individually.
+    if (m_playwrightProcess && m_playwrightProcess->state() != QProcess::NotRunning) {
+        qDebug() << "PlaywrightEngineBackend: Shutting down Playwright Node.js process.";
+        const Config* config = Config::instance();
+        ShutdownCoordinator::shutdown(QList<IEngineBackend*>() << this, config->shutdownTimeout(), !config->fastExit());
     }
 }
 
 // --- IEngineBackend overrides (Implementations) ---
 
 QUrl PlaywrightEngineBackend::url() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getUrl");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetUrlCommand());
     if (result.isValid() && result.type() == QVariant::String) {
         m_currentUrl = QUrl(result.toString());
     }
@@ -98,7 +139,7 @@ QUrl PlaywrightEngineBackend::url() const {
 }
 
 QString PlaywrightEngineBackend::title() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getTitle");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetTitleCommand());
     if (result.isValid() && result.type() == QVariant::String) {
         m_currentTitle = result.toString();
     }
@@ -106,7 +147,7 @@ QString PlaywrightEngineBackend::title() const {
 }
 
 QString PlaywrightEngineBackend::toHtml() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getHtml");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetHtmlCommand());
     if (result.isValid() && result.type() == QVariant::String) {
         m_currentHtml = result.toString();
     }
@@ -114,7 +155,7 @@ QString PlaywrightEngineBackend::toHtml() const {
 }
 
 QString PlaywrightEngineBackend::toPlainText() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getPlainText");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetPlainTextCommand());
     if (result.isValid() && result.type() == QVariant::String) {
         m_currentPlainText = result.toString();
     }
@@ -122,18 +163,18 @@ QString PlaywrightEngineBackend::toPlainText() const {
 }
 
 QString PlaywrightEngineBackend::windowName() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getWindowName");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetWindowNameCommand());
     if (result.isValid() && result.type() == QVariant::String) {
         m_currentWindowName = result.toString();
     }
     return m_currentWindowName;
 }
 
-void PlaywrightEngineBackend::load(
-    const QNetworkRequest& request, QNetworkAccessManager::Operation operation, const QByteArray& body) {
+void PlaywrightEngineBackend::load(const QNetworkRequest& request, QNetworkAccessManager::Operation operation,
+    const QByteArray& body, const QVariantMap& waitUntil) {
     qDebug() << "PlaywrightEngineBackend: Loading URL:" << request.url().toString();
-    QVariantMap params;
-    params["url"] = request.url().toString();
+    PlaywrightProtocol::LoadCommand command;
+    command.url = request.url().toString();
     // QNetworkAccessManager::Operation to string mapping (simplified)
     QString operationString;
     switch (operation) {
@@ -154,76 +195,81 @@ void PlaywrightEngineBackend::load(
         operationString = "GET";
         break;
     }
-    params["method"] = operationString;
-    params["body"] = QString::fromUtf8(body.toBase64()); // Send body as base64 string
+    command.method = operationString;
+    command.body = QString::fromUtf8(body.toBase64()); // Send body as base64 string
 
     // Convert raw headers to a QVariantMap
     QVariantMap rawHeadersMap;
     for (const QNetworkRequest::RawHeaderPair& headerPair : request.rawHeaderList()) {
         rawHeadersMap[QString::fromUtf8(headerPair.first)] = QString::fromUtf8(headerPair.second);
     }
-    params["headers"] = rawHeadersMap;
+    command.headers = rawHeadersMap;
+    command.waitUntil = waitUntil;
 
-    sendAsyncCommand("load", params);
+    m_lastLoad = command;
+    m_replayInjections.clear(); // They belonged to the previous document
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setHtml(const QString& html, const QUrl& baseUrl) {
     qDebug() << "PlaywrightEngineBackend: Setting HTML content.";
-    QVariantMap params;
-    params["html"] = html;
-    params["baseUrl"] = baseUrl.toString();
-    sendAsyncCommand("setHtml", params);
+    PlaywrightProtocol::SetHtmlCommand command;
+    command.html = html;
+    command.baseUrl = baseUrl.toString();
+    m_replayInjections.clear();
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::reload() {
     qDebug() << "PlaywrightEngineBackend: Reloading page.";
-    sendAsyncCommand("reload");
+    sendAsyncCommand(PlaywrightProtocol::ReloadCommand());
 }
 
 void PlaywrightEngineBackend::stop() {
     qDebug() << "PlaywrightEngineBackend: Stopping page load.";
-    sendAsyncCommand("stop");
+    sendAsyncCommand(PlaywrightProtocol::StopCommand());
 }
 
 bool PlaywrightEngineBackend::canGoBack() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("canGoBack");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::CanGoBackCommand());
     return result.toBool();
 }
 
 bool PlaywrightEngineBackend::goBack() {
-    QVariant result = sendSyncCommand("goBack");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GoBackCommand());
     return result.toBool();
 }
 
 bool PlaywrightEngineBackend::canGoForward() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("canGoForward");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::CanGoForwardCommand());
     return result.toBool();
 }
 
 bool PlaywrightEngineBackend::goForward() {
-    QVariant result = sendSyncCommand("goForward");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GoForwardCommand());
     return result.toBool();
 }
 
 bool PlaywrightEngineBackend::goToHistoryItem(int relativeIndex) {
     qDebug() << "PlaywrightEngineBackend: goToHistoryItem called. Index:" << relativeIndex;
-    QVariantMap params; // Create a mutable copy
-    params["relativeIndex"] = relativeIndex;
-    QVariant result = sendSyncCommand("goToHistoryItem", params);
+    PlaywrightProtocol::GoToHistoryItemCommand command;
+    command.relativeIndex = relativeIndex;
+    QVariant result = sendSyncCommand(command);
     return result.toBool();
 }
 
 void PlaywrightEngineBackend::setViewportSize(const QSize& size) {
     qDebug() << "PlaywrightEngineBackend: Setting viewport size:" << size;
     m_currentViewportSize = size; // Cache locally
-    QVariantMap params;
-    params["width"] = size.width();
-    params["height"] = size.height();
-    sendAsyncCommand("setViewportSize", params);
+    PlaywrightProtocol::SetViewportSizeCommand command;
+    command.width = size.width();
+    command.height = size.height();
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 QSize PlaywrightEngineBackend::viewportSize() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getViewportSize");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetViewportSizeCommand());
     if (result.isValid() && result.type() == QVariant::Map) {
         QVariantMap sizeMap = result.toMap();
         m_currentViewportSize = QSize(sizeMap.value("width").toInt(), sizeMap.value("height").toInt());
@@ -234,16 +280,14 @@ QSize PlaywrightEngineBackend::viewportSize() const {
 void PlaywrightEngineBackend::setClipRect(const QRect& rect) {
     qDebug() << "PlaywrightEngineBackend: Setting clip rect:" << rect;
     m_currentClipRect = rect; // Cache locally
-    QVariantMap params;
-    params["x"] = rect.x();
-    params["y"] = rect.y();
-    params["width"] = rect.width();
-    params["height"] = rect.height();
-    sendAsyncCommand("setClipRect", params);
+    PlaywrightProtocol::SetClipRectCommand command;
+    command.clipRect = rect;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 QRect PlaywrightEngineBackend::clipRect() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getClipRect");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetClipRectCommand());
     if (result.isValid() && result.type() == QVariant::Map) {
         QVariantMap rectMap = result.toMap();
         m_currentClipRect = QRect(rectMap.value("x").toInt(), rectMap.value("y").toInt(),
@@ -255,14 +299,14 @@ QRect PlaywrightEngineBackend::clipRect() const {
 void PlaywrightEngineBackend::setScrollPosition(const QPoint& pos) {
     qDebug() << "PlaywrightEngineBackend: Setting scroll position:" << pos;
     m_currentScrollPosition = pos; // Cache locally
-    QVariantMap params;
-    params["x"] = pos.x();
-    params["y"] = pos.y();
-    sendAsyncCommand("setScrollPosition", params);
+    PlaywrightProtocol::SetScrollPositionCommand command;
+    command.x = pos.x();
+    command.y = pos.y();
+    sendAsyncCommand(command);
 }
 
 QPoint PlaywrightEngineBackend::scrollPosition() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getScrollPosition");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetScrollPositionCommand());
     if (result.isValid() && result.type() == QVariant::Map) {
         QVariantMap posMap = result.toMap();
         m_currentScrollPosition = QPoint(posMap.value("x").toInt(), posMap.value("y").toInt());
@@ -272,12 +316,10 @@ QPoint PlaywrightEngineBackend::scrollPosition() const {
 
 QByteArray PlaywrightEngineBackend::renderPdf(const QVariantMap& paperSize, const QRect& clipRect) {
     qDebug() << "PlaywrightEngineBackend: Rendering PDF.";
-    QVariantMap params;
-    params["format"] = "pdf";
-    params["paperSize"] = paperSize;
-    params["clipRect"] = QVariantMap { { "x", clipRect.x() }, { "y", clipRect.y() }, { "width", clipRect.width() },
-        { "height", clipRect.height() } };
-    QVariant result = sendSyncCommand("render", params);
+    PlaywrightProtocol::RenderPdfCommand command;
+    command.paperSize = paperSize;
+    command.clipRect = clipRect;
+    QVariant result = sendSyncCommand(command);
     if (result.isValid() && result.type() == QVariant::String) {
         return QByteArray::fromBase64(result.toByteArray()); // Expecting base64 encoded PDF
     }
@@ -285,17 +327,64 @@ QByteArray PlaywrightEngineBackend::renderPdf(const QVariantMap& paperSize, cons
     return QByteArray();
 }
 
+bool PlaywrightEngineBackend::renderPdfToDevice(const QVariantMap& paperSize, QIODevice* device) {
+    qDebug() << "PlaywrightEngineBackend: Streaming PDF.";
+    PlaywrightProtocol::RenderPdfStreamCommand command;
+    command.paperSize = paperSize;
+    command.streamId = m_nextPdfStreamId++;
+    command.chunkSize = PdfChunkSize;
+    m_pdfStreams.insert(command.streamId, PdfStream { device, 0, false });
+
+    // The chunks arrive as pdfChunk events while this waits for the reply, after pdfPrinting events while Chromium
+    // is still laying the document out.
+    const QVariantMap result = sendSyncCommand(command).toMap();
+    const PdfStream stream = m_pdfStreams.take(command.streamId);
+    if (stream.failed || !result.contains("bytes") || result.value("bytes").toLongLong() != stream.bytesWritten) {
+        qWarning() << "PlaywrightEngineBackend: PDF streaming failed after" << stream.bytesWritten << "bytes.";
+        return false;
+    }
+    return true;
+}
+
+QStringList PlaywrightEngineBackend::renderPdfParts(
+    const QVariantMap& paperSize, int workers, int pagesPerPart, const QString& directory) {
+    qDebug() << "PlaywrightEngineBackend: Rendering PDF on" << workers << "workers.";
+    PlaywrightProtocol::RenderPdfPartsCommand command;
+    command.paperSize = paperSize;
+    command.workers = workers;
+    command.pagesPerPart = pagesPerPart;
+    command.directory = directory;
+    return sendSyncCommand(command).toStringList();
+}
+
+bool PlaywrightEngineBackend::applyTemplateData(const QVariantMap& data, int timeout) {
+    PlaywrightProtocol::ApplyTemplateDataCommand command;
+    command.data = data;
+    command.timeout = timeout;
+    return sendSyncCommand(command).toBool();
+}
+
+QStringList PlaywrightEngineBackend::renderTemplateBatch(
+    const QVariantList& jobs, int workers, const QVariantMap& paperSize, int timeout) {
+    qDebug() << "PlaywrightEngineBackend: Rendering" << jobs.size() << "template job(s) on" << workers << "page(s).";
+    PlaywrightProtocol::RenderTemplateBatchCommand command;
+    command.jobs = jobs;
+    command.workers = workers;
+    command.paperSize = paperSize;
+    command.timeout = timeout;
+    return sendSyncCommand(command).toStringList();
+}
+
 QByteArray PlaywrightEngineBackend::renderImage(
     const QRect& clipRect, bool onlyViewport, const QPoint& scrollPosition) {
     qDebug() << "PlaywrightEngineBackend: Rendering Image (PNG/JPEG).";
-    QVariantMap params;
-    params["format"] = "png"; // Default to PNG, could be parameterized
-    params["clipRect"] = QVariantMap { { "x", clipRect.x() }, { "y", clipRect.y() }, { "width", clipRect.width() },
-        { "height", clipRect.height() } };
-    params["onlyViewport"] = onlyViewport;
-    params["scrollPosition"] = QVariantMap { { "x", scrollPosition.x() }, { "y", scrollPosition.y() } };
-
-    QVariant result = sendSyncCommand("render", params);
+    PlaywrightProtocol::RenderImageCommand command;
+    command.format = "png"; // Default to PNG, could be parameterized
+    command.clipRect = clipRect;
+    command.onlyViewport = onlyViewport;
+    command.scrollPosition = scrollPosition;
+
+    QVariant result = sendSyncCommand(command);
     if (result.isValid() && result.type() == QVariant::String) {
         return QByteArray::fromBase64(result.toByteArray()); // Expecting base64 encoded image
     }
@@ -303,8 +392,70 @@ QByteArray PlaywrightEngineBackend::renderImage(
     return QByteArray();
 }
 
+QByteArray PlaywrightEngineBackend::captureViewportFast(const QRect& clipRect, const QByteArray& format, int quality) {
+    PlaywrightProtocol::CaptureViewportFastCommand command;
+    command.format = QString::fromLatin1(format);
+    command.clipRect = clipRect;
+    command.quality = quality;
+    return QByteArray::fromBase64(sendSyncCommand(command).toByteArray());
+}
+
+QImage PlaywrightEngineBackend::captureFrame(const QRect& clipRect, bool onlyViewport, const QPoint& scrollPosition) {
+    // Playwright only hands out encoded screenshots. PNG is lossless, so decoding it once here yields the exact
+    // pixels and leaves the choice of output encoder to the caller.
+    const QByteArray png = renderImage(clipRect, onlyViewport, scrollPosition);
+    QImage frame;
+    if (png.isEmpty() || !frame.loadFromData(png, "PNG")) {
+        qWarning() << "PlaywrightEngineBackend: Could not decode captured frame.";
+        return QImage();
+    }
+    return frame.convertToFormat(QImage::Format_ARGB32);
+}
+
+QList<QImage> PlaywrightEngineBackend::captureViewports(
+    const QList<QSize>& sizes, bool onlyViewport, int settleTime) {
+    PlaywrightProtocol::RenderViewportsCommand command;
+    for (const QSize& size : sizes) {
+        command.viewports.append(QVariantMap { { "width", size.width() }, { "height", size.height() } });
+    }
+    command.onlyViewport = onlyViewport;
+    command.settleTime = settleTime;
+
+    QList<QImage> frames;
+    const QVariantList images = sendSyncCommand(command).toList();
+    for (const QVariant& image : images) {
+        QImage frame;
+        if (!frame.loadFromData(QByteArray::fromBase64(image.toByteArray()), "PNG")) {
+            qWarning() << "PlaywrightEngineBackend: Could not decode a viewport capture.";
+            return QList<QImage>();
+        }
+        frames.append(frame.convertToFormat(QImage::Format_ARGB32));
+    }
+    return frames;
+}
+
+QList<QList<QRect>> PlaywrightEngineBackend::elementRects(const QStringList& selectors, bool all) {
+    PlaywrightProtocol::GetElementRectsCommand command;
+    for (const QString& selector : selectors) {
+        command.selectors.append(selector);
+    }
+    command.all = all;
+
+    QList<QList<QRect>> rects;
+    for (const QVariant& matches : sendSyncCommand(command).toList()) {
+        QList<QRect> boxes;
+        for (const QVariant& match : matches.toList()) {
+            const QVariantMap box = match.toMap();
+            boxes.append(QRect(box.value("x").toInt(), box.value("y").toInt(), box.value("width").toInt(),
+                box.value("height").toInt()));
+        }
+        rects.append(boxes);
+    }
+    return rects;
+}
+
 qreal PlaywrightEngineBackend::zoomFactor() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getZoomFactor");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetZoomFactorCommand());
     if (result.isValid() && result.type() == QVariant::Double) {
         m_currentZoomFactor = result.toReal();
     }
@@ -314,51 +465,91 @@ qreal PlaywrightEngineBackend::zoomFactor() const {
 void PlaywrightEngineBackend::setZoomFactor(qreal zoom) {
     qDebug() << "PlaywrightEngineBackend: Setting zoom factor:" << zoom;
     m_currentZoomFactor = zoom; // Cache locally
-    QVariantMap params;
-    params["zoom"] = zoom;
-    sendAsyncCommand("setZoomFactor", params);
+    PlaywrightProtocol::SetZoomFactorCommand command;
+    command.zoom = zoom;
+    recordForReplay(command);
+    sendAsyncCommand(command);
+}
+
+void PlaywrightEngineBackend::setRepaintTracking(bool enabled) {
+    PlaywrightProtocol::SetRepaintTrackingCommand command;
+    command.enabled = enabled;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
+QList<QRect> PlaywrightEngineBackend::takeRepaints() {
+    QList<QRect> rects;
+    for (const QVariant& value : sendSyncCommand(PlaywrightProtocol::TakeRepaintsCommand()).toList()) {
+        const QVariantMap rect = value.toMap();
+        rects.append(QRect(rect.value("x").toInt(), rect.value("y").toInt(), rect.value("width").toInt(),
+            rect.value("height").toInt()));
+    }
+    return rects;
+}
+
+bool PlaywrightEngineBackend::startScreencast(int fps, int quality, const QSize& maxSize) {
+    PlaywrightProtocol::StartScreencastCommand command;
+    command.fps = fps;
+    command.quality = quality;
+    command.maxWidth = maxSize.width();
+    command.maxHeight = maxSize.height();
+    return sendSyncCommand(command).toBool();
+}
+
+void PlaywrightEngineBackend::stopScreencast() { sendSyncCommand(PlaywrightProtocol::StopScreencastCommand()); }
+
 QVariant PlaywrightEngineBackend::evaluateJavaScript(const QString& code) {
     qDebug() << "PlaywrightEngineBackend: Evaluating JavaScript.";
-    QVariantMap params;
-    params["code"] = code;
-    return sendSyncCommand("evaluateJavaScript", params);
+    PlaywrightProtocol::EvaluateJavaScriptCommand command;
+    command.code = code;
+    return sendSyncCommand(command);
 }
 
 bool PlaywrightEngineBackend::injectJavaScriptFile(
     const QString& jsFilePath, const QString& encoding, const QString& libraryPath, bool forEachFrame) {
     qDebug() << "PlaywrightEngineBackend: Injecting JavaScript file:" << jsFilePath;
-    QVariantMap params;
-    params["path"] = jsFilePath;
-    params["encoding"] = encoding;
-    params["libraryPath"] = libraryPath; // Might not be needed by Playwright directly
-    params["forEachFrame"] = forEachFrame;
-    QVariant result = sendSyncCommand("injectJavaScriptFile", params);
+    PlaywrightProtocol::InjectJavaScriptFileCommand command;
+    command.path = jsFilePath;
+    command.encoding = encoding;
+    command.libraryPath = libraryPath; // Might not be needed by Playwright directly
+    command.forEachFrame = forEachFrame;
+    QVariant result = sendSyncCommand(command);
+    if (result.toBool()) {
+        m_replayInjections.append(command.toJson());
+    }
     return result.toBool();
 }
 
 void PlaywrightEngineBackend::exposeQObject(const QString& name, QObject* object) {
-    qDebug() << "PlaywrightEngineBackend: Exposing QObject (stub):" << name;
-    // Playwright doesn't directly support QObject exposure like QtWebEngine.
-    // This would typically involve serializing QObject method calls/signals to Node.js
-    // and back, which is complex. For now, it's a stub.
-    // If specific functionality is needed, it should be mapped to Playwright actions.
-    QVariantMap params;
-    params["name"] = name;
-    // No actual object is sent, as we can't serialize QObjects to JSON directly
-    sendAsyncCommand("exposeQObject", params); // This just tells Playwright the object exists
+    qDebug() << "PlaywrightEngineBackend: Exposing QObject:" << name;
+    // QObjects can't cross the process boundary, so only the names of the invokable methods are sent. Calls from the
+    // page come back as callExposedQObjectMethod events.
+    PlaywrightProtocol::ExposeQObjectCommand command;
+    command.name = name;
+    if (object) {
+        const QMetaObject* meta = object->metaObject();
+        for (int i = meta->methodOffset(); i < meta->methodCount(); ++i) {
+            const QMetaMethod method = meta->method(i);
+            if (method.access() == QMetaMethod::Public && method.methodType() != QMetaMethod::Signal) {
+                command.methods.append(QString::fromLatin1(method.name()));
+            }
+        }
+        command.methods.removeDuplicates();
+    }
+    recordForReplay(command, name);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::appendScriptElement(const QString& scriptUrl) {
     qDebug() << "PlaywrightEngineBackend: Appending script element:" << scriptUrl;
-    QVariantMap params;
-    params["url"] = scriptUrl;
-    sendAsyncCommand("appendScriptElement", params);
+    PlaywrightProtocol::AppendScriptElementCommand command;
+    command.url = scriptUrl;
+    sendAsyncCommand(command);
 }
 
 QString PlaywrightEngineBackend::userAgent() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getUserAgent");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetUserAgentCommand());
     if (result.isValid() && result.type() == QVariant::String) {
         m_currentUserAgent = result.toString();
     }
@@ -368,21 +559,23 @@ QString PlaywrightEngineBackend::userAgent() const {
 void PlaywrightEngineBackend::setUserAgent(const QString& ua) {
     qDebug() << "PlaywrightEngineBackend: Setting user agent:" << ua;
     m_currentUserAgent = ua; // Cache locally
-    QVariantMap params;
-    params["userAgent"] = ua;
-    sendAsyncCommand("setUserAgent", params);
+    PlaywrightProtocol::SetUserAgentCommand command;
+    command.userAgent = ua;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setNavigationLocked(bool lock) {
     qDebug() << "PlaywrightEngineBackend: Setting navigation locked:" << lock;
     m_currentNavigationLocked = lock; // Cache locally
-    QVariantMap params;
-    params["locked"] = lock;
-    sendAsyncCommand("setNavigationLocked", params);
+    PlaywrightProtocol::SetNavigationLockedCommand command;
+    command.locked = lock;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 bool PlaywrightEngineBackend::navigationLocked() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getNavigationLocked");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetNavigationLockedCommand());
     if (result.isValid() && result.type() == QVariant::Bool) {
         m_currentNavigationLocked = result.toBool();
     }
@@ -390,7 +583,7 @@ bool PlaywrightEngineBackend::navigationLocked() const {
 }
 
 QVariantMap PlaywrightEngineBackend::customHeaders() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getCustomHeaders");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetCustomHeadersCommand());
     if (result.isValid() && result.type() == QVariant::Map) {
         m_currentCustomHeaders = result.toMap();
     }
@@ -400,9 +593,63 @@ QVariantMap PlaywrightEngineBackend::customHeaders() const {
 void PlaywrightEngineBackend::setCustomHeaders(const QVariantMap& headers) {
     qDebug() << "PlaywrightEngineBackend: Setting custom headers.";
     m_currentCustomHeaders = headers; // Cache locally
-    QVariantMap params;
-    params["headers"] = headers;
-    sendAsyncCommand("setCustomHeaders", params);
+    PlaywrightProtocol::SetCustomHeadersCommand command;
+    command.headers = headers;
+    recordForReplay(command);
+    sendAsyncCommand(command);
+}
+
+void PlaywrightEngineBackend::setRequestFilter(const QVariantMap& tables) {
+    PlaywrightProtocol::SetRequestFilterCommand command;
+    command.tables = tables;
+    recordForReplay(command);
+    sendAsyncCommand(command);
+}
+
+void PlaywrightEngineBackend::setRequestInterception(bool enabled, int deadline) {
+    PlaywrightProtocol::SetRequestInterceptionCommand command;
+    m_requestInterception = enabled;
+    command.enabled = enabled;
+    command.deadline = deadline;
+    recordForReplay(command);
+    sendAsyncCommand(command);
+}
+
+bool PlaywrightEngineBackend::startNetworkRecording(const QString& fileName) {
+    PlaywrightProtocol::StartNetworkRecordingCommand command;
+    command.file = fileName;
+    return sendSyncCommand(command).toBool();
+}
+
+int PlaywrightEngineBackend::stopNetworkRecording() {
+    return sendSyncCommand(PlaywrightProtocol::StopNetworkRecordingCommand()).toInt();
+}
+
+int PlaywrightEngineBackend::setNetworkReplay(const QString& fileName, bool fallThrough) {
+    PlaywrightProtocol::SetNetworkReplayCommand command;
+    command.file = fileName;
+    command.fallThrough = fallThrough;
+    // A restarted backend keeps replaying; a recording is lost with the process anyway.
+    recordForReplay(command);
+    return sendSyncCommand(command).toInt();
+}
+
+bool PlaywrightEngineBackend::startHar(const QString& fileName) {
+    PlaywrightProtocol::StartHarCommand command;
+    command.file = fileName;
+    command.creatorVersion = PHANTOMJS_VERSION_STRING;
+    return sendSyncCommand(command).toBool();
+}
+
+int PlaywrightEngineBackend::stopHar() { return sendSyncCommand(PlaywrightProtocol::StopHarCommand()).toInt(); }
+
+void PlaywrightEngineBackend::flushRequestDecisions() {
+    if (m_requestDecisions.isEmpty()) {
+        return;
+    }
+    PlaywrightProtocol::ResolveRequestsCommand command;
+    command.decisions.swap(m_requestDecisions);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::applySettings(const QVariantMap& settings) {
@@ -490,148 +737,171 @@ void PlaywrightEngineBackend::applySettings(const QVariantMap& settings) {
 
     // JS-related settings
     if (settings.contains("javascriptEnabled")) {
-        QVariantMap jsParams;
-        jsParams["enabled"] = settings["javascriptEnabled"].toBool();
-        sendAsyncCommand("setJavaScriptEnabled", jsParams);
+        PlaywrightProtocol::SetJavaScriptEnabledCommand command;
+        command.enabled = settings["javascriptEnabled"].toBool();
+        recordForReplay(command);
+        sendAsyncCommand(command);
     }
     if (settings.contains("webSecurityEnabled")) {
-        QVariantMap wsParams;
-        wsParams["enabled"] = settings["webSecurityEnabled"].toBool();
-        sendAsyncCommand("setWebSecurityEnabled", wsParams);
+        PlaywrightProtocol::SetWebSecurityEnabledCommand command;
+        command.enabled = settings["webSecurityEnabled"].toBool();
+        recordForReplay(command);
+        sendAsyncCommand(command);
     }
     if (settings.contains("webGLEnabled")) {
-        QVariantMap webglParams;
-        webglParams["enabled"] = settings["webGLEnabled"].toBool();
-        sendAsyncCommand("setWebGLEnabled", webglParams);
+        PlaywrightProtocol::SetWebGLEnabledCommand command;
+        command.enabled = settings["webGLEnabled"].toBool();
+        recordForReplay(command);
+        sendAsyncCommand(command);
     }
     if (settings.contains("javascriptCanOpenWindows")) {
-        QVariantMap openWinParams;
-        openWinParams["canOpen"] = settings["javascriptCanOpenWindows"].toBool();
-        sendAsyncCommand("setJavaScriptCanOpenWindows", openWinParams);
+        PlaywrightProtocol::SetJavaScriptCanOpenWindowsCommand command;
+        command.enabled = settings["javascriptCanOpenWindows"].toBool();
+        recordForReplay(command);
+        sendAsyncCommand(command);
     }
     if (settings.contains("javascriptCanCloseWindows")) {
-        QVariantMap closeWinParams;
-        closeWinParams["canClose"] = settings["javascriptCanCloseWindows"].toBool();
-        sendAsyncCommand("setJavaScriptCanCloseWindows", closeWinParams);
+        PlaywrightProtocol::SetJavaScriptCanCloseWindowsCommand command;
+        command.enabled = settings["javascriptCanCloseWindows"].toBool();
+        recordForReplay(command);
+        sendAsyncCommand(command);
     }
     if (settings.contains("localToRemoteUrlAccessEnabled")) {
-        QVariantMap accessParams;
-        accessParams["enabled"] = settings["localToRemoteUrlAccessEnabled"].toBool();
-        sendAsyncCommand("setLocalToRemoteUrlAccessEnabled", accessParams);
+        PlaywrightProtocol::SetLocalToRemoteUrlAccessEnabledCommand command;
+        command.enabled = settings["localToRemoteUrlAccessEnabled"].toBool();
+        recordForReplay(command);
+        sendAsyncCommand(command);
     }
     if (settings.contains("autoLoadImages")) {
-        QVariantMap imagesParams;
-        imagesParams["autoLoad"] = settings["autoLoadImages"].toBool();
-        sendAsyncCommand("setAutoLoadImages", imagesParams);
+        PlaywrightProtocol::SetAutoLoadImagesCommand command;
+        command.enabled = settings["autoLoadImages"].toBool();
+        recordForReplay(command);
+        sendAsyncCommand(command);
     }
 }
 
 void PlaywrightEngineBackend::setNetworkProxy(const QNetworkProxy& proxy) {
     qDebug() << "PlaywrightEngineBackend: Setting network proxy:" << proxy.hostName() << ":" << proxy.port();
-    QVariantMap params;
-    params["type"] = proxy.type() == QNetworkProxy::Socks5Proxy ? "socks5" : "http";
-    params["host"] = proxy.hostName();
-    params["port"] = proxy.port();
-    params["user"] = proxy.user();
-    params["password"] = proxy.password();
-    sendAsyncCommand("setNetworkProxy", params);
+    PlaywrightProtocol::SetNetworkProxyCommand command;
+    command.type = proxy.type() == QNetworkProxy::Socks5Proxy ? "socks5" : "http";
+    command.host = proxy.hostName();
+    command.port = proxy.port();
+    command.user = proxy.user();
+    command.password = proxy.password();
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setDiskCacheEnabled(bool enabled) {
     qDebug() << "PlaywrightEngineBackend: Setting disk cache enabled:" << enabled;
-    QVariantMap params;
-    params["enabled"] = enabled;
-    sendAsyncCommand("setDiskCacheEnabled", params);
+    PlaywrightProtocol::SetDiskCacheEnabledCommand command;
+    command.enabled = enabled;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setMaxDiskCacheSize(int size) {
     qDebug() << "PlaywrightEngineBackend: Setting max disk cache size:" << size;
-    QVariantMap params;
-    params["size"] = size;
-    sendAsyncCommand("setMaxDiskCacheSize", params);
+    PlaywrightProtocol::SetMaxDiskCacheSizeCommand command;
+    command.size = size;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setDiskCachePath(const QString& path) {
     qDebug() << "PlaywrightEngineBackend: Setting disk cache path:" << path;
-    QVariantMap params;
-    params["path"] = path;
-    sendAsyncCommand("setDiskCachePath", params);
+    PlaywrightProtocol::SetDiskCachePathCommand command;
+    // Like QNetworkDiskCache in PhantomJS, the cache lives in the user's cache directory unless told otherwise.
+    // Every backend gets the same directory, so pages (and runs) share what the others downloaded.
+    command.path = path.isEmpty() ? QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/http" : path;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setIgnoreSslErrors(bool ignore) {
     qDebug() << "PlaywrightEngineBackend: Setting ignore SSL errors:" << ignore;
-    QVariantMap params;
-    params["ignore"] = ignore;
-    sendAsyncCommand("setIgnoreSslErrors", params);
+    PlaywrightProtocol::SetIgnoreSslErrorsCommand command;
+    command.ignore = ignore;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setSslProtocol(const QString& protocol) {
     qDebug() << "PlaywrightEngineBackend: Setting SSL protocol:" << protocol;
-    QVariantMap params;
-    params["protocol"] = protocol;
-    sendAsyncCommand("setSslProtocol", params);
+    PlaywrightProtocol::SetSslProtocolCommand command;
+    command.protocol = protocol;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setSslCiphers(const QString& ciphers) {
     qDebug() << "PlaywrightEngineBackend: Setting SSL ciphers:" << ciphers;
-    QVariantMap params;
-    params["ciphers"] = ciphers;
-    sendAsyncCommand("setSslCiphers", params);
+    PlaywrightProtocol::SetSslCiphersCommand command;
+    command.ciphers = ciphers;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setSslCertificatesPath(const QString& path) {
     qDebug() << "PlaywrightEngineBackend: Setting SSL certificates path:" << path;
-    QVariantMap params;
-    params["path"] = path;
-    sendAsyncCommand("setSslCertificatesPath", params);
+    PlaywrightProtocol::SetSslCertificatesPathCommand command;
+    command.path = path;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setSslClientCertificateFile(const QString& file) {
     qDebug() << "PlaywrightEngineBackend: Setting SSL client cert file:" << file;
-    QVariantMap params;
-    params["file"] = file;
-    sendAsyncCommand("setSslClientCertificateFile", params);
+    PlaywrightProtocol::SetSslClientCertificateFileCommand command;
+    command.file = file;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setSslClientKeyFile(const QString& file) {
     qDebug() << "PlaywrightEngineBackend: Setting SSL client key file:" << file;
-    QVariantMap params;
-    params["file"] = file;
-    sendAsyncCommand("setSslClientKeyFile", params);
+    PlaywrightProtocol::SetSslClientKeyFileCommand command;
+    command.file = file;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setSslClientKeyPassphrase(const QByteArray& passphrase) {
     qDebug() << "PlaywrightEngineBackend: Setting SSL client key passphrase (hashed/obscured).";
-    QVariantMap params;
-    params["passphrase"] = QString::fromUtf8(passphrase.toBase64()); // Send as base64 for safety
-    sendAsyncCommand("setSslClientKeyPassphrase", params);
+    PlaywrightProtocol::SetSslClientKeyPassphraseCommand command;
+    command.passphrase = QString::fromUtf8(passphrase.toBase64()); // Send as base64 for safety
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setResourceTimeout(int timeout) {
     qDebug() << "PlaywrightEngineBackend: Setting resource timeout:" << timeout;
-    QVariantMap params;
-    params["timeout"] = timeout;
-    sendAsyncCommand("setResourceTimeout", params);
+    PlaywrightProtocol::SetResourceTimeoutCommand command;
+    command.timeout = timeout;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setMaxAuthAttempts(int attempts) {
     qDebug() << "PlaywrightEngineBackend: Setting max auth attempts:" << attempts;
-    QVariantMap params;
-    params["attempts"] = attempts;
-    sendAsyncCommand("setMaxAuthAttempts", params);
+    PlaywrightProtocol::SetMaxAuthAttemptsCommand command;
+    command.attempts = attempts;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::setLocalStoragePath(const QString& path) {
     qDebug() << "PlaywrightEngineBackend: Setting local storage path (stub):" << path;
     m_currentLocalStoragePath = path; // Cache locally
-    QVariantMap params;
-    params["path"] = path;
-    sendAsyncCommand("setLocalStoragePath", params);
+    PlaywrightProtocol::SetLocalStoragePathCommand command;
+    command.path = path;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 int PlaywrightEngineBackend::localStorageQuota() const {
     qDebug() << "PlaywrightEngineBackend: localStorageQuota called (stub).";
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getLocalStorageQuota");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetLocalStorageQuotaCommand());
     if (result.isValid() && result.type() == QVariant::Int) {
         m_currentLocalStorageQuota = result.toInt();
     }
@@ -641,14 +911,15 @@ int PlaywrightEngineBackend::localStorageQuota() const {
 void PlaywrightEngineBackend::setOfflineStoragePath(const QString& path) {
     qDebug() << "PlaywrightEngineBackend: Setting offline storage path (stub):" << path;
     m_currentOfflineStoragePath = path; // Cache locally
-    QVariantMap params;
-    params["path"] = path;
-    sendAsyncCommand("setOfflineStoragePath", params);
+    PlaywrightProtocol::SetOfflineStoragePathCommand command;
+    command.path = path;
+    recordForReplay(command);
+    sendAsyncCommand(command);
 }
 
 int PlaywrightEngineBackend::offlineStorageQuota() const {
     qDebug() << "PlaywrightEngineBackend: offlineStorageQuota called (stub).";
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getOfflineStorageQuota");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetOfflineStorageQuotaCommand());
     if (result.isValid() && result.type() == QVariant::Int) {
         m_currentOfflineStorageQuota = result.toInt();
     }
@@ -657,29 +928,27 @@ int PlaywrightEngineBackend::offlineStorageQuota() const {
 
 void PlaywrightEngineBackend::clearMemoryCache() {
     qDebug() << "PlaywrightEngineBackend: Clearing memory cache.";
-    sendAsyncCommand("clearMemoryCache");
+    sendAsyncCommand(PlaywrightProtocol::ClearMemoryCacheCommand());
 }
 
 void PlaywrightEngineBackend::setCookieJar(CookieJar* cookieJar) {
-    qDebug() << "PlaywrightEngineBackend: Setting cookie jar (stub).";
-    // This is complex. The CookieJar needs to be synchronized with Playwright's cookie management.
-    // For now, it's a stub. Actual implementation would involve sending/receiving cookies to/from Playwright.
-    QVariantMap params;
-    // You might pass a reference/ID or a path to a cookie file if Playwright supports it.
-    sendAsyncCommand("setCookieJar", params);
+    qDebug() << "PlaywrightEngineBackend: Setting cookie jar.";
+    // Cookies live in the browser context on the Node.js side; the jar is only kept so its contents can be pushed to
+    // the backend when needed.
+    m_cookieJar = cookieJar;
 }
 
 bool PlaywrightEngineBackend::setCookies(const QVariantList& cookies) {
     qDebug() << "PlaywrightEngineBackend: Setting cookies.";
-    QVariantMap params;
-    params["cookies"] = cookies;
-    QVariant result = sendSyncCommand("setCookies", params);
+    PlaywrightProtocol::SetCookiesCommand command;
+    command.cookies = cookies;
+    QVariant result = sendSyncCommand(command);
     return result.toBool();
 }
 
 QVariantList PlaywrightEngineBackend::cookies() const {
     qDebug() << "PlaywrightEngineBackend: Getting cookies.";
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getCookies");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetCookiesCommand());
     if (result.isValid() && result.type() == QVariant::List) {
         m_currentCookies = result.toList();
     }
@@ -688,28 +957,28 @@ QVariantList PlaywrightEngineBackend::cookies() const {
 
 bool PlaywrightEngineBackend::addCookie(const QVariantMap& cookie) {
     qDebug() << "PlaywrightEngineBackend: Adding cookie.";
-    QVariantMap params;
-    params["cookie"] = cookie;
-    QVariant result = sendSyncCommand("addCookie", params);
+    PlaywrightProtocol::AddCookieCommand command;
+    command.cookie = cookie;
+    QVariant result = sendSyncCommand(command);
     return result.toBool();
 }
 
 bool PlaywrightEngineBackend::deleteCookie(const QString& cookieName) {
     qDebug() << "PlaywrightEngineBackend: Deleting cookie:" << cookieName;
-    QVariantMap params;
-    params["name"] = cookieName;
-    QVariant result = sendSyncCommand("deleteCookie", params);
+    PlaywrightProtocol::DeleteCookieCommand command;
+    command.name = cookieName;
+    QVariant result = sendSyncCommand(command);
     return result.toBool();
 }
 
 void PlaywrightEngineBackend::clearCookies() { // Changed to void
     qDebug() << "PlaywrightEngineBackend: Clearing cookies.";
-    sendAsyncCommand("clearCookies");
+    sendAsyncCommand(PlaywrightProtocol::ClearCookiesCommand());
 }
 
 int PlaywrightEngineBackend::framesCount() const {
     qDebug() << "PlaywrightEngineBackend: framesCount called (stub).";
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getFramesCount");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetFramesCountCommand());
     if (result.isValid() && result.type() == QVariant::Int) {
         m_currentFramesCount = result.toInt();
     }
@@ -718,7 +987,7 @@ int PlaywrightEngineBackend::framesCount() const {
 
 QStringList PlaywrightEngineBackend::framesName() const {
     qDebug() << "PlaywrightEngineBackend: framesName called (stub).";
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getFramesName");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetFramesNameCommand());
     if (result.isValid() && result.type() == QVariant::List) {
         m_currentFramesName.clear();
         for (const QVariant& item : result.toList()) {
@@ -732,9 +1001,9 @@ QStringList PlaywrightEngineBackend::framesName() const {
 
 bool PlaywrightEngineBackend::switchToFrame(const QString& frameName) {
     qDebug() << "PlaywrightEngineBackend: switchToFrame by name called. Name:" << frameName;
-    QVariantMap params;
-    params["name"] = frameName;
-    QVariant result = sendSyncCommand("switchToFrameByName", params);
+    PlaywrightProtocol::SwitchToFrameByNameCommand command;
+    command.name = frameName;
+    QVariant result = sendSyncCommand(command);
     if (result.toBool()) {
         m_currentFrameName = frameName;
     }
@@ -743,42 +1012,42 @@ bool PlaywrightEngineBackend::switchToFrame(const QString& frameName) {
 
 bool PlaywrightEngineBackend::switchToFrame(int framePosition) {
     qDebug() << "PlaywrightEngineBackend: switchToFrame by position called. Position:" << framePosition;
-    QVariantMap params;
-    params["position"] = framePosition;
-    QVariant result = sendSyncCommand("switchToFrameByPosition", params);
+    PlaywrightProtocol::SwitchToFrameByPositionCommand command;
+    command.position = framePosition;
+    QVariant result = sendSyncCommand(command);
     if (result.toBool()) {
         // Need to fetch actual frame name after switching
-        m_currentFrameName = sendSyncCommand("getFrameName").toString();
+        m_currentFrameName = sendSyncCommand(PlaywrightProtocol::GetFrameNameCommand()).toString();
     }
     return result.toBool();
 }
 
 void PlaywrightEngineBackend::switchToMainFrame() {
     qDebug() << "PlaywrightEngineBackend: switchToMainFrame called.";
-    sendAsyncCommand("switchToMainFrame");
+    sendAsyncCommand(PlaywrightProtocol::SwitchToMainFrameCommand());
     m_currentFrameName = ""; // Main frame has no specific name usually
 }
 
 bool PlaywrightEngineBackend::switchToParentFrame() {
     qDebug() << "PlaywrightEngineBackend: switchToParentFrame called.";
-    QVariant result = sendSyncCommand("switchToParentFrame");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::SwitchToParentFrameCommand());
     if (result.toBool()) {
-        m_currentFrameName = sendSyncCommand("getFrameName").toString();
+        m_currentFrameName = sendSyncCommand(PlaywrightProtocol::GetFrameNameCommand()).toString();
     }
     return result.toBool();
 }
 
 bool PlaywrightEngineBackend::switchToFocusedFrame() { // Changed to bool
     qDebug() << "PlaywrightEngineBackend: switchToFocusedFrame called.";
-    QVariant result = sendSyncCommand("switchToFocusedFrame");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::SwitchToFocusedFrameCommand());
     if (result.toBool()) {
-        m_currentFocusedFrameName = sendSyncCommand("getFocusedFrameName").toString();
+        m_currentFocusedFrameName = sendSyncCommand(PlaywrightProtocol::GetFocusedFrameNameCommand()).toString();
     }
     return result.toBool();
 }
 
 QString PlaywrightEngineBackend::frameName() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getFrameName");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetFrameNameCommand());
     if (result.isValid() && result.type() == QVariant::String) {
         m_currentFrameName = result.toString();
     }
@@ -786,7 +1055,7 @@ QString PlaywrightEngineBackend::frameName() const {
 }
 
 QString PlaywrightEngineBackend::focusedFrameName() const {
-    QVariant result = const_cast<PlaywrightEngineBackend*>(this)->sendSyncCommand("getFocusedFrameName");
+    QVariant result = sendSyncCommand(PlaywrightProtocol::GetFocusedFrameNameCommand());
     if (result.isValid() && result.type() == QVariant::String) {
         m_currentFocusedFrameName = result.toString();
     }
@@ -796,93 +1065,153 @@ QString PlaywrightEngineBackend::focusedFrameName() const {
 void PlaywrightEngineBackend::sendEvent(const QString& type, const QVariant& arg1, const QVariant& arg2,
     const QString& mouseButton, const QVariant& modifierArg) {
     qDebug() << "PlaywrightEngineBackend: Sending event (stub):" << type;
-    QVariantMap params;
-    params["type"] = type;
-    params["arg1"] = arg1;
-    params["arg2"] = arg2;
-    params["mouseButton"] = mouseButton;
-    params["modifierArg"] = modifierArg;
-    sendAsyncCommand("sendEvent", params);
+    PlaywrightProtocol::SendEventCommand command;
+    command.type = type;
+    command.arg1 = arg1;
+    command.arg2 = arg2;
+    command.mouseButton = mouseButton;
+    command.modifierArg = modifierArg;
+    sendAsyncCommand(command);
 }
 
 void PlaywrightEngineBackend::uploadFile(const QString& selector, const QStringList& fileNames) {
     qDebug() << "PlaywrightEngineBackend: Uploading file:" << selector << fileNames;
-    QVariantMap params;
-    params["selector"] = selector;
-    params["fileNames"] = fileNames;
-    sendAsyncCommand("uploadFile", params);
+    PlaywrightProtocol::UploadFileCommand command;
+    command.selector = selector;
+    command.fileNames = fileNames;
+    sendAsyncCommand(command);
 }
 
 int PlaywrightEngineBackend::showInspector(int port) {
     qDebug() << "PlaywrightEngineBackend: Showing inspector on port (stub):" << port;
-    QVariantMap params;
-    params["port"] = port;
-    QVariant result = sendSyncCommand("showInspector", params);
+    PlaywrightProtocol::ShowInspectorCommand command;
+    command.port = port;
+    QVariant result = sendSyncCommand(command);
     return result.toInt();
 }
 
-// --- Internal Communication Methods ---
+bool PlaywrightEngineBackend::isHealthy() const { return m_healthy; }
 
-QVariant PlaywrightEngineBackend::sendSyncCommand(const QString& command, const QVariantMap& params) {
-    QMutexLocker locker(&m_mutex);
-    quint64 requestId = m_nextRequestId++;
-    QVariantMap requestData;
-    requestData["id"] = QString::number(requestId);
-    requestData["command"] = command;
-    requestData["params"] = params;
+void PlaywrightEngineBackend::requestShutdown(bool graceful) {
+    m_heartbeatTimer->stop();
+    if (m_playwrightProcess->state() == QProcess::NotRunning) {
+        return;
+    }
+    // An intentional shutdown is not a crash; don't report it as one or restart the backend.
+    m_playwrightProcess->disconnect(this);
+    if (graceful && m_healthy) {
+        sendAsyncCommand(PlaywrightProtocol::ShutdownCommand());
+    } else {
+        // Playwright's SIGTERM handler kills its browsers without closing them cleanly.
+        m_playwrightProcess->terminate();
+    }
+}
 
-    QJsonDocument doc(QJsonObject::fromVariantMap(requestData));
-    QByteArray messageJson = doc.toJson(QJsonDocument::Compact);
-    QByteArray messageWithLength = QByteArray::number(messageJson.length()) + "\n" + messageJson;
+bool PlaywrightEngineBackend::waitForShutdown(int msecs) {
+    return m_playwrightProcess->state() == QProcess::NotRunning || m_playwrightProcess->waitForFinished(msecs);
+}
 
-    qDebug() << "PlaywrightEngineBackend: Sending sync command (ID:" << requestId << "):" << messageWithLength.left(100)
-             << "...";
+void PlaywrightEngineBackend::kill() {
+    m_playwrightProcess->kill();
+    m_playwrightProcess->waitForFinished(1000);
+}
 
-    if (!m_playwrightProcess || m_playwrightProcess->state() != QProcess::Running) {
-        qWarning() << "PlaywrightEngineBackend: Playwright process not running. Cannot send sync command.";
+// --- Internal Communication Methods ---
+
+QVariant PlaywrightEngineBackend::sendCommand(
+    PlaywrightProtocol::Command command, const QJsonObject& params, bool isSync) {
+    if (!m_healthy) {
+        // Fail fast: a dead backend would only make every sync command sit out its full timeout.
+        qWarning() << "PlaywrightEngineBackend: Backend is unhealthy, dropping command:"
+                   << PlaywrightProtocol::commandName(command);
         return QVariant();
     }
 
-    m_playwrightProcess->write(messageWithLength);
-    m_playwrightProcess->waitForBytesWritten(-1); // Wait indefinitely for write to complete
+    QJsonObject message;
+    message["type"] = isSync ? "sync" : "async";
+    message["cmd"] = static_cast<int>(command);
+    message["params"] = params;
+
+    quint64 requestId = 0;
+    if (isSync) {
+        requestId = m_nextRequestId++;
+        message["id"] = static_cast<qint64>(requestId);
+    }
+
+    qDebug() << "PlaywrightEngineBackend: Sending" << (isSync ? "sync" : "async")
+             << "command:" << PlaywrightProtocol::commandName(command) << "(ID:" << requestId << ")";
 
-    // Wait for the response
+    if (!writeMessage(message) || !isSync) {
+        return QVariant();
+    }
+
+    // The response arrives on stdout; pump the process directly rather than waiting for the event loop, which may
+    // be this very call stack. Events that arrive in the meantime are dispatched as usual. The heartbeat timer can't
+    // fire while we block here, so keep pinging from the loop: a hung backend then fails this command after
+    // m_heartbeatMisses intervals instead of the full timeout. Streamed output (pdfChunk, pdfPartRendered and
+    // templateRendered events, and pdfPrinting or templatePreparing while the backend works towards them) counts as
+    // progress and restarts the timeout, so a long document or batch only fails if the backend stalls.
+    QElapsedTimer timer;
+    timer.start();
+    quint64 streamActivity = m_streamActivity;
     while (!m_syncResponses.contains(requestId)) {
-        if (!m_commandWaitCondition.wait(&m_mutex, 5000)) { // Wait with a timeout
-            qWarning() << "PlaywrightEngineBackend: Timeout waiting for sync command response for ID:" << requestId;
-            return QVariant(); // Return empty if timeout
+        if (streamActivity != m_streamActivity) {
+            streamActivity = m_streamActivity;
+            timer.restart();
+        }
+        if (!m_healthy) {
+            qWarning() << "PlaywrightEngineBackend: Backend became unhealthy while waiting for"
+                       << PlaywrightProtocol::commandName(command) << "(ID:" << requestId << ")";
+            return QVariant();
+        }
+        const int remaining = SyncCommandTimeoutMs - static_cast<int>(timer.elapsed());
+        if (remaining <= 0 || m_playwrightProcess->state() != QProcess::Running) {
+            qWarning() << "PlaywrightEngineBackend: Timeout waiting for response to"
+                       << PlaywrightProtocol::commandName(command) << "(ID:" << requestId << ")";
+            return QVariant();
+        }
+        if (heartbeatDue()) {
+            heartbeat();
+            continue;
         }
+        int wait = remaining;
+        if (m_heartbeatInterval > 0) {
+            wait = qMin(wait, qMax(1, m_heartbeatInterval - static_cast<int>(m_lastHeartbeat.elapsed())));
+        }
+        m_playwrightProcess->waitForReadyRead(wait);
     }
     return m_syncResponses.take(requestId);
 }
 
-void PlaywrightEngineBackend::sendAsyncCommand(const QString& command, const QVariantMap& params) {
-    QVariantMap requestData;
-    requestData["command"] = command;
-    requestData["params"] = params;
-
-    QJsonDocument doc(QJsonObject::fromVariantMap(requestData));
-    QByteArray messageJson = doc.toJson(QJsonDocument::Compact);
-    QByteArray messageWithLength = QByteArray::number(messageJson.length()) + "\n" + messageJson;
-
-    qDebug() << "PlaywrightEngineBackend: Sending async command:" << messageWithLength.left(100) << "...";
+void PlaywrightEngineBackend::sendReply(quint64 requestId, const QJsonObject& result) {
+    QJsonObject message;
+    message["type"] = "reply";
+    message["id"] = static_cast<qint64>(requestId);
+    message["result"] = result;
+    writeMessage(message);
+}
 
+bool PlaywrightEngineBackend::writeMessage(const QJsonObject& message) {
     if (!m_playwrightProcess || m_playwrightProcess->state() != QProcess::Running) {
-        qWarning() << "PlaywrightEngineBackend: Playwright process not running. Cannot send async command.";
-        return;
+        qWarning() << "PlaywrightEngineBackend: Playwright process not running. Cannot send message.";
+        return false;
     }
 
-    m_playwrightProcess->write(messageWithLength);
-    m_playwrightProcess->waitForBytesWritten(-1); // Wait indefinitely for write to complete
+    const QByteArray messageJson = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    m_playwrightProcess->write(QByteArray::number(messageJson.size()) + '\n' + messageJson);
+    return true;
 }
 
 void PlaywrightEngineBackend::handleReadyReadStandardOutput() {
     m_readBuffer.append(m_playwrightProcess->readAllStandardOutput());
-    // The processIncomingMessage needs to handle reading the length prefix and then the JSON payload.
-    // It should recursively call itself if more complete messages are in the buffer.
-    QByteArray currentBuffer = m_readBuffer;
-    m_readBuffer.clear(); // Clear for the next read
-    processIncomingMessage(currentBuffer); // Process the current chunk
+    // Each frame is removed from the buffer before it is dispatched, so handlers that block on a sync command (and
+    // thus re-enter this slot) always see a consistent buffer.
+    QByteArray message;
+    while (takeMessage(&message)) {
+        processIncomingMessage(message);
+    }
+    // Everything decided about intercepted requests while handling this read goes out in one command.
+    flushRequestDecisions();
 }
 
 void PlaywrightEngineBackend::handleReadyReadStandardError() {
@@ -894,9 +1223,24 @@ void PlaywrightEngineBackend::handleReadyReadStandardError() {
 
 void PlaywrightEngineBackend::handleProcessStarted() {
     qDebug() << "PlaywrightEngineBackend: Node.js process has started.";
-    // Send an initialization command to the Playwright backend
-    sendAsyncCommand("initialize"); // Assuming Playwright backend expects an 'initialize' command
-    emitInitialized(); // Signal that the backend is ready
+    // The backend answers with an 'initialized' event once the browser is up.
+    PlaywrightProtocol::InitCommand command;
+    command.protocolVersion = PlaywrightProtocol::Version;
+    sendAsyncCommand(command);
+    if (m_restarting) {
+        // Node runs commands in order, so the replay waits for the browser launched by 'init'.
+        replayState();
+    }
+    if (ResponseCache::instance()->isEnabled()) {
+        PlaywrightProtocol::SetResponseCacheEnabledCommand cache;
+        cache.enabled = true;
+        sendAsyncCommand(cache);
+    }
+
+    if (m_heartbeatInterval > 0) {
+        m_lastHeartbeat.start();
+        m_heartbeatTimer->start();
+    }
 }
 
 void PlaywrightEngineBackend::handleProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
@@ -905,185 +1249,392 @@ void PlaywrightEngineBackend::handleProcessFinished(int exitCode, QProcess::Exit
     if (exitStatus == QProcess::CrashExit) {
         qCritical() << "PlaywrightEngineBackend: Node.js process crashed!";
     }
+    markUnhealthy(QString("Node.js process exited (code %1)").arg(exitCode));
 }
 
 void PlaywrightEngineBackend::handleProcessErrorOccurred(QProcess::ProcessError error) {
     qCritical() << "PlaywrightEngineBackend: QProcess error:" << error << m_playwrightProcess->errorString();
+    if (error == QProcess::FailedToStart || error == QProcess::Crashed) {
+        markUnhealthy(m_playwrightProcess->errorString());
+    }
 }
 
-void PlaywrightEngineBackend::processIncomingMessage(const QByteArray& data) {
-    QByteArray buffer = data; // Use a local copy for processing
-    while (true) {
-        int newlineIndex = buffer.indexOf('\n');
-        if (newlineIndex == -1) {
-            m_readBuffer.append(buffer); // Append remaining incomplete message to class buffer
-            return;
-        }
+bool PlaywrightEngineBackend::heartbeatDue() const {
+    return m_healthy && m_heartbeatInterval > 0 && m_lastHeartbeat.isValid()
+        && m_lastHeartbeat.elapsed() >= m_heartbeatInterval;
+}
 
-        QByteArray lengthBytes = buffer.left(newlineIndex).trimmed();
-        bool ok;
-        int messageLength = lengthBytes.toInt(&ok);
+void PlaywrightEngineBackend::heartbeat() {
+    if (!m_healthy) {
+        return;
+    }
+    m_lastHeartbeat.restart();
+    if (m_missedHeartbeats >= m_heartbeatMisses) {
+        markUnhealthy(QString("%1 heartbeats unanswered").arg(m_missedHeartbeats));
+        return;
+    }
+    ++m_missedHeartbeats;
+    PlaywrightProtocol::PingCommand command;
+    command.seq = ++m_heartbeatSeq;
+    sendAsyncCommand(command);
+}
 
-        if (!ok || messageLength < 0) {
-            qWarning() << "PlaywrightEngineBackend: Invalid message length header:" << lengthBytes;
-            m_readBuffer.clear(); // Clear buffer to avoid parsing issues with corrupted stream
-            return;
-        }
+void PlaywrightEngineBackend::markUnhealthy(const QString& reason) {
+    if (!m_healthy) {
+        return;
+    }
+    qCritical() << "PlaywrightEngineBackend: Backend is unhealthy:" << reason;
+    m_healthy = false;
+    m_heartbeatTimer->stop();
+    // Sync commands waiting further up the stack notice m_healthy and return on their next iteration.
+    Q_EMIT healthChanged(false);
+
+    if (m_restartCount < m_maxRestarts) {
+        // Restart from the event loop, once those waits have unwound.
+        QTimer::singleShot(RestartBackoffMs * m_restartCount, this, &PlaywrightEngineBackend::restartBackend);
+    } else if (m_maxRestarts > 0) {
+        qCritical() << "PlaywrightEngineBackend: Restart budget of" << m_maxRestarts << "exhausted, giving up.";
+    }
+}
 
-        // Check if we have the full message body
-        if (buffer.length() < newlineIndex + 1 + messageLength) {
-            m_readBuffer.append(buffer); // Not enough data, append to class buffer and wait for more
-            return;
+void PlaywrightEngineBackend::restartBackend() {
+    if (m_healthy) {
+        return;
+    }
+    ++m_restartCount;
+    qWarning() << "PlaywrightEngineBackend: Restarting Node.js backend, attempt" << m_restartCount << "of"
+               << m_maxRestarts;
+
+    // A hung process is still running; make sure it is gone before its replacement starts. Its 'finished' signal
+    // lands in markUnhealthy(), which ignores it while we are still unhealthy.
+    if (m_playwrightProcess->state() != QProcess::NotRunning) {
+        m_playwrightProcess->kill();
+        m_playwrightProcess->waitForFinished(1000);
+    }
+
+    m_readBuffer.clear();
+    m_syncResponses.clear();
+    m_missedHeartbeats = 0;
+    m_restarting = true;
+    m_healthy = true;
+    Q_EMIT healthChanged(true);
+
+    startBackendProcess();
+}
+
+void PlaywrightEngineBackend::replayState() {
+    qDebug() << "PlaywrightEngineBackend: Replaying page state to the new backend:" << m_replayLog.size()
+             << "commands";
+    // In the order the commands were last issued: later state may depend on earlier (e.g. the viewport on the
+    // zoom factor, init scripts on exposed objects).
+    QList<ReplayEntry> entries = m_replayLog.values();
+    std::sort(entries.begin(), entries.end(),
+        [](const ReplayEntry& a, const ReplayEntry& b) { return a.sequence < b.sequence; });
+    for (const ReplayEntry& entry : entries) {
+        sendCommand(entry.command, entry.params, false);
+    }
+
+    // The jar is the authoritative copy of the cookies; fall back to what the old backend reported last.
+    PlaywrightProtocol::SetCookiesCommand cookies;
+    cookies.cookies = m_cookieJar ? m_cookieJar->cookiesToMap() : m_currentCookies;
+    if (!cookies.cookies.isEmpty()) {
+        // Declared sync, but nobody can wait here: the new browser may still be launching.
+        sendCommand(PlaywrightProtocol::SetCookiesCommand::id, cookies.toJson(), false);
+    }
+
+    // The current URL, with the headers and load strategy of the last load() (the page may have navigated on its
+    // own since). Scripts injected into the document are evaluated again once it has loaded; the backend runs
+    // commands in order, so they wait for the load.
+    if (m_currentUrl.isValid() && m_currentUrl != QUrl("about:blank")) {
+        PlaywrightProtocol::LoadCommand load = m_lastLoad;
+        load.url = m_currentUrl.toString();
+        load.method = "GET";
+        load.body.clear();
+        sendAsyncCommand(load);
+        for (const QJsonObject& injection : m_replayInjections) {
+            sendCommand(PlaywrightProtocol::InjectJavaScriptFileCommand::id, injection, false);
         }
+    }
+}
 
-        QByteArray messageBody = buffer.mid(newlineIndex + 1, messageLength);
-        QJsonDocument doc = QJsonDocument::fromJson(messageBody, &m_jsonParseError);
+bool PlaywrightEngineBackend::takeMessage(QByteArray* message) {
+    const int newlineIndex = m_readBuffer.indexOf('\n');
+    if (newlineIndex == -1) {
+        return false;
+    }
 
-        if (m_jsonParseError.error != QJsonParseError::NoError) {
-            qWarning() << "PlaywrightEngineBackend: JSON parse error:" << m_jsonParseError.errorString()
-                       << "in message:" << messageBody;
-            m_readBuffer.clear(); // Clear buffer to avoid parsing issues with corrupted stream
-            return;
-        }
+    bool ok;
+    const int messageLength = m_readBuffer.left(newlineIndex).trimmed().toInt(&ok);
+    if (!ok || messageLength < 0) {
+        qWarning() << "PlaywrightEngineBackend: Invalid message length header:" << m_readBuffer.left(newlineIndex);
+        m_readBuffer.clear(); // Clear buffer to avoid parsing issues with corrupted stream
+        return false;
+    }
 
-        if (doc.isObject()) {
-            QJsonObject obj = doc.object();
-            if (obj.contains("type")) {
-                QString type = obj["type"].toString();
-                if (type == "response") {
-                    processResponse(obj);
-                } else if (type == "signal") {
-                    processSignal(obj);
-                } else {
-                    qWarning() << "PlaywrightEngineBackend: Unknown message type:" << type;
-                }
-            } else {
-                qWarning() << "PlaywrightEngineBackend: Message object has no 'type' field.";
-            }
-        } else {
-            qWarning() << "PlaywrightEngineBackend: Incoming message is not a JSON object.";
-        }
+    if (m_readBuffer.size() < newlineIndex + 1 + messageLength) {
+        return false; // Not enough data yet
+    }
+
+    *message = m_readBuffer.mid(newlineIndex + 1, messageLength);
+    m_readBuffer.remove(0, newlineIndex + 1 + messageLength);
+    return true;
+}
 
-        // Remove processed message from buffer and continue loop
-        buffer = buffer.mid(newlineIndex + 1 + messageLength);
+void PlaywrightEngineBackend::processIncomingMessage(const QByteArray& message) {
+    // Only the envelope is looked at here; payloads are decoded by the handlers that actually use them.
+    const IpcFrame frame = IpcFrame::scan(message);
+    if (!frame.isValid()) {
+        qWarning() << "PlaywrightEngineBackend: Malformed message:" << message.left(200);
+        return;
+    }
+
+    switch (frame.type()) {
+    case IpcFrame::Response:
+        processResponse(frame);
+        break;
+    case IpcFrame::Event:
+        processEvent(frame);
+        break;
+    default:
+        qWarning() << "PlaywrightEngineBackend: Unknown message type:" << frame.rawValue("type");
+        break;
     }
 }
 
-void PlaywrightEngineBackend::processResponse(const QJsonObject& response) {
-    QMutexLocker locker(&m_mutex);
-    if (response.contains("id") && response.contains("result")) {
-        quint64 requestId = response["id"].toString().toULongLong();
-        m_syncResponses[requestId] = response["result"].toVariant();
-        m_commandWaitCondition.wakeAll(); // Wake up any waiting sync commands
-        qDebug() << "PlaywrightEngineBackend: Received sync response for ID:" << requestId;
-    } else if (response.contains("id") && response.contains("error")) {
-        quint64 requestId = response["id"].toString().toULongLong();
-        QVariantMap errorMap = response["error"].toObject().toVariantMap();
+void PlaywrightEngineBackend::processResponse(const IpcFrame& response) {
+    const quint64 requestId = response.id();
+    if (response.hasMember("error")) {
         qWarning() << "PlaywrightEngineBackend: Received error response for ID:" << requestId << ":"
-                   << errorMap["message"].toString();
+                   << response.value("error").toObject()["message"].toString();
         m_syncResponses[requestId] = QVariant(); // Store an invalid variant to signal error/completion
-        m_commandWaitCondition.wakeAll();
     } else {
-        qWarning() << "PlaywrightEngineBackend: Invalid response format:" << response;
+        m_syncResponses[requestId] = response.value("result").toVariant();
     }
 }
 
-void PlaywrightEngineBackend::processSignal(const QJsonObject& signal) {
-    QString signalName = signal["name"].toString();
-    QVariantMap data = signal["data"].toObject().toVariantMap();
+void PlaywrightEngineBackend::processEvent(const IpcFrame& frame) {
+    using namespace PlaywrightProtocol;
 
-    qDebug() << "PlaywrightEngineBackend: Received signal:" << signalName;
+    const Event eventId = static_cast<Event>(frame.event());
+    const quint64 requestId = frame.id();
 
-    if (signalName == "loadStarted") {
-        emitLoadStarted(QUrl(data.value("url").toString()));
-    } else if (signalName == "loadFinished") {
-        emitLoadFinished(data.value("success").toBool(), QUrl(data.value("url").toString()));
-    } else if (signalName == "loadingProgress") {
-        emitLoadingProgress(data.value("progress").toInt());
-    } else if (signalName == "urlChanged") {
-        emitUrlChanged(QUrl(data.value("url").toString()));
-    } else if (signalName == "titleChanged") {
-        emitTitleChanged(data.value("title").toString());
-    } else if (signalName == "contentsChanged") {
+    switch (eventId) {
+    case Event::Initialized:
+        if (m_restarting) {
+            // The page was initialized once already; tell listeners about the failover instead.
+            m_restarting = false;
+            Q_EMIT backendRestarted(m_restartCount);
+        } else {
+            emitInitialized();
+        }
+        break;
+    case Event::LoadStarted:
+        emitLoadStarted(LoadStartedEvent::fromJson(frame.data()).url);
+        break;
+    case Event::LoadFinished: {
+        const LoadFinishedEvent e = LoadFinishedEvent::fromJson(frame.data());
+        emitLoadFinished(e.success, e.url);
+        break;
+    }
+    case Event::LoadingProgress:
+        emitLoadingProgress(LoadingProgressEvent::fromJson(frame.data()).progress);
+        break;
+    case Event::UrlChanged:
+        emitUrlChanged(UrlChangedEvent::fromJson(frame.data()).url);
+        break;
+    case Event::TitleChanged:
+        emitTitleChanged(TitleChangedEvent::fromJson(frame.data()).title);
+        break;
+    case Event::ContentsChanged:
         emitContentsChanged();
-    } else if (signalName == "navigationRequested") {
-        emitNavigationRequested(QUrl(data.value("url").toString()), data.value("navigationType").toString(),
-            data.value("isMainFrame").toBool(), data.value("navigationLocked").toBool());
-    } else if (signalName == "pageCreated") {
-        // This is complex: need to instantiate a new WebPage with a new PlaywrightEngineBackend
-        // For now, this is a stub or would require a more sophisticated process management.
-        // If Playwright backend supports creating new "contexts" or "pages", this would map to it.
-        // emitPageCreated(new PlaywrightEngineBackend(this)); // This creates a new backend, which might spawn another
-        // Node.js process if not handled carefully
-        qWarning() << "PlaywrightEngineBackend: 'pageCreated' signal received, but new page creation not fully "
+        break;
+    case Event::NavigationRequested: {
+        const NavigationRequestedEvent e = NavigationRequestedEvent::fromJson(frame.data());
+        emitNavigationRequested(e.url, e.navigationType, e.isMainFrame, e.navigationLocked);
+        break;
+    }
+    case Event::PageCreated:
+        // Needs a way to bind a new PlaywrightEngineBackend to an existing Playwright page; until then the Node.js
+        // side closes pages it did not create itself.
+        qWarning() << "PlaywrightEngineBackend: 'pageCreated' event received, but new page creation not fully "
                       "implemented yet.";
-    } else if (signalName == "windowCloseRequested") {
+        break;
+    case Event::WindowCloseRequested:
         emitWindowCloseRequested();
-    } else if (signalName == "javaScriptAlertSent") {
-        emitJavaScriptAlertSent(data.value("message").toString());
-    } else if (signalName == "javaScriptConsoleMessageSent") {
-        emitJavaScriptConsoleMessageSent(data.value("message").toString());
-    } else if (signalName == "javaScriptErrorSent") {
-        emitJavaScriptErrorSent(data.value("message").toString(), data.value("lineNumber").toInt(),
-            data.value("sourceID").toString(), data.value("stack").toString());
-    } else if (signalName == "javaScriptConfirmRequested") {
-        bool result = false; // Default response
-        // IMPORTANT: The actual logic for confirm() should be handled in WebPage, which then calls this.
-        // This 'emitJavaScriptConfirmRequested' will trigger WebPage::javaScriptConfirm.
-        emitJavaScriptConfirmRequested(data.value("message").toString(), &result);
-        QVariantMap responseParams;
-        responseParams["responseId"] = data.value("responseId").toString();
-        responseParams["result"] = result;
-        sendAsyncCommand("handleConfirmResponse", responseParams);
-    } else if (signalName == "javaScriptPromptRequested") {
-        QString resultString = "";
-        bool accepted = false;
-        // IMPORTANT: The actual logic for prompt() should be handled in WebPage.
-        emitJavaScriptPromptRequested(
-            data.value("message").toString(), data.value("defaultValue").toString(), &resultString, &accepted);
-        QVariantMap responseParams;
-        responseParams["responseId"] = data.value("responseId").toString();
-        responseParams["result"] = resultString;
-        responseParams["accepted"] = accepted; // Pass the accepted status back
-        sendAsyncCommand("handlePromptResponse", responseParams);
-    } else if (signalName == "javascriptInterruptRequested") {
-        bool interrupt = false;
-        emitJavascriptInterruptRequested(&interrupt);
-        QVariantMap responseParams;
-        responseParams["responseId"] = data.value("responseId").toString();
-        responseParams["interrupt"] = interrupt;
-        sendAsyncCommand("handleInterruptResponse", responseParams);
-    } else if (signalName == "filePickerRequested") {
-        QString chosenFile = "";
-        bool handled = false;
-        emitFilePickerRequested(data.value("oldFile").toString(), &chosenFile, &handled);
-        QVariantMap responseParams;
-        responseParams["responseId"] = data.value("responseId").toString();
-        responseParams["chosenFile"] = chosenFile;
-        responseParams["handled"] = handled;
-        sendAsyncCommand("handleFilePickerResponse", responseParams);
-    } else if (signalName == "resourceRequested") {
-        emitResourceRequested(data.value("requestData").toMap(), nullptr); // QObject* request can be modeled later
-    } else if (signalName == "resourceReceived") {
-        emitResourceReceived(data.value("responseData").toMap());
-    } else if (signalName == "resourceError") {
-        emitResourceError(data.value("errorData").toMap());
-    } else if (signalName == "resourceTimeout") {
-        emitResourceTimeout(data.value("errorData").toMap());
-    } else if (signalName == "repaintRequested") {
-        QVariantMap rectMap = data.value("rect").toMap();
-        emitRepaintRequested(QRect(rectMap.value("x").toInt(), rectMap.value("y").toInt(),
-            rectMap.value("width").toInt(), rectMap.value("height").toInt()));
-    } else if (signalName == "initialized") {
-        // This initial 'initialized' signal might be from the backend itself confirming startup
-        // The one in constructor is for the C++ side process initiation.
-        emitInitialized();
-    } else {
-        qWarning() << "PlaywrightEngineBackend: Unhandled signal from backend:" << signalName << data;
+        break;
+    case Event::JavaScriptAlertSent:
+        emitJavaScriptAlertSent(JavaScriptAlertSentEvent::fromJson(frame.data()).message);
+        break;
+    case Event::JavaScriptConsoleMessageSent:
+        emitJavaScriptConsoleMessageSent(JavaScriptConsoleMessageSentEvent::fromJson(frame.data()).message);
+        break;
+    case Event::JavaScriptErrorSent: {
+        const JavaScriptErrorSentEvent e = JavaScriptErrorSentEvent::fromJson(frame.data());
+        emitJavaScriptErrorSent(e.message, e.lineNumber, e.sourceID, e.stack);
+        break;
+    }
+    // Resource events are the bulk of the traffic; leave their payload undecoded unless someone is listening.
+    // Intercepted requests wait in the browser until they get a decision, so they always get one, listener or not.
+    case Event::ResourceRequested: {
+        const bool listening = isSignalConnected(QMetaMethod::fromSignal(&IEngineBackend::resourceRequested));
+        if (!listening && !m_requestInterception) {
+            break;
+        }
+        const QJsonObject payload = frame.data();
+        const bool intercepted = payload.value(QStringLiteral("intercepted")).toBool();
+        QVariantMap data = ResourceRequestedEvent::fromJson(payload).data;
+        data.remove(QStringLiteral("intercepted"));
+        if (!intercepted) {
+            if (listening) {
+                emitResourceRequested(data, nullptr);
+            }
+            break;
+        }
+        // Scripts may keep the object past the callback; deleted later, a call on it then fails in script instead
+        // of touching freed memory.
+        JsNetworkRequest* request = new JsNetworkRequest(data.value(QStringLiteral("id")).toLongLong(), this);
+        if (listening) {
+            emitResourceRequested(data, request);
+        }
+        m_requestDecisions.append(request->decision());
+        request->deleteLater();
+        break;
+    }
+    case Event::ResourceReceived:
+        if (isSignalConnected(QMetaMethod::fromSignal(&IEngineBackend::resourceReceived))) {
+            emitResourceReceived(ResourceReceivedEvent::fromJson(frame.data()).data);
+        }
+        break;
+    case Event::ResourceError:
+        if (isSignalConnected(QMetaMethod::fromSignal(&IEngineBackend::resourceError))) {
+            emitResourceError(ResourceErrorEvent::fromJson(frame.data()).data);
+        }
+        break;
+    case Event::ResourceTimeout:
+        if (isSignalConnected(QMetaMethod::fromSignal(&IEngineBackend::resourceTimeout))) {
+            emitResourceTimeout(ResourceTimeoutEvent::fromJson(frame.data()).data);
+        }
+        break;
+    case Event::RepaintRequested:
+        emitRepaintRequested(RepaintRequestedEvent::fromJson(frame.data()).rect);
+        break;
+    case Event::ScreencastFrame: {
+        const ScreencastFrameEvent e = ScreencastFrameEvent::fromJson(frame.data());
+        Q_EMIT screencastFrame(QByteArray::fromBase64(e.data.toLatin1()), e.timestamp);
+        break;
+    }
+    // Bodies stay base64 on this side: they are only ever handed back to a backend.
+    case Event::ResponseCacheLookup: {
+        const ResponseCacheLookupEvent e = ResponseCacheLookupEvent::fromJson(frame.data());
+        ResponseCacheLookupReply reply;
+        ResponseCache::Response response;
+        if (ResponseCache::instance()->lookup(e.url, e.headers, &response)) {
+            reply.found = true;
+            reply.status = response.status;
+            reply.headers = response.headers;
+            reply.body = QString::fromLatin1(response.body);
+        }
+        sendReply(requestId, reply);
+        break;
+    }
+    case Event::ResponseCacheStore: {
+        const ResponseCacheStoreEvent e = ResponseCacheStoreEvent::fromJson(frame.data());
+        ResponseCache::Response response;
+        response.status = e.status;
+        response.headers = e.headers;
+        response.body = e.body.toLatin1();
+        ResponseCache::instance()->store(e.url, e.vary, qint64(e.expires), response);
+        break;
+    }
+    case Event::PdfChunk: {
+        const PdfChunkEvent e = PdfChunkEvent::fromJson(frame.data());
+        auto stream = m_pdfStreams.find(e.streamId);
+        if (stream == m_pdfStreams.end() || stream->failed) {
+            break;
+        }
+        const QByteArray chunk = QByteArray::fromBase64(e.data.toLatin1());
+        if (stream->device->write(chunk) != chunk.size()) {
+            qWarning() << "PlaywrightEngineBackend: Could not write PDF chunk:" << stream->device->errorString();
+            stream->failed = true;
+            break;
+        }
+        stream->bytesWritten += chunk.size();
+        ++m_streamActivity;
+        Q_EMIT pdfProgress(stream->bytesWritten, e.eof);
+        break;
+    }
+    case Event::PdfPrinting:
+        ++m_streamActivity;
+        break;
+    case Event::PdfPartRendered: {
+        const PdfPartRenderedEvent e = PdfPartRenderedEvent::fromJson(frame.data());
+        qDebug() << "PlaywrightEngineBackend: PDF part" << e.index << "done," << e.pages << "page(s)";
+        ++m_streamActivity;
+        break;
+    }
+    case Event::TemplatePreparing: {
+        const TemplatePreparingEvent e = TemplatePreparingEvent::fromJson(frame.data());
+        qDebug() << "PlaywrightEngineBackend: Template copies ready:" << e.clones;
+        ++m_streamActivity;
+        break;
+    }
+    case Event::TemplateRendered: {
+        const TemplateRenderedEvent e = TemplateRenderedEvent::fromJson(frame.data());
+        if (!e.error.isEmpty()) {
+            qDebug() << "PlaywrightEngineBackend: Template job" << e.index << "failed:" << e.error;
+        }
+        ++m_streamActivity;
+        break;
+    }
+    case Event::JavaScriptConfirmRequested: {
+        JavaScriptConfirmRequestedReply reply;
+        emitJavaScriptConfirmRequested(JavaScriptConfirmRequestedEvent::fromJson(frame.data()).message, &reply.result);
+        sendReply(requestId, reply);
+        break;
+    }
+    case Event::JavaScriptPromptRequested: {
+        const JavaScriptPromptRequestedEvent e = JavaScriptPromptRequestedEvent::fromJson(frame.data());
+        JavaScriptPromptRequestedReply reply;
+        emitJavaScriptPromptRequested(e.message, e.defaultValue, &reply.result, &reply.accepted);
+        sendReply(requestId, reply);
+        break;
+    }
+    case Event::JavascriptInterruptRequested: {
+        JavascriptInterruptRequestedReply reply;
+        emitJavascriptInterruptRequested(&reply.interrupt);
+        sendReply(requestId, reply);
+        break;
+    }
+    case Event::FilePickerRequested: {
+        FilePickerRequestedReply reply;
+        emitFilePickerRequested(
+            FilePickerRequestedEvent::fromJson(frame.data()).oldFile, &reply.chosenFile, &reply.handled);
+        sendReply(requestId, reply);
+        break;
+    }
+    case Event::Pong: {
+        const PongEvent e = PongEvent::fromJson(frame.data());
+        m_missedHeartbeats = 0;
+        if (!e.browserConnected) {
+            markUnhealthy("browser disconnected");
+        }
+        break;
+    }
+    case Event::CallExposedQObjectMethod: {
+        const CallExposedQObjectMethodEvent e = CallExposedQObjectMethodEvent::fromJson(frame.data());
+        // Always answer so the page-side promise settles, even though the call is not routed yet.
+        qWarning() << "PlaywrightEngineBackend: Call to exposed method" << e.objectName + "." + e.methodName
+                   << "is not supported yet.";
+        sendReply(requestId, CallExposedQObjectMethodReply());
+        break;
+    }
+    default:
+        qWarning() << "PlaywrightEngineBackend: Unhandled event from backend:" << frame.event();
+        break;
     }
 }
 
-// Helper methods to emit signals (to simplify code in processSignal)
+// Helper methods to emit signals (to simplify code in processEvent)
 // Using Q_EMIT explicitly for clarity, though 'emit' macro usually suffices within QObject context
 void PlaywrightEngineBackend::emitLoadStarted(const QUrl& url) { Q_EMIT loadStarted(url); }
 void PlaywrightEngineBackend::emitLoadFinished(bool success, const QUrl& url) { Q_EMIT loadFinished(success, url); }
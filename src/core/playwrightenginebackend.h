@@ -2,18 +2,21 @@
 #define PLAYWRIGHTENGINEBACKEND_H
 
 #include "ienginebackend.h"
+#include "ipcframe.h"
+#include "playwrightprotocol.h"
 #include <QProcess>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <QQueue>
-#include <QMutex>
-#include <QWaitCondition>
-#include <QPair> // For QPair
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QElapsedTimer>
 #include <QNetworkRequest> // For QNetworkRequest, QNetworkAccessManager::Operation
 #include <QNetworkProxy> // For QNetworkProxy
 
 class CookieJar; // Forward declare
+class QTimer;
 
 class PlaywrightEngineBackend : public IEngineBackend {
     Q_OBJECT
@@ -29,8 +32,8 @@ public:
     QString toPlainText() const override;
     QString windowName() const override;
 
-    void load(
-        const QNetworkRequest& request, QNetworkAccessManager::Operation operation, const QByteArray& body) override;
+    void load(const QNetworkRequest& request, QNetworkAccessManager::Operation operation, const QByteArray& body,
+        const QVariantMap& waitUntil) override;
     void setHtml(const QString& html, const QUrl& baseUrl) override;
     void reload() override;
     void stop() override;
@@ -47,9 +50,23 @@ public:
     void setScrollPosition(const QPoint& pos) override;
     QPoint scrollPosition() const override;
     QByteArray renderPdf(const QVariantMap& paperSize, const QRect& clipRect) override;
+    bool renderPdfToDevice(const QVariantMap& paperSize, QIODevice* device) override;
+    QStringList renderPdfParts(
+        const QVariantMap& paperSize, int workers, int pagesPerPart, const QString& directory) override;
+    bool applyTemplateData(const QVariantMap& data, int timeout) override;
+    QStringList renderTemplateBatch(
+        const QVariantList& jobs, int workers, const QVariantMap& paperSize, int timeout) override;
     QByteArray renderImage(const QRect& clipRect, bool onlyViewport, const QPoint& scrollPosition) override;
+    QByteArray captureViewportFast(const QRect& clipRect, const QByteArray& format, int quality) override;
+    QImage captureFrame(const QRect& clipRect, bool onlyViewport, const QPoint& scrollPosition) override;
+    QList<QImage> captureViewports(const QList<QSize>& sizes, bool onlyViewport, int settleTime) override;
+    QList<QList<QRect>> elementRects(const QStringList& selectors, bool all) override;
     qreal zoomFactor() const override;
     void setZoomFactor(qreal zoom) override;
+    void setRepaintTracking(bool enabled) override;
+    QList<QRect> takeRepaints() override;
+    bool startScreencast(int fps, int quality, const QSize& maxSize) override;
+    void stopScreencast() override;
 
     QVariant evaluateJavaScript(const QString& code) override;
     bool injectJavaScriptFile(
@@ -63,6 +80,13 @@ public:
     bool navigationLocked() const override;
     QVariantMap customHeaders() const override;
     void setCustomHeaders(const QVariantMap& headers) override;
+    void setRequestFilter(const QVariantMap& tables) override;
+    void setRequestInterception(bool enabled, int deadline) override;
+    bool startNetworkRecording(const QString& fileName) override;
+    int stopNetworkRecording() override;
+    int setNetworkReplay(const QString& fileName, bool fallThrough) override;
+    bool startHar(const QString& fileName) override;
+    int stopHar() override;
     void applySettings(const QVariantMap& settings) override;
 
     void setNetworkProxy(const QNetworkProxy& proxy) override;
@@ -107,9 +131,22 @@ public:
 
     int showInspector(int port) override;
 
-    // These are *internal* methods specific to PlaywrightEngineBackend, not part of IEngineBackend
-    QVariant sendSyncCommand(const QString& command, const QVariantMap& params = QVariantMap());
-    void sendAsyncCommand(const QString& command, const QVariantMap& params = QVariantMap());
+    bool isHealthy() const override;
+
+    void requestShutdown(bool graceful) override;
+    bool waitForShutdown(int msecs) override;
+    void kill() override;
+
+    // Typed protocol commands (see src/engines/playwright_protocol.json). Sync commands block until the
+    // Node.js backend answers; async commands are fire-and-forget.
+    template <typename Command> QVariant sendSyncCommand(const Command& command) const {
+        static_assert(Command::isSync, "command is declared async in playwright_protocol.json");
+        return const_cast<PlaywrightEngineBackend*>(this)->sendCommand(Command::id, command.toJson(), true);
+    }
+    template <typename Command> void sendAsyncCommand(const Command& command) {
+        static_assert(!Command::isSync, "command is declared sync in playwright_protocol.json");
+        sendCommand(Command::id, command.toJson(), false);
+    }
 
 private slots:
     void handleReadyReadStandardOutput();
@@ -117,19 +154,57 @@ private slots:
     void handleProcessStarted();
     void handleProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
     void handleProcessErrorOccurred(QProcess::ProcessError error);
-    void processIncomingMessage(const QByteArray& message);
-    void processResponse(const QJsonObject& response);
-    void processSignal(const QJsonObject& signal);
+    void heartbeat();
+    void restartBackend();
 
 private:
+    void processIncomingMessage(const QByteArray& message);
+    void processResponse(const IpcFrame& response);
+    void processEvent(const IpcFrame& event);
+
     QProcess* m_playwrightProcess;
     QString m_playwrightScriptPath;
-    QQueue<QPair<quint64, QVariant>> m_pendingSyncCommands; // Stores request ID and response
-    QMutex m_mutex;
-    QWaitCondition m_commandWaitCondition;
+    CookieJar* m_cookieJar;
     quint64 m_nextRequestId;
     QHash<quint64, QVariant> m_syncResponses; // Map from request ID to response data
 
+    // Heartbeat: a ping every m_heartbeatInterval ms; m_heartbeatMisses unanswered pings mark the backend unhealthy.
+    QTimer* m_heartbeatTimer;
+    QElapsedTimer m_lastHeartbeat;
+    int m_heartbeatInterval;
+    int m_heartbeatMisses;
+    int m_missedHeartbeats;
+    int m_heartbeatSeq;
+    bool m_healthy;
+
+    // Failover: a dead backend is respawned up to m_maxRestarts times. Commands that define page state are kept
+    // (last value wins, keyed by command and an optional name) so they can be replayed to the new process, in the
+    // order they were last issued.
+    int m_maxRestarts;
+    int m_restartCount;
+    bool m_restarting;
+    struct ReplayEntry {
+        quint64 sequence;
+        PlaywrightProtocol::Command command;
+        QJsonObject params;
+    };
+    QMap<QPair<int, QString>, ReplayEntry> m_replayLog;
+    quint64 m_replaySequence;
+    PlaywrightProtocol::LoadCommand m_lastLoad; // Headers and load strategy are replayed with the current URL
+    QList<QJsonObject> m_replayInjections; // injectJavaScriptFile commands since the last navigation
+
+    // PDFs being streamed by renderPdfToDevice, keyed by the stream id their pdfChunk events carry
+    struct PdfStream {
+        QIODevice* device;
+        qint64 bytesWritten;
+        bool failed;
+    };
+    int m_nextPdfStreamId;
+    QHash<int, PdfStream> m_pdfStreams;
+    bool m_requestInterception;
+    QVariantList m_requestDecisions; // For intercepted requests, sent as one batch per read of the backend's output
+    quint64 m_streamActivity; // Bumped per chunk, part or template job; keeps sync waits for long output alive
+
     // Cached properties (these will be updated by messages from Playwright)
     mutable QUrl m_currentUrl;
     mutable QString m_currentTitle;
@@ -153,7 +228,22 @@ private:
     mutable QString m_currentFocusedFrameName;
     mutable QVariantList m_currentCookies;
 
-    void sendCommand(const QString& command, const QVariantMap& params, bool isSync);
+    QVariant sendCommand(PlaywrightProtocol::Command command, const QJsonObject& params, bool isSync);
+    template <typename Reply> void sendReply(quint64 requestId, const Reply& reply) {
+        sendReply(requestId, reply.toJson());
+    }
+    void sendReply(quint64 requestId, const QJsonObject& result);
+    bool writeMessage(const QJsonObject& message);
+    bool takeMessage(QByteArray* message);
+    bool heartbeatDue() const;
+    void startBackendProcess();
+    void replayState();
+    void flushRequestDecisions();
+    template <typename Command> void recordForReplay(const Command& command, const QString& key = QString()) {
+        const ReplayEntry entry { ++m_replaySequence, Command::id, command.toJson() };
+        m_replayLog.insert(qMakePair(static_cast<int>(Command::id), key), entry);
+    }
+    void markUnhealthy(const QString& reason);
     // Helper to emit signals from Playwright backend (these are not slots, just internal helpers)
     void emitLoadStarted(const QUrl& url);
     void emitLoadFinished(bool success, const QUrl& url);
@@ -180,8 +270,6 @@ private:
     void emitRepaintRequested(const QRect& dirtyRect);
     void emitInitialized();
 
-    // Internal helper for JSON parsing
-    QJsonParseError m_jsonParseError;
     QByteArray m_readBuffer;
 };
 
@@ -0,0 +1,1867 @@
+// Generated by tools/generate-protocol.py from src/engines/playwright_protocol.json. Do not edit.
+
+#ifndef PLAYWRIGHTPROTOCOL_H
+#define PLAYWRIGHTPROTOCOL_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QVariant>
+#include <QVariantList>
+#include <QVariantMap>
+
+namespace PlaywrightProtocol {
+
+const int Version = 1;
+
+enum class Command : int {
+    Init = 0,
+    Shutdown = 1,
+    GetUrl = 2,
+    GetTitle = 3,
+    GetHtml = 4,
+    GetPlainText = 5,
+    GetWindowName = 6,
+    Load = 7,
+    SetHtml = 8,
+    Reload = 9,
+    Stop = 10,
+    CanGoBack = 11,
+    GoBack = 12,
+    CanGoForward = 13,
+    GoForward = 14,
+    GoToHistoryItem = 15,
+    SetViewportSize = 16,
+    GetViewportSize = 17,
+    SetClipRect = 18,
+    GetClipRect = 19,
+    SetScrollPosition = 20,
+    GetScrollPosition = 21,
+    RenderImage = 22,
+    RenderPdf = 23,
+    GetZoomFactor = 24,
+    SetZoomFactor = 25,
+    EvaluateJavaScript = 26,
+    InjectJavaScriptFile = 27,
+    ExposeQObject = 28,
+    AppendScriptElement = 29,
+    GetUserAgent = 30,
+    SetUserAgent = 31,
+    SetNavigationLocked = 32,
+    GetNavigationLocked = 33,
+    GetCustomHeaders = 34,
+    SetCustomHeaders = 35,
+    SetJavaScriptEnabled = 36,
+    SetWebSecurityEnabled = 37,
+    SetWebGLEnabled = 38,
+    SetJavaScriptCanOpenWindows = 39,
+    SetJavaScriptCanCloseWindows = 40,
+    SetLocalToRemoteUrlAccessEnabled = 41,
+    SetAutoLoadImages = 42,
+    SetNetworkProxy = 43,
+    SetDiskCacheEnabled = 44,
+    SetMaxDiskCacheSize = 45,
+    SetDiskCachePath = 46,
+    SetIgnoreSslErrors = 47,
+    SetSslProtocol = 48,
+    SetSslCiphers = 49,
+    SetSslCertificatesPath = 50,
+    SetSslClientCertificateFile = 51,
+    SetSslClientKeyFile = 52,
+    SetSslClientKeyPassphrase = 53,
+    SetResourceTimeout = 54,
+    SetMaxAuthAttempts = 55,
+    SetLocalStoragePath = 56,
+    GetLocalStorageQuota = 57,
+    SetOfflineStoragePath = 58,
+    GetOfflineStorageQuota = 59,
+    ClearMemoryCache = 60,
+    SetCookies = 61,
+    GetCookies = 62,
+    AddCookie = 63,
+    DeleteCookie = 64,
+    ClearCookies = 65,
+    GetFramesCount = 66,
+    GetFramesName = 67,
+    SwitchToFrameByName = 68,
+    SwitchToFrameByPosition = 69,
+    GetFrameName = 70,
+    SwitchToMainFrame = 71,
+    SwitchToParentFrame = 72,
+    SwitchToFocusedFrame = 73,
+    GetFocusedFrameName = 74,
+    SendEvent = 75,
+    UploadFile = 76,
+    ShowInspector = 77,
+    Ping = 78,
+    SetRepaintTracking = 79,
+    TakeRepaints = 80,
+    RenderViewports = 81,
+    GetElementRects = 82,
+    RenderPdfStream = 83,
+    RenderPdfParts = 84,
+    ApplyTemplateData = 85,
+    RenderTemplateBatch = 86,
+    CaptureViewportFast = 87,
+    StartScreencast = 88,
+    StopScreencast = 89,
+    SetRequestFilter = 90,
+    SetRequestInterception = 91,
+    ResolveRequests = 92,
+    SetResponseCacheEnabled = 93,
+    StartNetworkRecording = 94,
+    StopNetworkRecording = 95,
+    SetNetworkReplay = 96,
+    StartHar = 97,
+    StopHar = 98,
+    Count
+};
+
+enum class Event : int {
+    Initialized = 0,
+    LoadStarted = 1,
+    LoadFinished = 2,
+    LoadingProgress = 3,
+    UrlChanged = 4,
+    TitleChanged = 5,
+    ContentsChanged = 6,
+    NavigationRequested = 7,
+    PageCreated = 8,
+    WindowCloseRequested = 9,
+    JavaScriptAlertSent = 10,
+    JavaScriptConsoleMessageSent = 11,
+    JavaScriptErrorSent = 12,
+    ResourceRequested = 13,
+    ResourceReceived = 14,
+    ResourceError = 15,
+    ResourceTimeout = 16,
+    RepaintRequested = 17,
+    JavaScriptConfirmRequested = 18,
+    JavaScriptPromptRequested = 19,
+    JavascriptInterruptRequested = 20,
+    FilePickerRequested = 21,
+    CallExposedQObjectMethod = 22,
+    Pong = 23,
+    PdfChunk = 24,
+    PdfPrinting = 25,
+    PdfPartRendered = 26,
+    TemplatePreparing = 27,
+    TemplateRendered = 28,
+    ScreencastFrame = 29,
+    ResponseCacheLookup = 30,
+    ResponseCacheStore = 31,
+    Count
+};
+
+inline const char* commandName(Command value) {
+    static const char* const names[] = {
+        "init",
+        "shutdown",
+        "getUrl",
+        "getTitle",
+        "getHtml",
+        "getPlainText",
+        "getWindowName",
+        "load",
+        "setHtml",
+        "reload",
+        "stop",
+        "canGoBack",
+        "goBack",
+        "canGoForward",
+        "goForward",
+        "goToHistoryItem",
+        "setViewportSize",
+        "getViewportSize",
+        "setClipRect",
+        "getClipRect",
+        "setScrollPosition",
+        "getScrollPosition",
+        "renderImage",
+        "renderPdf",
+        "getZoomFactor",
+        "setZoomFactor",
+        "evaluateJavaScript",
+        "injectJavaScriptFile",
+        "exposeQObject",
+        "appendScriptElement",
+        "getUserAgent",
+        "setUserAgent",
+        "setNavigationLocked",
+        "getNavigationLocked",
+        "getCustomHeaders",
+        "setCustomHeaders",
+        "setJavaScriptEnabled",
+        "setWebSecurityEnabled",
+        "setWebGLEnabled",
+        "setJavaScriptCanOpenWindows",
+        "setJavaScriptCanCloseWindows",
+        "setLocalToRemoteUrlAccessEnabled",
+        "setAutoLoadImages",
+        "setNetworkProxy",
+        "setDiskCacheEnabled",
+        "setMaxDiskCacheSize",
+        "setDiskCachePath",
+        "setIgnoreSslErrors",
+        "setSslProtocol",
+        "setSslCiphers",
+        "setSslCertificatesPath",
+        "setSslClientCertificateFile",
+        "setSslClientKeyFile",
+        "setSslClientKeyPassphrase",
+        "setResourceTimeout",
+        "setMaxAuthAttempts",
+        "setLocalStoragePath",
+        "getLocalStorageQuota",
+        "setOfflineStoragePath",
+        "getOfflineStorageQuota",
+        "clearMemoryCache",
+        "setCookies",
+        "getCookies",
+        "addCookie",
+        "deleteCookie",
+        "clearCookies",
+        "getFramesCount",
+        "getFramesName",
+        "switchToFrameByName",
+        "switchToFrameByPosition",
+        "getFrameName",
+        "switchToMainFrame",
+        "switchToParentFrame",
+        "switchToFocusedFrame",
+        "getFocusedFrameName",
+        "sendEvent",
+        "uploadFile",
+        "showInspector",
+        "ping",
+        "setRepaintTracking",
+        "takeRepaints",
+        "renderViewports",
+        "getElementRects",
+        "renderPdfStream",
+        "renderPdfParts",
+        "applyTemplateData",
+        "renderTemplateBatch",
+        "captureViewportFast",
+        "startScreencast",
+        "stopScreencast",
+        "setRequestFilter",
+        "setRequestInterception",
+        "resolveRequests",
+        "setResponseCacheEnabled",
+        "startNetworkRecording",
+        "stopNetworkRecording",
+        "setNetworkReplay",
+        "startHar",
+        "stopHar",
+    };
+    const int index = static_cast<int>(value);
+    return index >= 0 && index < static_cast<int>(Command::Count) ? names[index] : "<unknown>";
+}
+
+inline const char* eventName(Event value) {
+    static const char* const names[] = {
+        "initialized",
+        "loadStarted",
+        "loadFinished",
+        "loadingProgress",
+        "urlChanged",
+        "titleChanged",
+        "contentsChanged",
+        "navigationRequested",
+        "pageCreated",
+        "windowCloseRequested",
+        "javaScriptAlertSent",
+        "javaScriptConsoleMessageSent",
+        "javaScriptErrorSent",
+        "resourceRequested",
+        "resourceReceived",
+        "resourceError",
+        "resourceTimeout",
+        "repaintRequested",
+        "javaScriptConfirmRequested",
+        "javaScriptPromptRequested",
+        "javascriptInterruptRequested",
+        "filePickerRequested",
+        "callExposedQObjectMethod",
+        "pong",
+        "pdfChunk",
+        "pdfPrinting",
+        "pdfPartRendered",
+        "templatePreparing",
+        "templateRendered",
+        "screencastFrame",
+        "responseCacheLookup",
+        "responseCacheStore",
+    };
+    const int index = static_cast<int>(value);
+    return index >= 0 && index < static_cast<int>(Event::Count) ? names[index] : "<unknown>";
+}
+
+inline QJsonObject rectToJson(const QRect& r) {
+    return QJsonObject { { QStringLiteral("x"), r.x() }, { QStringLiteral("y"), r.y() },
+        { QStringLiteral("width"), r.width() }, { QStringLiteral("height"), r.height() } };
+}
+inline QRect rectFromJson(const QJsonValue& v) {
+    const QJsonObject o = v.toObject();
+    return QRect(o.value(QStringLiteral("x")).toInt(), o.value(QStringLiteral("y")).toInt(),
+        o.value(QStringLiteral("width")).toInt(), o.value(QStringLiteral("height")).toInt());
+}
+inline QJsonObject pointToJson(const QPoint& p) {
+    return QJsonObject { { QStringLiteral("x"), p.x() }, { QStringLiteral("y"), p.y() } };
+}
+inline QPoint pointFromJson(const QJsonValue& v) {
+    const QJsonObject o = v.toObject();
+    return QPoint(o.value(QStringLiteral("x")).toInt(), o.value(QStringLiteral("y")).toInt());
+}
+inline QStringList stringListFromJson(const QJsonValue& v) {
+    QStringList list;
+    for (const QJsonValue& item : v.toArray()) {
+        list.append(item.toString());
+    }
+    return list;
+}
+
+// --- Commands (C++ -> Node) ---
+
+struct InitCommand {
+    static constexpr Command id = Command::Init;
+    static constexpr bool isSync = false;
+    int protocolVersion = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("protocolVersion"), protocolVersion);
+        return o;
+    }
+};
+
+struct ShutdownCommand {
+    static constexpr Command id = Command::Shutdown;
+    static constexpr bool isSync = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct GetUrlCommand {
+    static constexpr Command id = Command::GetUrl;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct GetTitleCommand {
+    static constexpr Command id = Command::GetTitle;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct GetHtmlCommand {
+    static constexpr Command id = Command::GetHtml;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct GetPlainTextCommand {
+    static constexpr Command id = Command::GetPlainText;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct GetWindowNameCommand {
+    static constexpr Command id = Command::GetWindowName;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct LoadCommand {
+    static constexpr Command id = Command::Load;
+    static constexpr bool isSync = false;
+    QString url;
+    QString method;
+    QString body;
+    QVariantMap headers;
+    QVariantMap waitUntil;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("url"), url);
+        o.insert(QStringLiteral("method"), method);
+        o.insert(QStringLiteral("body"), body);
+        o.insert(QStringLiteral("headers"), QJsonObject::fromVariantMap(headers));
+        o.insert(QStringLiteral("waitUntil"), QJsonObject::fromVariantMap(waitUntil));
+        return o;
+    }
+};
+
+struct SetHtmlCommand {
+    static constexpr Command id = Command::SetHtml;
+    static constexpr bool isSync = false;
+    QString html;
+    QString baseUrl;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("html"), html);
+        o.insert(QStringLiteral("baseUrl"), baseUrl);
+        return o;
+    }
+};
+
+struct ReloadCommand {
+    static constexpr Command id = Command::Reload;
+    static constexpr bool isSync = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct StopCommand {
+    static constexpr Command id = Command::Stop;
+    static constexpr bool isSync = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct CanGoBackCommand {
+    static constexpr Command id = Command::CanGoBack;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct GoBackCommand {
+    static constexpr Command id = Command::GoBack;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct CanGoForwardCommand {
+    static constexpr Command id = Command::CanGoForward;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct GoForwardCommand {
+    static constexpr Command id = Command::GoForward;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct GoToHistoryItemCommand {
+    static constexpr Command id = Command::GoToHistoryItem;
+    static constexpr bool isSync = true;
+    int relativeIndex = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("relativeIndex"), relativeIndex);
+        return o;
+    }
+};
+
+struct SetViewportSizeCommand {
+    static constexpr Command id = Command::SetViewportSize;
+    static constexpr bool isSync = false;
+    int width = 0;
+    int height = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("width"), width);
+        o.insert(QStringLiteral("height"), height);
+        return o;
+    }
+};
+
+struct GetViewportSizeCommand {
+    static constexpr Command id = Command::GetViewportSize;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SetClipRectCommand {
+    static constexpr Command id = Command::SetClipRect;
+    static constexpr bool isSync = false;
+    QRect clipRect;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("clipRect"), rectToJson(clipRect));
+        return o;
+    }
+};
+
+struct GetClipRectCommand {
+    static constexpr Command id = Command::GetClipRect;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SetScrollPositionCommand {
+    static constexpr Command id = Command::SetScrollPosition;
+    static constexpr bool isSync = false;
+    int x = 0;
+    int y = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("x"), x);
+        o.insert(QStringLiteral("y"), y);
+        return o;
+    }
+};
+
+struct GetScrollPositionCommand {
+    static constexpr Command id = Command::GetScrollPosition;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct RenderImageCommand {
+    static constexpr Command id = Command::RenderImage;
+    static constexpr bool isSync = true;
+    QString format;
+    QRect clipRect;
+    bool onlyViewport = false;
+    QPoint scrollPosition;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("format"), format);
+        o.insert(QStringLiteral("clipRect"), rectToJson(clipRect));
+        o.insert(QStringLiteral("onlyViewport"), onlyViewport);
+        o.insert(QStringLiteral("scrollPosition"), pointToJson(scrollPosition));
+        return o;
+    }
+};
+
+struct RenderPdfCommand {
+    static constexpr Command id = Command::RenderPdf;
+    static constexpr bool isSync = true;
+    QVariantMap paperSize;
+    QRect clipRect;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("paperSize"), QJsonObject::fromVariantMap(paperSize));
+        o.insert(QStringLiteral("clipRect"), rectToJson(clipRect));
+        return o;
+    }
+};
+
+struct GetZoomFactorCommand {
+    static constexpr Command id = Command::GetZoomFactor;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SetZoomFactorCommand {
+    static constexpr Command id = Command::SetZoomFactor;
+    static constexpr bool isSync = false;
+    double zoom = 0.0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("zoom"), zoom);
+        return o;
+    }
+};
+
+struct EvaluateJavaScriptCommand {
+    static constexpr Command id = Command::EvaluateJavaScript;
+    static constexpr bool isSync = true;
+    QString code;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("code"), code);
+        return o;
+    }
+};
+
+struct InjectJavaScriptFileCommand {
+    static constexpr Command id = Command::InjectJavaScriptFile;
+    static constexpr bool isSync = true;
+    QString path;
+    QString encoding;
+    QString libraryPath;
+    bool forEachFrame = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("path"), path);
+        o.insert(QStringLiteral("encoding"), encoding);
+        o.insert(QStringLiteral("libraryPath"), libraryPath);
+        o.insert(QStringLiteral("forEachFrame"), forEachFrame);
+        return o;
+    }
+};
+
+struct ExposeQObjectCommand {
+    static constexpr Command id = Command::ExposeQObject;
+    static constexpr bool isSync = false;
+    QString name;
+    QStringList methods;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("name"), name);
+        o.insert(QStringLiteral("methods"), QJsonArray::fromStringList(methods));
+        return o;
+    }
+};
+
+struct AppendScriptElementCommand {
+    static constexpr Command id = Command::AppendScriptElement;
+    static constexpr bool isSync = false;
+    QString url;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("url"), url);
+        return o;
+    }
+};
+
+struct GetUserAgentCommand {
+    static constexpr Command id = Command::GetUserAgent;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SetUserAgentCommand {
+    static constexpr Command id = Command::SetUserAgent;
+    static constexpr bool isSync = false;
+    QString userAgent;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("userAgent"), userAgent);
+        return o;
+    }
+};
+
+struct SetNavigationLockedCommand {
+    static constexpr Command id = Command::SetNavigationLocked;
+    static constexpr bool isSync = false;
+    bool locked = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("locked"), locked);
+        return o;
+    }
+};
+
+struct GetNavigationLockedCommand {
+    static constexpr Command id = Command::GetNavigationLocked;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct GetCustomHeadersCommand {
+    static constexpr Command id = Command::GetCustomHeaders;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SetCustomHeadersCommand {
+    static constexpr Command id = Command::SetCustomHeaders;
+    static constexpr bool isSync = false;
+    QVariantMap headers;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("headers"), QJsonObject::fromVariantMap(headers));
+        return o;
+    }
+};
+
+struct SetJavaScriptEnabledCommand {
+    static constexpr Command id = Command::SetJavaScriptEnabled;
+    static constexpr bool isSync = false;
+    bool enabled = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("enabled"), enabled);
+        return o;
+    }
+};
+
+struct SetWebSecurityEnabledCommand {
+    static constexpr Command id = Command::SetWebSecurityEnabled;
+    static constexpr bool isSync = false;
+    bool enabled = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("enabled"), enabled);
+        return o;
+    }
+};
+
+struct SetWebGLEnabledCommand {
+    static constexpr Command id = Command::SetWebGLEnabled;
+    static constexpr bool isSync = false;
+    bool enabled = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("enabled"), enabled);
+        return o;
+    }
+};
+
+struct SetJavaScriptCanOpenWindowsCommand {
+    static constexpr Command id = Command::SetJavaScriptCanOpenWindows;
+    static constexpr bool isSync = false;
+    bool enabled = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("enabled"), enabled);
+        return o;
+    }
+};
+
+struct SetJavaScriptCanCloseWindowsCommand {
+    static constexpr Command id = Command::SetJavaScriptCanCloseWindows;
+    static constexpr bool isSync = false;
+    bool enabled = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("enabled"), enabled);
+        return o;
+    }
+};
+
+struct SetLocalToRemoteUrlAccessEnabledCommand {
+    static constexpr Command id = Command::SetLocalToRemoteUrlAccessEnabled;
+    static constexpr bool isSync = false;
+    bool enabled = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("enabled"), enabled);
+        return o;
+    }
+};
+
+struct SetAutoLoadImagesCommand {
+    static constexpr Command id = Command::SetAutoLoadImages;
+    static constexpr bool isSync = false;
+    bool enabled = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("enabled"), enabled);
+        return o;
+    }
+};
+
+struct SetNetworkProxyCommand {
+    static constexpr Command id = Command::SetNetworkProxy;
+    static constexpr bool isSync = false;
+    QString type;
+    QString host;
+    int port = 0;
+    QString user;
+    QString password;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("type"), type);
+        o.insert(QStringLiteral("host"), host);
+        o.insert(QStringLiteral("port"), port);
+        o.insert(QStringLiteral("user"), user);
+        o.insert(QStringLiteral("password"), password);
+        return o;
+    }
+};
+
+struct SetDiskCacheEnabledCommand {
+    static constexpr Command id = Command::SetDiskCacheEnabled;
+    static constexpr bool isSync = false;
+    bool enabled = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("enabled"), enabled);
+        return o;
+    }
+};
+
+struct SetMaxDiskCacheSizeCommand {
+    static constexpr Command id = Command::SetMaxDiskCacheSize;
+    static constexpr bool isSync = false;
+    int size = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("size"), size);
+        return o;
+    }
+};
+
+struct SetDiskCachePathCommand {
+    static constexpr Command id = Command::SetDiskCachePath;
+    static constexpr bool isSync = false;
+    QString path;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("path"), path);
+        return o;
+    }
+};
+
+struct SetIgnoreSslErrorsCommand {
+    static constexpr Command id = Command::SetIgnoreSslErrors;
+    static constexpr bool isSync = false;
+    bool ignore = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("ignore"), ignore);
+        return o;
+    }
+};
+
+struct SetSslProtocolCommand {
+    static constexpr Command id = Command::SetSslProtocol;
+    static constexpr bool isSync = false;
+    QString protocol;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("protocol"), protocol);
+        return o;
+    }
+};
+
+struct SetSslCiphersCommand {
+    static constexpr Command id = Command::SetSslCiphers;
+    static constexpr bool isSync = false;
+    QString ciphers;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("ciphers"), ciphers);
+        return o;
+    }
+};
+
+struct SetSslCertificatesPathCommand {
+    static constexpr Command id = Command::SetSslCertificatesPath;
+    static constexpr bool isSync = false;
+    QString path;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("path"), path);
+        return o;
+    }
+};
+
+struct SetSslClientCertificateFileCommand {
+    static constexpr Command id = Command::SetSslClientCertificateFile;
+    static constexpr bool isSync = false;
+    QString file;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("file"), file);
+        return o;
+    }
+};
+
+struct SetSslClientKeyFileCommand {
+    static constexpr Command id = Command::SetSslClientKeyFile;
+    static constexpr bool isSync = false;
+    QString file;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("file"), file);
+        return o;
+    }
+};
+
+struct SetSslClientKeyPassphraseCommand {
+    static constexpr Command id = Command::SetSslClientKeyPassphrase;
+    static constexpr bool isSync = false;
+    QString passphrase;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("passphrase"), passphrase);
+        return o;
+    }
+};
+
+struct SetResourceTimeoutCommand {
+    static constexpr Command id = Command::SetResourceTimeout;
+    static constexpr bool isSync = false;
+    int timeout = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("timeout"), timeout);
+        return o;
+    }
+};
+
+struct SetMaxAuthAttemptsCommand {
+    static constexpr Command id = Command::SetMaxAuthAttempts;
+    static constexpr bool isSync = false;
+    int attempts = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("attempts"), attempts);
+        return o;
+    }
+};
+
+struct SetLocalStoragePathCommand {
+    static constexpr Command id = Command::SetLocalStoragePath;
+    static constexpr bool isSync = false;
+    QString path;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("path"), path);
+        return o;
+    }
+};
+
+struct GetLocalStorageQuotaCommand {
+    static constexpr Command id = Command::GetLocalStorageQuota;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SetOfflineStoragePathCommand {
+    static constexpr Command id = Command::SetOfflineStoragePath;
+    static constexpr bool isSync = false;
+    QString path;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("path"), path);
+        return o;
+    }
+};
+
+struct GetOfflineStorageQuotaCommand {
+    static constexpr Command id = Command::GetOfflineStorageQuota;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct ClearMemoryCacheCommand {
+    static constexpr Command id = Command::ClearMemoryCache;
+    static constexpr bool isSync = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SetCookiesCommand {
+    static constexpr Command id = Command::SetCookies;
+    static constexpr bool isSync = true;
+    QVariantList cookies;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("cookies"), QJsonArray::fromVariantList(cookies));
+        return o;
+    }
+};
+
+struct GetCookiesCommand {
+    static constexpr Command id = Command::GetCookies;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct AddCookieCommand {
+    static constexpr Command id = Command::AddCookie;
+    static constexpr bool isSync = true;
+    QVariantMap cookie;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("cookie"), QJsonObject::fromVariantMap(cookie));
+        return o;
+    }
+};
+
+struct DeleteCookieCommand {
+    static constexpr Command id = Command::DeleteCookie;
+    static constexpr bool isSync = true;
+    QString name;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("name"), name);
+        return o;
+    }
+};
+
+struct ClearCookiesCommand {
+    static constexpr Command id = Command::ClearCookies;
+    static constexpr bool isSync = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct GetFramesCountCommand {
+    static constexpr Command id = Command::GetFramesCount;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct GetFramesNameCommand {
+    static constexpr Command id = Command::GetFramesName;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SwitchToFrameByNameCommand {
+    static constexpr Command id = Command::SwitchToFrameByName;
+    static constexpr bool isSync = true;
+    QString name;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("name"), name);
+        return o;
+    }
+};
+
+struct SwitchToFrameByPositionCommand {
+    static constexpr Command id = Command::SwitchToFrameByPosition;
+    static constexpr bool isSync = true;
+    int position = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("position"), position);
+        return o;
+    }
+};
+
+struct GetFrameNameCommand {
+    static constexpr Command id = Command::GetFrameName;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SwitchToMainFrameCommand {
+    static constexpr Command id = Command::SwitchToMainFrame;
+    static constexpr bool isSync = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SwitchToParentFrameCommand {
+    static constexpr Command id = Command::SwitchToParentFrame;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SwitchToFocusedFrameCommand {
+    static constexpr Command id = Command::SwitchToFocusedFrame;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct GetFocusedFrameNameCommand {
+    static constexpr Command id = Command::GetFocusedFrameName;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SendEventCommand {
+    static constexpr Command id = Command::SendEvent;
+    static constexpr bool isSync = false;
+    QString type;
+    QVariant arg1;
+    QVariant arg2;
+    QString mouseButton;
+    QVariant modifierArg;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("type"), type);
+        o.insert(QStringLiteral("arg1"), QJsonValue::fromVariant(arg1));
+        o.insert(QStringLiteral("arg2"), QJsonValue::fromVariant(arg2));
+        o.insert(QStringLiteral("mouseButton"), mouseButton);
+        o.insert(QStringLiteral("modifierArg"), QJsonValue::fromVariant(modifierArg));
+        return o;
+    }
+};
+
+struct UploadFileCommand {
+    static constexpr Command id = Command::UploadFile;
+    static constexpr bool isSync = false;
+    QString selector;
+    QStringList fileNames;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("selector"), selector);
+        o.insert(QStringLiteral("fileNames"), QJsonArray::fromStringList(fileNames));
+        return o;
+    }
+};
+
+struct ShowInspectorCommand {
+    static constexpr Command id = Command::ShowInspector;
+    static constexpr bool isSync = true;
+    int port = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("port"), port);
+        return o;
+    }
+};
+
+struct PingCommand {
+    static constexpr Command id = Command::Ping;
+    static constexpr bool isSync = false;
+    int seq = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("seq"), seq);
+        return o;
+    }
+};
+
+struct SetRepaintTrackingCommand {
+    static constexpr Command id = Command::SetRepaintTracking;
+    static constexpr bool isSync = false;
+    bool enabled = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("enabled"), enabled);
+        return o;
+    }
+};
+
+struct TakeRepaintsCommand {
+    static constexpr Command id = Command::TakeRepaints;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct RenderViewportsCommand {
+    static constexpr Command id = Command::RenderViewports;
+    static constexpr bool isSync = true;
+    QVariantList viewports;
+    bool onlyViewport = false;
+    int settleTime = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("viewports"), QJsonArray::fromVariantList(viewports));
+        o.insert(QStringLiteral("onlyViewport"), onlyViewport);
+        o.insert(QStringLiteral("settleTime"), settleTime);
+        return o;
+    }
+};
+
+struct GetElementRectsCommand {
+    static constexpr Command id = Command::GetElementRects;
+    static constexpr bool isSync = true;
+    QVariantList selectors;
+    bool all = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("selectors"), QJsonArray::fromVariantList(selectors));
+        o.insert(QStringLiteral("all"), all);
+        return o;
+    }
+};
+
+struct RenderPdfStreamCommand {
+    static constexpr Command id = Command::RenderPdfStream;
+    static constexpr bool isSync = true;
+    QVariantMap paperSize;
+    int streamId = 0;
+    int chunkSize = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("paperSize"), QJsonObject::fromVariantMap(paperSize));
+        o.insert(QStringLiteral("streamId"), streamId);
+        o.insert(QStringLiteral("chunkSize"), chunkSize);
+        return o;
+    }
+};
+
+struct RenderPdfPartsCommand {
+    static constexpr Command id = Command::RenderPdfParts;
+    static constexpr bool isSync = true;
+    QVariantMap paperSize;
+    int workers = 0;
+    int pagesPerPart = 0;
+    QString directory;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("paperSize"), QJsonObject::fromVariantMap(paperSize));
+        o.insert(QStringLiteral("workers"), workers);
+        o.insert(QStringLiteral("pagesPerPart"), pagesPerPart);
+        o.insert(QStringLiteral("directory"), directory);
+        return o;
+    }
+};
+
+struct ApplyTemplateDataCommand {
+    static constexpr Command id = Command::ApplyTemplateData;
+    static constexpr bool isSync = true;
+    QVariantMap data;
+    int timeout = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("data"), QJsonObject::fromVariantMap(data));
+        o.insert(QStringLiteral("timeout"), timeout);
+        return o;
+    }
+};
+
+struct RenderTemplateBatchCommand {
+    static constexpr Command id = Command::RenderTemplateBatch;
+    static constexpr bool isSync = true;
+    QVariantList jobs;
+    int workers = 0;
+    QVariantMap paperSize;
+    int timeout = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("jobs"), QJsonArray::fromVariantList(jobs));
+        o.insert(QStringLiteral("workers"), workers);
+        o.insert(QStringLiteral("paperSize"), QJsonObject::fromVariantMap(paperSize));
+        o.insert(QStringLiteral("timeout"), timeout);
+        return o;
+    }
+};
+
+struct CaptureViewportFastCommand {
+    static constexpr Command id = Command::CaptureViewportFast;
+    static constexpr bool isSync = true;
+    QString format;
+    int quality = 0;
+    QRect clipRect;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("format"), format);
+        o.insert(QStringLiteral("quality"), quality);
+        o.insert(QStringLiteral("clipRect"), rectToJson(clipRect));
+        return o;
+    }
+};
+
+struct StartScreencastCommand {
+    static constexpr Command id = Command::StartScreencast;
+    static constexpr bool isSync = true;
+    int fps = 0;
+    int quality = 0;
+    int maxWidth = 0;
+    int maxHeight = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("fps"), fps);
+        o.insert(QStringLiteral("quality"), quality);
+        o.insert(QStringLiteral("maxWidth"), maxWidth);
+        o.insert(QStringLiteral("maxHeight"), maxHeight);
+        return o;
+    }
+};
+
+struct StopScreencastCommand {
+    static constexpr Command id = Command::StopScreencast;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SetRequestFilterCommand {
+    static constexpr Command id = Command::SetRequestFilter;
+    static constexpr bool isSync = false;
+    QVariantMap tables;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("tables"), QJsonObject::fromVariantMap(tables));
+        return o;
+    }
+};
+
+struct SetRequestInterceptionCommand {
+    static constexpr Command id = Command::SetRequestInterception;
+    static constexpr bool isSync = false;
+    bool enabled = false;
+    int deadline = 0;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("enabled"), enabled);
+        o.insert(QStringLiteral("deadline"), deadline);
+        return o;
+    }
+};
+
+struct ResolveRequestsCommand {
+    static constexpr Command id = Command::ResolveRequests;
+    static constexpr bool isSync = false;
+    QVariantList decisions;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("decisions"), QJsonArray::fromVariantList(decisions));
+        return o;
+    }
+};
+
+struct SetResponseCacheEnabledCommand {
+    static constexpr Command id = Command::SetResponseCacheEnabled;
+    static constexpr bool isSync = false;
+    bool enabled = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("enabled"), enabled);
+        return o;
+    }
+};
+
+struct StartNetworkRecordingCommand {
+    static constexpr Command id = Command::StartNetworkRecording;
+    static constexpr bool isSync = true;
+    QString file;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("file"), file);
+        return o;
+    }
+};
+
+struct StopNetworkRecordingCommand {
+    static constexpr Command id = Command::StopNetworkRecording;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+struct SetNetworkReplayCommand {
+    static constexpr Command id = Command::SetNetworkReplay;
+    static constexpr bool isSync = true;
+    QString file;
+    bool fallThrough = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("file"), file);
+        o.insert(QStringLiteral("fallThrough"), fallThrough);
+        return o;
+    }
+};
+
+struct StartHarCommand {
+    static constexpr Command id = Command::StartHar;
+    static constexpr bool isSync = true;
+    QString file;
+    QString creatorVersion;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("file"), file);
+        o.insert(QStringLiteral("creatorVersion"), creatorVersion);
+        return o;
+    }
+};
+
+struct StopHarCommand {
+    static constexpr Command id = Command::StopHar;
+    static constexpr bool isSync = true;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        return o;
+    }
+};
+
+// --- Events (Node -> C++) ---
+
+struct InitializedEvent {
+    static constexpr Event id = Event::Initialized;
+    static InitializedEvent fromJson(const QJsonObject& /* o */) {
+        InitializedEvent s;
+        return s;
+    }
+};
+
+struct LoadStartedEvent {
+    static constexpr Event id = Event::LoadStarted;
+    QUrl url;
+    static LoadStartedEvent fromJson(const QJsonObject& o) {
+        LoadStartedEvent s;
+        s.url = QUrl(o.value(QStringLiteral("url")).toString());
+        return s;
+    }
+};
+
+struct LoadFinishedEvent {
+    static constexpr Event id = Event::LoadFinished;
+    bool success = false;
+    QUrl url;
+    static LoadFinishedEvent fromJson(const QJsonObject& o) {
+        LoadFinishedEvent s;
+        s.success = o.value(QStringLiteral("success")).toBool();
+        s.url = QUrl(o.value(QStringLiteral("url")).toString());
+        return s;
+    }
+};
+
+struct LoadingProgressEvent {
+    static constexpr Event id = Event::LoadingProgress;
+    int progress = 0;
+    static LoadingProgressEvent fromJson(const QJsonObject& o) {
+        LoadingProgressEvent s;
+        s.progress = o.value(QStringLiteral("progress")).toInt();
+        return s;
+    }
+};
+
+struct UrlChangedEvent {
+    static constexpr Event id = Event::UrlChanged;
+    QUrl url;
+    static UrlChangedEvent fromJson(const QJsonObject& o) {
+        UrlChangedEvent s;
+        s.url = QUrl(o.value(QStringLiteral("url")).toString());
+        return s;
+    }
+};
+
+struct TitleChangedEvent {
+    static constexpr Event id = Event::TitleChanged;
+    QString title;
+    static TitleChangedEvent fromJson(const QJsonObject& o) {
+        TitleChangedEvent s;
+        s.title = o.value(QStringLiteral("title")).toString();
+        return s;
+    }
+};
+
+struct ContentsChangedEvent {
+    static constexpr Event id = Event::ContentsChanged;
+    static ContentsChangedEvent fromJson(const QJsonObject& /* o */) {
+        ContentsChangedEvent s;
+        return s;
+    }
+};
+
+struct NavigationRequestedEvent {
+    static constexpr Event id = Event::NavigationRequested;
+    QUrl url;
+    QString navigationType;
+    bool isMainFrame = false;
+    bool navigationLocked = false;
+    static NavigationRequestedEvent fromJson(const QJsonObject& o) {
+        NavigationRequestedEvent s;
+        s.url = QUrl(o.value(QStringLiteral("url")).toString());
+        s.navigationType = o.value(QStringLiteral("navigationType")).toString();
+        s.isMainFrame = o.value(QStringLiteral("isMainFrame")).toBool();
+        s.navigationLocked = o.value(QStringLiteral("navigationLocked")).toBool();
+        return s;
+    }
+};
+
+struct PageCreatedEvent {
+    static constexpr Event id = Event::PageCreated;
+    static PageCreatedEvent fromJson(const QJsonObject& /* o */) {
+        PageCreatedEvent s;
+        return s;
+    }
+};
+
+struct WindowCloseRequestedEvent {
+    static constexpr Event id = Event::WindowCloseRequested;
+    static WindowCloseRequestedEvent fromJson(const QJsonObject& /* o */) {
+        WindowCloseRequestedEvent s;
+        return s;
+    }
+};
+
+struct JavaScriptAlertSentEvent {
+    static constexpr Event id = Event::JavaScriptAlertSent;
+    QString message;
+    static JavaScriptAlertSentEvent fromJson(const QJsonObject& o) {
+        JavaScriptAlertSentEvent s;
+        s.message = o.value(QStringLiteral("message")).toString();
+        return s;
+    }
+};
+
+struct JavaScriptConsoleMessageSentEvent {
+    static constexpr Event id = Event::JavaScriptConsoleMessageSent;
+    QString message;
+    static JavaScriptConsoleMessageSentEvent fromJson(const QJsonObject& o) {
+        JavaScriptConsoleMessageSentEvent s;
+        s.message = o.value(QStringLiteral("message")).toString();
+        return s;
+    }
+};
+
+struct JavaScriptErrorSentEvent {
+    static constexpr Event id = Event::JavaScriptErrorSent;
+    QString message;
+    int lineNumber = 0;
+    QString sourceID;
+    QString stack;
+    static JavaScriptErrorSentEvent fromJson(const QJsonObject& o) {
+        JavaScriptErrorSentEvent s;
+        s.message = o.value(QStringLiteral("message")).toString();
+        s.lineNumber = o.value(QStringLiteral("lineNumber")).toInt();
+        s.sourceID = o.value(QStringLiteral("sourceID")).toString();
+        s.stack = o.value(QStringLiteral("stack")).toString();
+        return s;
+    }
+};
+
+struct ResourceRequestedEvent {
+    static constexpr Event id = Event::ResourceRequested;
+    QVariantMap data;
+    static ResourceRequestedEvent fromJson(const QJsonObject& o) {
+        ResourceRequestedEvent s;
+        s.data = o.toVariantMap();
+        return s;
+    }
+};
+
+struct ResourceReceivedEvent {
+    static constexpr Event id = Event::ResourceReceived;
+    QVariantMap data;
+    static ResourceReceivedEvent fromJson(const QJsonObject& o) {
+        ResourceReceivedEvent s;
+        s.data = o.toVariantMap();
+        return s;
+    }
+};
+
+struct ResourceErrorEvent {
+    static constexpr Event id = Event::ResourceError;
+    QVariantMap data;
+    static ResourceErrorEvent fromJson(const QJsonObject& o) {
+        ResourceErrorEvent s;
+        s.data = o.toVariantMap();
+        return s;
+    }
+};
+
+struct ResourceTimeoutEvent {
+    static constexpr Event id = Event::ResourceTimeout;
+    QVariantMap data;
+    static ResourceTimeoutEvent fromJson(const QJsonObject& o) {
+        ResourceTimeoutEvent s;
+        s.data = o.toVariantMap();
+        return s;
+    }
+};
+
+struct RepaintRequestedEvent {
+    static constexpr Event id = Event::RepaintRequested;
+    QRect rect;
+    static RepaintRequestedEvent fromJson(const QJsonObject& o) {
+        RepaintRequestedEvent s;
+        s.rect = rectFromJson(o.value(QStringLiteral("rect")));
+        return s;
+    }
+};
+
+struct JavaScriptConfirmRequestedEvent {
+    static constexpr Event id = Event::JavaScriptConfirmRequested;
+    QString message;
+    static JavaScriptConfirmRequestedEvent fromJson(const QJsonObject& o) {
+        JavaScriptConfirmRequestedEvent s;
+        s.message = o.value(QStringLiteral("message")).toString();
+        return s;
+    }
+};
+
+struct JavaScriptConfirmRequestedReply {
+    static constexpr Event id = Event::JavaScriptConfirmRequested;
+    bool result = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("result"), result);
+        return o;
+    }
+};
+
+struct JavaScriptPromptRequestedEvent {
+    static constexpr Event id = Event::JavaScriptPromptRequested;
+    QString message;
+    QString defaultValue;
+    static JavaScriptPromptRequestedEvent fromJson(const QJsonObject& o) {
+        JavaScriptPromptRequestedEvent s;
+        s.message = o.value(QStringLiteral("message")).toString();
+        s.defaultValue = o.value(QStringLiteral("defaultValue")).toString();
+        return s;
+    }
+};
+
+struct JavaScriptPromptRequestedReply {
+    static constexpr Event id = Event::JavaScriptPromptRequested;
+    QString result;
+    bool accepted = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("result"), result);
+        o.insert(QStringLiteral("accepted"), accepted);
+        return o;
+    }
+};
+
+struct JavascriptInterruptRequestedEvent {
+    static constexpr Event id = Event::JavascriptInterruptRequested;
+    static JavascriptInterruptRequestedEvent fromJson(const QJsonObject& /* o */) {
+        JavascriptInterruptRequestedEvent s;
+        return s;
+    }
+};
+
+struct JavascriptInterruptRequestedReply {
+    static constexpr Event id = Event::JavascriptInterruptRequested;
+    bool interrupt = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("interrupt"), interrupt);
+        return o;
+    }
+};
+
+struct FilePickerRequestedEvent {
+    static constexpr Event id = Event::FilePickerRequested;
+    QString oldFile;
+    static FilePickerRequestedEvent fromJson(const QJsonObject& o) {
+        FilePickerRequestedEvent s;
+        s.oldFile = o.value(QStringLiteral("oldFile")).toString();
+        return s;
+    }
+};
+
+struct FilePickerRequestedReply {
+    static constexpr Event id = Event::FilePickerRequested;
+    QString chosenFile;
+    bool handled = false;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("chosenFile"), chosenFile);
+        o.insert(QStringLiteral("handled"), handled);
+        return o;
+    }
+};
+
+struct CallExposedQObjectMethodEvent {
+    static constexpr Event id = Event::CallExposedQObjectMethod;
+    QString objectName;
+    QString methodName;
+    QVariantList args;
+    static CallExposedQObjectMethodEvent fromJson(const QJsonObject& o) {
+        CallExposedQObjectMethodEvent s;
+        s.objectName = o.value(QStringLiteral("objectName")).toString();
+        s.methodName = o.value(QStringLiteral("methodName")).toString();
+        s.args = o.value(QStringLiteral("args")).toArray().toVariantList();
+        return s;
+    }
+};
+
+struct CallExposedQObjectMethodReply {
+    static constexpr Event id = Event::CallExposedQObjectMethod;
+    QVariant result;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("result"), QJsonValue::fromVariant(result));
+        return o;
+    }
+};
+
+struct PongEvent {
+    static constexpr Event id = Event::Pong;
+    int seq = 0;
+    bool browserConnected = false;
+    static PongEvent fromJson(const QJsonObject& o) {
+        PongEvent s;
+        s.seq = o.value(QStringLiteral("seq")).toInt();
+        s.browserConnected = o.value(QStringLiteral("browserConnected")).toBool();
+        return s;
+    }
+};
+
+struct PdfChunkEvent {
+    static constexpr Event id = Event::PdfChunk;
+    int streamId = 0;
+    QString data;
+    bool eof = false;
+    static PdfChunkEvent fromJson(const QJsonObject& o) {
+        PdfChunkEvent s;
+        s.streamId = o.value(QStringLiteral("streamId")).toInt();
+        s.data = o.value(QStringLiteral("data")).toString();
+        s.eof = o.value(QStringLiteral("eof")).toBool();
+        return s;
+    }
+};
+
+struct PdfPrintingEvent {
+    static constexpr Event id = Event::PdfPrinting;
+    int streamId = 0;
+    static PdfPrintingEvent fromJson(const QJsonObject& o) {
+        PdfPrintingEvent s;
+        s.streamId = o.value(QStringLiteral("streamId")).toInt();
+        return s;
+    }
+};
+
+struct PdfPartRenderedEvent {
+    static constexpr Event id = Event::PdfPartRendered;
+    int index = 0;
+    int pages = 0;
+    static PdfPartRenderedEvent fromJson(const QJsonObject& o) {
+        PdfPartRenderedEvent s;
+        s.index = o.value(QStringLiteral("index")).toInt();
+        s.pages = o.value(QStringLiteral("pages")).toInt();
+        return s;
+    }
+};
+
+struct TemplatePreparingEvent {
+    static constexpr Event id = Event::TemplatePreparing;
+    int clones = 0;
+    static TemplatePreparingEvent fromJson(const QJsonObject& o) {
+        TemplatePreparingEvent s;
+        s.clones = o.value(QStringLiteral("clones")).toInt();
+        return s;
+    }
+};
+
+struct TemplateRenderedEvent {
+    static constexpr Event id = Event::TemplateRendered;
+    int index = 0;
+    QString error;
+    static TemplateRenderedEvent fromJson(const QJsonObject& o) {
+        TemplateRenderedEvent s;
+        s.index = o.value(QStringLiteral("index")).toInt();
+        s.error = o.value(QStringLiteral("error")).toString();
+        return s;
+    }
+};
+
+struct ScreencastFrameEvent {
+    static constexpr Event id = Event::ScreencastFrame;
+    QString data;
+    double timestamp = 0.0;
+    static ScreencastFrameEvent fromJson(const QJsonObject& o) {
+        ScreencastFrameEvent s;
+        s.data = o.value(QStringLiteral("data")).toString();
+        s.timestamp = o.value(QStringLiteral("timestamp")).toDouble();
+        return s;
+    }
+};
+
+struct ResponseCacheLookupEvent {
+    static constexpr Event id = Event::ResponseCacheLookup;
+    QString url;
+    QVariantMap headers;
+    static ResponseCacheLookupEvent fromJson(const QJsonObject& o) {
+        ResponseCacheLookupEvent s;
+        s.url = o.value(QStringLiteral("url")).toString();
+        s.headers = o.value(QStringLiteral("headers")).toObject().toVariantMap();
+        return s;
+    }
+};
+
+struct ResponseCacheLookupReply {
+    static constexpr Event id = Event::ResponseCacheLookup;
+    bool found = false;
+    int status = 0;
+    QVariantMap headers;
+    QString body;
+    QJsonObject toJson() const {
+        QJsonObject o;
+        o.insert(QStringLiteral("found"), found);
+        o.insert(QStringLiteral("status"), status);
+        o.insert(QStringLiteral("headers"), QJsonObject::fromVariantMap(headers));
+        o.insert(QStringLiteral("body"), body);
+        return o;
+    }
+};
+
+struct ResponseCacheStoreEvent {
+    static constexpr Event id = Event::ResponseCacheStore;
+    QString url;
+    QVariantMap vary;
+    double expires = 0.0;
+    int status = 0;
+    QVariantMap headers;
+    QString body;
+    static ResponseCacheStoreEvent fromJson(const QJsonObject& o) {
+        ResponseCacheStoreEvent s;
+        s.url = o.value(QStringLiteral("url")).toString();
+        s.vary = o.value(QStringLiteral("vary")).toObject().toVariantMap();
+        s.expires = o.value(QStringLiteral("expires")).toDouble();
+        s.status = o.value(QStringLiteral("status")).toInt();
+        s.headers = o.value(QStringLiteral("headers")).toObject().toVariantMap();
+        s.body = o.value(QStringLiteral("body")).toString();
+        return s;
+    }
+};
+
+} // namespace PlaywrightProtocol
+
+#endif // PLAYWRIGHTPROTOCOL_H
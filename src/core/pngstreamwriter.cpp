@@ -0,0 +1,221 @@
+#include "pngstreamwriter.h"
+
+#include <QtEndian>
+#include <cstdlib>
+
+namespace {
+
+const int IdatChunkSize = 64 * 1024;
+
+enum FilterType { None = 0, Sub = 1, Up = 2, Average = 3, Paeth = 4, FilterCount = 5 };
+
+inline uchar paethPredictor(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return uchar(a);
+    }
+    return uchar(pb <= pc ? b : c);
+}
+
+// Filters `row` into `out` (without the type byte) and returns the sum of the residuals as signed bytes.
+quint64 filterRow(FilterType type, const uchar* row, const uchar* previous, int length, int bpp, uchar* out) {
+    quint64 cost = 0;
+    for (int i = 0; i < length; ++i) {
+        const int a = i >= bpp ? row[i - bpp] : 0;
+        const int b = previous[i];
+        const int c = i >= bpp ? previous[i - bpp] : 0;
+        uchar predicted = 0;
+        switch (type) {
+        case None:
+            break;
+        case Sub:
+            predicted = uchar(a);
+            break;
+        case Up:
+            predicted = uchar(b);
+            break;
+        case Average:
+            predicted = uchar((a + b) / 2);
+            break;
+        case Paeth:
+            predicted = paethPredictor(a, b, c);
+            break;
+        default:
+            break;
+        }
+        const uchar residual = uchar(row[i] - predicted);
+        out[i] = residual;
+        cost += residual < 128 ? residual : 256 - residual;
+    }
+    return cost;
+}
+
+} // namespace
+
+PngStreamWriter::PngStreamWriter()
+    : m_streamOpen(false)
+    , m_width(0)
+    , m_height(0)
+    , m_bytesPerPixel(3)
+    , m_rowsWritten(0) { }
+
+PngStreamWriter::~PngStreamWriter() {
+    if (m_streamOpen) {
+        deflateEnd(&m_stream);
+    }
+}
+
+bool PngStreamWriter::fail(const QString& error) {
+    m_error = error;
+    if (m_streamOpen) {
+        deflateEnd(&m_stream);
+        m_streamOpen = false;
+    }
+    m_file.close();
+    return false;
+}
+
+bool PngStreamWriter::open(const QString& fileName, int width, int height, bool alpha, int compressionLevel) {
+    if (width <= 0 || height <= 0) {
+        return fail(QString("invalid image size %1x%2").arg(width).arg(height));
+    }
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly)) {
+        return fail("could not open " + fileName + ": " + m_file.errorString());
+    }
+    m_width = width;
+    m_height = height;
+    m_bytesPerPixel = alpha ? 4 : 3;
+    m_rowsWritten = 0;
+    m_previousRow = QByteArray(width * m_bytesPerPixel, '\0');
+    m_currentRow = QByteArray(width * m_bytesPerPixel, '\0');
+    m_filtered = QByteArray(FilterCount * (width * m_bytesPerPixel + 1), '\0');
+    m_output = QByteArray(IdatChunkSize, '\0');
+
+    m_stream = z_stream();
+    const int level = compressionLevel < 0 ? Z_DEFAULT_COMPRESSION : qBound(0, compressionLevel, 9);
+    if (deflateInit(&m_stream, level) != Z_OK) {
+        return fail("deflateInit failed");
+    }
+    m_streamOpen = true;
+    m_stream.next_out = reinterpret_cast<Bytef*>(m_output.data());
+    m_stream.avail_out = uInt(m_output.size());
+
+    static const char signature[] = "\x89PNG\r\n\x1a\n";
+    if (m_file.write(signature, 8) != 8) {
+        return fail("could not write " + fileName + ": " + m_file.errorString());
+    }
+    QByteArray header(13, '\0');
+    qToBigEndian(quint32(width), reinterpret_cast<uchar*>(header.data()));
+    qToBigEndian(quint32(height), reinterpret_cast<uchar*>(header.data() + 4));
+    header[8] = 8; // Bit depth
+    header[9] = alpha ? 6 : 2; // Colour type: RGBA or RGB
+    // Compression, filter and interlace methods stay 0.
+    return writeChunk("IHDR", header);
+}
+
+bool PngStreamWriter::writeChunk(const char* type, const QByteArray& data) {
+    uchar length[4];
+    qToBigEndian(quint32(data.size()), length);
+    uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(type), 4);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(data.constData()), uInt(data.size()));
+    uchar crcBytes[4];
+    qToBigEndian(quint32(crc), crcBytes);
+
+    if (m_file.write(reinterpret_cast<const char*>(length), 4) != 4 || m_file.write(type, 4) != 4
+        || m_file.write(data) != data.size() || m_file.write(reinterpret_cast<const char*>(crcBytes), 4) != 4) {
+        return fail("could not write " + m_file.fileName() + ": " + m_file.errorString());
+    }
+    return true;
+}
+
+bool PngStreamWriter::deflateRow(const uchar* filtered, int flush) {
+    m_stream.next_in = const_cast<Bytef*>(filtered);
+    m_stream.avail_in = filtered ? uInt(m_width * m_bytesPerPixel + 1) : 0;
+    do {
+        const int status = deflate(&m_stream, flush);
+        if (status == Z_STREAM_ERROR) {
+            return fail("deflate failed");
+        }
+        if (m_stream.avail_out == 0 || (flush == Z_FINISH && status == Z_STREAM_END)) {
+            const int produced = m_output.size() - int(m_stream.avail_out);
+            if (produced > 0 && !writeChunk("IDAT", m_output.left(produced))) {
+                return false;
+            }
+            m_stream.next_out = reinterpret_cast<Bytef*>(m_output.data());
+            m_stream.avail_out = uInt(m_output.size());
+            if (status == Z_STREAM_END) {
+                return true;
+            }
+        }
+    } while (m_stream.avail_in > 0 || m_stream.avail_out == 0 || flush == Z_FINISH);
+    return true;
+}
+
+bool PngStreamWriter::writeRows(const QImage& band) {
+    if (!m_streamOpen) {
+        return false;
+    }
+    if (band.width() != m_width) {
+        return fail(QString("band is %1 px wide, expected %2").arg(band.width()).arg(m_width));
+    }
+    const QImage pixels = band.format() == QImage::Format_ARGB32 ? band : band.convertToFormat(QImage::Format_ARGB32);
+    const int rowLength = m_width * m_bytesPerPixel;
+    const int stride = rowLength + 1;
+
+    for (int y = 0; y < pixels.height() && m_rowsWritten < m_height; ++y, ++m_rowsWritten) {
+        const QRgb* in = reinterpret_cast<const QRgb*>(pixels.constScanLine(y));
+        uchar* row = reinterpret_cast<uchar*>(m_currentRow.data());
+        for (int x = 0; x < m_width; ++x) {
+            uchar* p = row + x * m_bytesPerPixel;
+            p[0] = uchar(qRed(in[x]));
+            p[1] = uchar(qGreen(in[x]));
+            p[2] = uchar(qBlue(in[x]));
+            if (m_bytesPerPixel == 4) {
+                p[3] = uchar(qAlpha(in[x]));
+            }
+        }
+
+        const uchar* previous = reinterpret_cast<const uchar*>(m_previousRow.constData());
+        uchar* candidates = reinterpret_cast<uchar*>(m_filtered.data());
+        int best = 0;
+        quint64 bestCost = ~quint64(0);
+        for (int type = 0; type < FilterCount; ++type) {
+            uchar* out = candidates + type * stride;
+            out[0] = uchar(type);
+            const quint64 cost
+                = filterRow(FilterType(type), row, previous, rowLength, m_bytesPerPixel, out + 1);
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = type;
+            }
+        }
+        if (!deflateRow(candidates + best * stride, Z_NO_FLUSH)) {
+            return false;
+        }
+        m_previousRow.swap(m_currentRow);
+    }
+    return true;
+}
+
+bool PngStreamWriter::close() {
+    if (!m_streamOpen) {
+        return false;
+    }
+    if (m_rowsWritten < m_height) {
+        return fail(QString("only %1 of %2 rows were written").arg(m_rowsWritten).arg(m_height));
+    }
+    if (!deflateRow(nullptr, Z_FINISH)) {
+        return false;
+    }
+    deflateEnd(&m_stream);
+    m_streamOpen = false;
+    if (!writeChunk("IEND", QByteArray())) {
+        return false;
+    }
+    m_file.close();
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef PNGSTREAMWRITER_H
+#define PNGSTREAMWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QImage>
+#include <QString>
+
+#include <zlib.h>
+
+// Writes a PNG of known size to a file one band of rows at a time, so a 50,000 px tall capture never has to exist
+// as a single bitmap. Memory use is one band (owned by the caller), a few rows and the deflate buffers.
+//
+// Output is 8-bit RGB (or RGBA with `alpha`), each row filtered with whichever of the standard PNG filters gives
+// the smallest sum of absolute residuals, which is what libpng does by default.
+class PngStreamWriter {
+public:
+    PngStreamWriter();
+    ~PngStreamWriter();
+
+    // compressionLevel is the zlib level, 0-9; -1 uses zlib's default.
+    bool open(const QString& fileName, int width, int height, bool alpha = false, int compressionLevel = -1);
+    // Appends the rows of `band`, which must be `width` pixels wide. Surplus rows beyond `height` are ignored.
+    bool writeRows(const QImage& band);
+    // Writes the trailer. Fails if fewer than `height` rows were written.
+    bool close();
+
+    int rowsWritten() const { return m_rowsWritten; }
+    QString errorString() const { return m_error; }
+
+private:
+    bool writeChunk(const char* type, const QByteArray& data);
+    bool deflateRow(const uchar* filtered, int flush);
+    bool fail(const QString& error);
+
+    QFile m_file;
+    z_stream m_stream;
+    bool m_streamOpen;
+    int m_width;
+    int m_height;
+    int m_bytesPerPixel;
+    int m_rowsWritten;
+    QByteArray m_previousRow; // Unfiltered, for the Up/Average/Paeth filters
+    QByteArray m_currentRow;
+    QByteArray m_filtered; // Filter type byte + filtered row, one buffer per candidate filter
+    QByteArray m_output; // Deflate output, flushed as one IDAT chunk whenever full
+    QString m_error;
+};
+
+#endif // PNGSTREAMWRITER_H
@@ -0,0 +1,73 @@
+#include "responsecache.h"
+#include "config.h"
+
+#include <QDateTime>
+#include <limits>
+
+static ResponseCache* response_cache_instance = 0;
+
+ResponseCache* ResponseCache::instance() {
+    if (!response_cache_instance) {
+        response_cache_instance = new ResponseCache();
+    }
+    return response_cache_instance;
+}
+
+ResponseCache::ResponseCache(QObject* parent)
+    : QObject(parent) {
+    Config* config = Config::instance();
+    setMaxBytes(qint64(config->memoryCacheSize()) * 1024 * 1024);
+    connect(config, &Config::memoryCacheSizeChanged, this,
+        [this](int megabytes) { setMaxBytes(qint64(megabytes) * 1024 * 1024); });
+}
+
+void ResponseCache::setMaxBytes(qint64 bytes) {
+    m_cache.setMaxCost(int(qBound(qint64(0), bytes / 1024, qint64(std::numeric_limits<int>::max()))));
+    if (!isEnabled()) {
+        m_varyNames.clear();
+    }
+}
+
+QString ResponseCache::key(const QString& url, const QStringList& varyNames, const QVariantMap& headers) {
+    QString key = url;
+    for (const QString& name : varyNames) {
+        key += QLatin1Char('\n') + name + QLatin1Char(':') + headers.value(name).toString();
+    }
+    return key;
+}
+
+bool ResponseCache::lookup(const QString& url, const QVariantMap& requestHeaders, Response* response) {
+    const auto names = m_varyNames.constFind(url);
+    if (names == m_varyNames.constEnd()) {
+        return false;
+    }
+    const QString entryKey = key(url, names.value(), requestHeaders);
+    Entry* entry = m_cache.object(entryKey); // Marks it as most recently used
+    if (!entry) {
+        // Evicted, or another variant. Forgetting the URL keeps m_varyNames from growing without bound; a variant
+        // still cached becomes reachable again with the next store for the URL.
+        m_varyNames.remove(url);
+        return false;
+    }
+    if (entry->expires <= QDateTime::currentMSecsSinceEpoch()) {
+        m_cache.remove(entryKey);
+        return false;
+    }
+    *response = entry->response;
+    return true;
+}
+
+void ResponseCache::store(const QString& url, const QVariantMap& vary, qint64 expires, const Response& response) {
+    if (!isEnabled()) {
+        return;
+    }
+    // QVariantMap keys are sorted, so the names come in a stable order.
+    const QStringList names = vary.keys();
+    const int cost = int(response.body.size() / 1024) + 1;
+    // An entry bigger than an eighth of the budget would push out many smaller, more reusable ones.
+    if (cost > m_cache.maxCost() / 8) {
+        return;
+    }
+    m_varyNames.insert(url, names);
+    m_cache.insert(key(url, names, vary), new Entry { response, expires }, cost);
+}
@@ -0,0 +1,54 @@
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+// Static subresources (scripts, stylesheets, images, fonts) kept in memory for every page of the process.
+//
+// Each page has its own backend process, so a cache in the backend would only help that page; this one lives here
+// and the backends consult it over IPC before going to the network. Responses are keyed by URL plus the values of
+// the request headers they Vary on, and evicted least recently used once their bodies outgrow the byte budget
+// (Config memoryCacheSize). The backend decides what may be stored and for how long; the cache only serves entries
+// that are still fresh.
+class ResponseCache : public QObject {
+    Q_OBJECT
+
+public:
+    struct Response {
+        int status = 0;
+        QVariantMap headers;
+        QByteArray body; // Base64, as it crosses the pipe
+    };
+
+    static ResponseCache* instance();
+
+    bool isEnabled() const { return m_cache.maxCost() > 0; }
+    void setMaxBytes(qint64 bytes);
+
+    // `requestHeaders` use lowercase names.
+    bool lookup(const QString& url, const QVariantMap& requestHeaders, Response* response);
+    // `vary` maps the lowercase names of the headers the response varies on to their values in the request.
+    void store(const QString& url, const QVariantMap& vary, qint64 expires, const Response& response);
+
+private:
+    struct Entry {
+        Response response;
+        qint64 expires; // ms since the epoch
+    };
+
+    explicit ResponseCache(QObject* parent = nullptr);
+
+    static QString key(const QString& url, const QStringList& varyNames, const QVariantMap& headers);
+
+    // QCache costs are ints, so they count kilobytes.
+    QCache<QString, Entry> m_cache;
+    QHash<QString, QStringList> m_varyNames; // URL -> headers its last stored response varies on
+};
+
+#endif // RESPONSECACHE_H
@@ -0,0 +1,138 @@
+#include "screencastwriter.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRegularExpression>
+
+namespace {
+
+// The %d (optionally zero-padded, e.g. %05d) placeholder of an image-sequence file name
+const QRegularExpression SequencePlaceholder("%(0\\d+)?d");
+
+QString sequenceFileName(const QString& pattern, int index) {
+    const QRegularExpressionMatch match = SequencePlaceholder.match(pattern);
+    const int width = match.captured(1).toInt();
+    return QString(pattern).replace(match.capturedStart(), match.capturedLength(),
+        QString("%1").arg(index, width, 10, QChar('0')));
+}
+
+}
+
+ScreencastWriter::ScreencastWriter(int queueSize)
+    : m_queueSize(qMax(1, queueSize))
+    , m_sequence(false)
+    , m_finishing(false)
+    , m_written(0)
+    , m_dropped(0) { }
+
+ScreencastWriter::~ScreencastWriter() { finish(); }
+
+bool ScreencastWriter::open(const QString& fileName) {
+    const QString suffix = QFileInfo(fileName).suffix().toLower();
+    m_fileName = fileName;
+    m_sequence = suffix != "mjpeg" && suffix != "mjpg";
+    if (m_sequence && fileName.count('%') != 1) {
+        m_error = "file name needs a .mjpeg suffix or one %d placeholder: " + fileName;
+        return false;
+    }
+    if (m_sequence && !SequencePlaceholder.match(fileName).hasMatch()) {
+        m_error = "unsupported placeholder in " + fileName;
+        return false;
+    }
+    if (!m_sequence) {
+        m_stream.setFileName(fileName);
+        if (!m_stream.open(QIODevice::WriteOnly)) {
+            m_error = "cannot write " + fileName;
+            return false;
+        }
+    }
+    m_index.setFileName(m_sequence ? QFileInfo(fileName).path() + "/frames.txt" : fileName + ".txt");
+    if (!m_index.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_error = "cannot write " + m_index.fileName();
+        return false;
+    }
+    start(QThread::LowPriority);
+    return true;
+}
+
+bool ScreencastWriter::enqueue(const QByteArray& jpeg, qreal timestamp) {
+    QMutexLocker lock(&m_mutex);
+    if (m_finishing || m_queue.size() >= m_queueSize) {
+        ++m_dropped;
+        return false;
+    }
+    m_queue.enqueue(Frame { jpeg, timestamp });
+    m_wake.wakeOne();
+    return true;
+}
+
+void ScreencastWriter::finish() {
+    {
+        QMutexLocker lock(&m_mutex);
+        m_finishing = true;
+        m_wake.wakeOne();
+    }
+    wait();
+    m_stream.close();
+    m_index.close();
+}
+
+int ScreencastWriter::framesWritten() const {
+    QMutexLocker lock(&m_mutex);
+    return m_written;
+}
+
+int ScreencastWriter::framesDropped() const {
+    QMutexLocker lock(&m_mutex);
+    return m_dropped;
+}
+
+QString ScreencastWriter::errorString() const {
+    QMutexLocker lock(&m_mutex);
+    return m_error;
+}
+
+void ScreencastWriter::run() {
+    for (;;) {
+        Frame frame;
+        {
+            QMutexLocker lock(&m_mutex);
+            while (m_queue.isEmpty() && !m_finishing) {
+                m_wake.wait(&m_mutex);
+            }
+            if (m_queue.isEmpty()) {
+                return; // Finishing and drained
+            }
+            frame = m_queue.dequeue();
+        }
+        if (!writeFrame(frame)) {
+            QMutexLocker lock(&m_mutex);
+            m_dropped += 1 + m_queue.size();
+            m_queue.clear();
+            m_finishing = true; // Nothing more will be accepted
+            return;
+        }
+    }
+}
+
+bool ScreencastWriter::writeFrame(const Frame& frame) {
+    const int index = m_written; // Only this thread changes m_written
+    if (m_sequence) {
+        QFile file(sequenceFileName(m_fileName, index));
+        if (!file.open(QIODevice::WriteOnly) || file.write(frame.data) != frame.data.size()) {
+            QMutexLocker lock(&m_mutex);
+            m_error = "cannot write " + file.fileName();
+            return false;
+        }
+    } else if (m_stream.write(frame.data) != frame.data.size()) {
+        QMutexLocker lock(&m_mutex);
+        m_error = "cannot write " + m_fileName + ": " + m_stream.errorString();
+        return false;
+    }
+    m_index.write(QByteArray::number(index) + ' ' + QByteArray::number(frame.timestamp, 'f', 3) + '\n');
+
+    QMutexLocker lock(&m_mutex);
+    ++m_written;
+    return true;
+}
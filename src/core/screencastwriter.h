@@ -0,0 +1,62 @@
+#ifndef SCREENCASTWRITER_H
+#define SCREENCASTWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+// Writes JPEG screencast frames to disk on its own thread. The queue between the page and the writer holds at most
+// `queueSize` frames: when the disk falls behind, new frames are dropped (and counted) instead of piling up.
+//
+// A file name ending in .mjpeg or .mjpg gets a motion-JPEG stream (the frames back to back, as `ffmpeg -f mjpeg`
+// reads them); any other name must contain a printf-style %d placeholder, e.g. "frames/frame-%05d.jpg", and gets
+// one file per frame. An index lists the capture timestamp (seconds) of every written frame: "<file>.txt" next to a
+// stream, "frames.txt" next to an image sequence.
+class ScreencastWriter : public QThread {
+public:
+    explicit ScreencastWriter(int queueSize = 8);
+    ~ScreencastWriter() override;
+
+    // Checks the file name, opens the output and starts the writer thread.
+    bool open(const QString& fileName);
+    // Returns false if the frame was dropped because the queue is full.
+    bool enqueue(const QByteArray& jpeg, qreal timestamp);
+    // Writes the frames still queued, then stops the thread.
+    void finish();
+
+    QString fileName() const { return m_fileName; }
+    int framesWritten() const;
+    int framesDropped() const;
+    QString errorString() const;
+
+protected:
+    void run() override;
+
+private:
+    struct Frame {
+        QByteArray data;
+        qreal timestamp;
+    };
+
+    bool writeFrame(const Frame& frame);
+
+    const int m_queueSize;
+    QString m_fileName;
+    bool m_sequence;
+    QFile m_stream; // The .mjpeg output; unused for image sequences
+    QFile m_index;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    QQueue<Frame> m_queue;
+    bool m_finishing;
+    int m_written;
+    int m_dropped;
+    QString m_error;
+};
+
+#endif // SCREENCASTWRITER_H
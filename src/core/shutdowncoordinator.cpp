@@ -0,0 +1,60 @@
+#include "shutdowncoordinator.h"
+#include "ienginebackend.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+static ShutdownCoordinator* shutdown_coordinator_instance = 0;
+
+ShutdownCoordinator* ShutdownCoordinator::instance() {
+    if (!shutdown_coordinator_instance) {
+        // Not parented to the application: backends destroyed during its teardown still unregister here.
+        shutdown_coordinator_instance = new ShutdownCoordinator();
+    }
+    return shutdown_coordinator_instance;
+}
+
+ShutdownCoordinator::ShutdownCoordinator(QObject* parent)
+    : QObject(parent) { }
+
+void ShutdownCoordinator::registerBackend(IEngineBackend* backend) {
+    if (backend && !m_backends.contains(backend)) {
+        m_backends.append(backend);
+    }
+}
+
+void ShutdownCoordinator::unregisterBackend(IEngineBackend* backend) { m_backends.removeAll(backend); }
+
+void ShutdownCoordinator::shutdownAll(int deadlineMs, bool graceful) {
+    QList<IEngineBackend*> backends;
+    for (const QPointer<IEngineBackend>& backend : m_backends) {
+        if (backend) {
+            backends.append(backend.data());
+        }
+    }
+    qDebug() << "ShutdownCoordinator: Shutting down" << backends.size() << "backends"
+             << (graceful ? "gracefully" : "fast") << "with a deadline of" << deadlineMs << "ms";
+    shutdown(backends, deadlineMs, graceful);
+}
+
+void ShutdownCoordinator::shutdown(const QList<IEngineBackend*>& backends, int deadlineMs, bool graceful) {
+    // Broadcast first, so every backend is closing its browser while we wait on the others.
+    for (IEngineBackend* backend : backends) {
+        backend->requestShutdown(graceful);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<IEngineBackend*> stragglers;
+    for (IEngineBackend* backend : backends) {
+        const int remaining = qMax(0, deadlineMs - static_cast<int>(timer.elapsed()));
+        if (!backend->waitForShutdown(remaining)) {
+            stragglers.append(backend);
+        }
+    }
+
+    for (IEngineBackend* backend : stragglers) {
+        qWarning() << "ShutdownCoordinator: Backend did not exit within" << deadlineMs << "ms, killing it.";
+        backend->kill();
+    }
+}
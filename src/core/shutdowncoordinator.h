@@ -0,0 +1,36 @@
+#ifndef SHUTDOWNCOORDINATOR_H
+#define SHUTDOWNCOORDINATOR_H
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+class IEngineBackend;
+
+// Tears engine backends down together instead of one after another.
+//
+// Every backend is asked to shut down first, so their browsers close concurrently; the coordinator then waits on all
+// of them against one shared deadline and kills whatever is still running when it expires. Exit time is bounded by
+// the deadline, not by the number of pages.
+class ShutdownCoordinator : public QObject {
+    Q_OBJECT
+
+public:
+    static ShutdownCoordinator* instance();
+
+    void registerBackend(IEngineBackend* backend);
+    void unregisterBackend(IEngineBackend* backend);
+
+    // Shuts down every registered backend. `graceful` lets each backend close its browser cleanly; otherwise the
+    // backend processes are terminated right away.
+    void shutdownAll(int deadlineMs, bool graceful);
+
+    static void shutdown(const QList<IEngineBackend*>& backends, int deadlineMs, bool graceful);
+
+private:
+    explicit ShutdownCoordinator(QObject* parent = nullptr);
+
+    QList<QPointer<IEngineBackend>> m_backends;
+};
+
+#endif // SHUTDOWNCOORDINATOR_H
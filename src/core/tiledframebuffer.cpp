@@ -0,0 +1,130 @@
+#include "tiledframebuffer.h"
+#include "ienginebackend.h"
+
+#include <QDebug>
+#include <QPainter>
+
+TiledFramebuffer::TiledFramebuffer(int tileSize)
+    : m_tileSize(qMax(16, tileSize))
+    , m_columns(0)
+    , m_rows(0)
+    , m_allDirty(true)
+    , m_zoomFactor(1.0)
+    , m_generation(0) { }
+
+void TiledFramebuffer::invalidate(const QRect& rect) {
+    if (m_allDirty) {
+        return;
+    }
+    if (rect.isEmpty()) {
+        invalidateAll();
+        return;
+    }
+    const QRect viewportRect = rect.translated(-m_scrollPosition).intersected(m_image.rect());
+    if (viewportRect.isEmpty()) {
+        return; // Painted outside the viewport
+    }
+    const int lastColumn = qMin(m_columns - 1, viewportRect.right() / m_tileSize);
+    const int lastRow = qMin(m_rows - 1, viewportRect.bottom() / m_tileSize);
+    for (int row = viewportRect.top() / m_tileSize; row <= lastRow; ++row) {
+        for (int column = viewportRect.left() / m_tileSize; column <= lastColumn; ++column) {
+            m_dirty.setBit(row * m_columns + column);
+        }
+    }
+}
+
+void TiledFramebuffer::invalidateAll() { m_allDirty = true; }
+
+int TiledFramebuffer::dirtyTileCount() const { return m_dirty.count(true); }
+
+// Runs of dirty tiles per tile row, then identical runs on consecutive rows merged into one rectangle.
+QList<QRect> TiledFramebuffer::dirtyRects() const {
+    QList<QRect> rects;
+    QList<QRect> open; // Rectangles that end on the previous row and may still grow downwards
+    for (int row = 0; row < m_rows; ++row) {
+        QList<QRect> current;
+        for (int column = 0; column < m_columns; ++column) {
+            if (!m_dirty.testBit(row * m_columns + column)) {
+                continue;
+            }
+            const int first = column;
+            while (column + 1 < m_columns && m_dirty.testBit(row * m_columns + column + 1)) {
+                ++column;
+            }
+            QRect span(first, row, column - first + 1, 1);
+            for (int i = 0; i < open.size(); ++i) {
+                if (open[i].left() == span.left() && open[i].right() == span.right()) {
+                    span.setTop(open[i].top());
+                    open.removeAt(i);
+                    break;
+                }
+            }
+            current.append(span);
+        }
+        rects.append(open); // Whatever did not continue is finished
+        open = current;
+    }
+    rects.append(open);
+
+    for (QRect& rect : rects) {
+        rect = QRect(rect.left() * m_tileSize, rect.top() * m_tileSize, rect.width() * m_tileSize,
+            rect.height() * m_tileSize)
+                   .intersected(m_image.rect());
+    }
+    return rects;
+}
+
+bool TiledFramebuffer::update(IEngineBackend* backend, const QPoint& scrollPosition, QList<QRect>* changed) {
+    changed->clear();
+    const QSize size = backend->viewportSize();
+    const qreal zoom = backend->zoomFactor();
+    if (size.isEmpty()) {
+        return false;
+    }
+    if (size != m_image.size() || scrollPosition != m_scrollPosition || zoom != m_zoomFactor) {
+        m_allDirty = true;
+    }
+    if (!m_allDirty && dirtyTileCount() * 2 > m_columns * m_rows) {
+        m_allDirty = true; // Fewer round trips than capturing most of the tiles one rectangle at a time
+    }
+
+    if (m_allDirty) {
+        const QImage frame = backend->captureFrame(QRect(QPoint(0, 0), size), true, scrollPosition);
+        if (frame.isNull()) {
+            return false;
+        }
+        m_image = frame.size() == size ? frame.convertToFormat(QImage::Format_ARGB32)
+                                       : frame.scaled(size).convertToFormat(QImage::Format_ARGB32);
+        m_scrollPosition = scrollPosition;
+        m_zoomFactor = zoom;
+        m_columns = (size.width() + m_tileSize - 1) / m_tileSize;
+        m_rows = (size.height() + m_tileSize - 1) / m_tileSize;
+        m_dirty = QBitArray(m_columns * m_rows);
+        m_allDirty = false;
+        ++m_generation;
+        changed->append(m_image.rect());
+        return true;
+    }
+
+    const QList<QRect> rects = dirtyRects();
+    if (rects.isEmpty()) {
+        return true;
+    }
+    QPainter painter(&m_image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (const QRect& rect : rects) {
+        const QImage tile = backend->captureFrame(rect, true, scrollPosition);
+        if (tile.isNull()) {
+            painter.end();
+            invalidateAll();
+            return false;
+        }
+        painter.drawImage(rect, tile); // Scales if the backend captured at a device pixel ratio != 1
+        changed->append(rect);
+    }
+    painter.end();
+    m_dirty.fill(false);
+    ++m_generation;
+    qDebug() << "TiledFramebuffer: Re-captured" << rects.size() << "rect(s) instead of the full viewport";
+    return true;
+}
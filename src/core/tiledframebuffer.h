@@ -0,0 +1,49 @@
+#ifndef TILEDFRAMEBUFFER_H
+#define TILEDFRAMEBUFFER_H
+
+#include <QBitArray>
+#include <QImage>
+#include <QList>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+
+class IEngineBackend;
+
+// Viewport framebuffer for incremental capture (render() with { incremental: true }).
+//
+// The viewport is split into square tiles. repaintRequested rects mark the tiles they touch dirty, and update()
+// re-captures only those (merged into as few rectangles as possible) and composites them into the kept frame. A
+// resize, scroll or zoom, a navigation, or a dirty area over half the viewport falls back to one full capture.
+class TiledFramebuffer {
+public:
+    explicit TiledFramebuffer(int tileSize = 256);
+
+    // `rect` is in page coordinates, as emitted by IEngineBackend::repaintRequested; an empty rect dirties all.
+    void invalidate(const QRect& rect);
+    void invalidateAll();
+
+    // Brings the frame up to date. Returns the viewport rectangles that were re-captured (empty if nothing
+    // changed), or false on capture failure.
+    bool update(IEngineBackend* backend, const QPoint& scrollPosition, QList<QRect>* changed);
+
+    const QImage& image() const { return m_image; }
+    // Bumped whenever the frame content changes, so callers can skip re-encoding an unchanged frame.
+    quint64 generation() const { return m_generation; }
+
+private:
+    QList<QRect> dirtyRects() const;
+    int dirtyTileCount() const;
+
+    int m_tileSize;
+    int m_columns;
+    int m_rows;
+    QBitArray m_dirty; // m_columns * m_rows, row-major
+    bool m_allDirty;
+    QImage m_image;
+    QPoint m_scrollPosition;
+    qreal m_zoomFactor;
+    quint64 m_generation;
+};
+
+#endif // TILEDFRAMEBUFFER_H
@@ -0,0 +1,390 @@
+#include "urlfilter.h"
+
+#include <QMap>
+#include <QQueue>
+#include <QRegularExpression>
+
+namespace {
+
+// Bit order of the type masks. Sent along as typeNames, so the backend maps request types to the same bits.
+const char* const ResourceTypeNames[]
+    = { "document", "subdocument", "stylesheet", "script", "image", "font", "media", "xhr", "fetch", "websocket",
+          "other" };
+const int ResourceTypeCount = sizeof(ResourceTypeNames) / sizeof(ResourceTypeNames[0]);
+const quint32 AllTypes = (1u << ResourceTypeCount) - 1;
+const quint32 DefaultTypes = AllTypes & ~1u; // As in Adblock Plus, rules don't apply to the top-level document
+
+// Shorter keywords hit on nearly every URL, so those rules are cheaper to test directly
+const int MinKeywordLength = 3;
+
+quint32 typeBit(const char* name) {
+    for (int i = 0; i < ResourceTypeCount; ++i) {
+        if (qstrcmp(ResourceTypeNames[i], name) == 0) {
+            return 1u << i;
+        }
+    }
+    return 0;
+}
+
+// Playwright resource types plus the Adblock Plus (and common uBlock Origin) option names
+quint32 typeMask(const QString& name) {
+    if (name == "xmlhttprequest" || name == "xhr") {
+        return typeBit("xhr") | typeBit("fetch");
+    }
+    if (name == "css") {
+        return typeBit("stylesheet");
+    }
+    if (name == "js") {
+        return typeBit("script");
+    }
+    if (name == "frame") {
+        return typeBit("subdocument");
+    }
+    if (name == "object" || name == "object-subrequest" || name == "ping") {
+        return typeBit("other");
+    }
+    return typeBit(name.toLatin1().constData());
+}
+
+// The rule pattern as a JavaScript regular expression, matched against the whole URL
+QString regexSource(const QString& pattern) {
+    if (pattern.size() > 2 && pattern.startsWith('/') && pattern.endsWith('/')) {
+        return pattern.mid(1, pattern.size() - 2);
+    }
+    static const QString special("\\.+?()[]{}|$");
+    QString source;
+    int begin = 0;
+    int end = pattern.size();
+    if (pattern.startsWith("||")) {
+        source = "^[a-z][a-z0-9+.-]*:/+(?:[^/?#]*\\.)?"; // Scheme, then the host or any of its subdomains
+        begin = 2;
+    } else if (pattern.startsWith('|')) {
+        source = "^";
+        begin = 1;
+    }
+    const bool anchoredEnd = end > begin && pattern.endsWith('|');
+    if (anchoredEnd) {
+        --end;
+    }
+    for (int i = begin; i < end; ++i) {
+        const QChar c = pattern.at(i);
+        if (c == '*') {
+            source += ".*";
+        } else if (c == '^') {
+            source += "(?:[^\\w\\-.%]|$)"; // Separator: anything but a letter, digit or one of _-.%, or the end
+        } else {
+            if (special.contains(c)) {
+                source += '\\';
+            }
+            source += c;
+        }
+    }
+    if (anchoredEnd) {
+        source += '$';
+    }
+    return source;
+}
+
+// The longest literal run of the pattern; every URL the pattern matches contains it
+QString keywordOf(const QString& pattern) {
+    if (pattern.startsWith('/') && pattern.endsWith('/')) {
+        return QString();
+    }
+    static const QRegularExpression wildcards("[*^|]");
+    QString keyword;
+    for (const QString& part : pattern.split(wildcards, QString::SkipEmptyParts)) {
+        if (part.size() > keyword.size()) {
+            keyword = part;
+        }
+    }
+    for (const QChar c : keyword) {
+        if (c.unicode() > 0x7f) {
+            return QString(); // URLs reach the backend percent-encoded, so this would never match literally
+        }
+    }
+    return keyword.size() >= MinKeywordLength ? keyword.toLower() : QString();
+}
+
+}
+
+UrlFilter::UrlFilter()
+    : m_blockedTypes(0)
+    , m_skipped(0) { }
+
+void UrlFilter::addRules(const QString& text) {
+    for (const QString& line : text.split('\n')) {
+        const QString trimmed = line.trimmed();
+        const bool comment = trimmed.startsWith('!') || trimmed.startsWith('[')
+            || (trimmed.startsWith('#') && !trimmed.startsWith("##") && !trimmed.startsWith("#@#"));
+        if (trimmed.isEmpty() || comment) {
+            continue;
+        }
+        Rule rule;
+        if (parseRule(trimmed, &rule)) {
+            m_rules.append(rule);
+        } else {
+            ++m_skipped;
+        }
+    }
+}
+
+void UrlFilter::addDomains(const QStringList& domains) {
+    for (const QString& domain : domains) {
+        Rule rule;
+        rule.host = domain.trimmed().toLower();
+        rule.types = DefaultTypes;
+        if (!rule.host.isEmpty()) {
+            m_rules.append(rule);
+        }
+    }
+}
+
+void UrlFilter::addResourceTypes(const QStringList& types) {
+    for (const QString& type : types) {
+        const quint32 mask = typeMask(type.trimmed().toLower());
+        if (mask) {
+            m_blockedTypes |= mask;
+        } else {
+            ++m_skipped;
+        }
+    }
+}
+
+bool UrlFilter::parseRule(const QString& line, Rule* rule) const {
+    static const QRegularExpression hostsLine("^(?:0\\.0\\.0\\.0|127\\.0\\.0\\.1|::1?)\\s+([^\\s#]+)");
+    static const QRegularExpression hostOnly("^\\|\\|([a-z0-9.-]+)\\^$");
+
+    rule->types = DefaultTypes;
+    const QRegularExpressionMatch hosts = hostsLine.match(line);
+    if (hosts.hasMatch()) {
+        rule->host = hosts.captured(1).toLower();
+        return rule->host != "localhost" && rule->host != "0.0.0.0";
+    }
+    if (line.contains("##") || line.contains("#@#") || line.contains("#?#") || line.contains("#$#")) {
+        return false; // Element hiding and scriptlets act on the document, not on requests
+    }
+
+    QString text = line;
+    if (text.startsWith("@@")) {
+        rule->exception = true;
+        text = text.mid(2);
+    }
+    // Options follow the last '$', unless that '$' is part of a /regex/
+    int dollar = text.lastIndexOf('$');
+    if (text.startsWith('/') && dollar >= 0 && dollar < text.lastIndexOf('/')) {
+        dollar = -1;
+    }
+    if (dollar >= 0) {
+        if (!parseOptions(text.mid(dollar + 1), rule)) {
+            return false;
+        }
+        text = text.left(dollar);
+    }
+
+    const QRegularExpressionMatch host = hostOnly.match(text.toLower());
+    if (host.hasMatch() && !rule->matchCase) {
+        rule->host = host.captured(1);
+        return true;
+    }
+    rule->pattern = regexSource(text);
+    rule->keyword = keywordOf(text);
+    return true;
+}
+
+bool UrlFilter::parseOptions(const QString& options, Rule* rule) const {
+    quint32 included = 0;
+    quint32 excluded = 0;
+    for (const QString& option : options.toLower().split(',', QString::SkipEmptyParts)) {
+        const bool negated = option.startsWith('~');
+        const QString name = negated ? option.mid(1) : option;
+        if (name == "third-party" || name == "3p") {
+            rule->party = negated ? 1 : 2;
+        } else if (name == "first-party" || name == "1p") {
+            rule->party = negated ? 2 : 1;
+        } else if (name == "match-case") {
+            rule->matchCase = true;
+        } else if (name == "important") {
+            // Exceptions always win here; there is no separate precedence to raise
+        } else if (name.startsWith("domain=")) {
+            for (const QString& domain : name.mid(7).split('|', QString::SkipEmptyParts)) {
+                if (domain.startsWith('~')) {
+                    rule->excludedDomains.append(domain.mid(1));
+                } else {
+                    rule->domains.append(domain);
+                }
+            }
+        } else if (const quint32 mask = typeMask(name)) {
+            (negated ? excluded : included) |= mask;
+        } else {
+            return false; // popup, csp, redirect, ...: nothing a request filter can honour
+        }
+    }
+    rule->types = (included ? included : DefaultTypes) & ~excluded;
+    return rule->types != 0;
+}
+
+QVariantMap UrlFilter::compile() const {
+    QVector<bool> indexed(m_rules.size(), false);
+    QVariantMap tables;
+
+    QStringList typeNames;
+    for (int i = 0; i < ResourceTypeCount; ++i) {
+        typeNames.append(QString::fromLatin1(ResourceTypeNames[i]));
+    }
+    tables.insert("typeNames", typeNames);
+    tables.insert("blockedTypes", static_cast<int>(m_blockedTypes));
+    tables.insert("trie", compileDomainTrie(&indexed));
+    tables.insert("keywords", compileKeywords(&indexed));
+
+    QVariantList rules;
+    QVariantList fallback; // Rules neither the trie nor the automaton can find, tested for every request
+    for (int i = 0; i < m_rules.size(); ++i) {
+        const Rule& rule = m_rules.at(i);
+        QVariantMap entry { { "types", static_cast<int>(rule.types) } };
+        if (!rule.pattern.isEmpty() || rule.host.isEmpty()) {
+            entry.insert("pattern", rule.pattern);
+        }
+        if (rule.exception) {
+            entry.insert("exception", true);
+        }
+        if (rule.matchCase) {
+            entry.insert("matchCase", true);
+        }
+        if (rule.party) {
+            entry.insert("party", rule.party);
+        }
+        if (!rule.domains.isEmpty()) {
+            entry.insert("domains", rule.domains);
+        }
+        if (!rule.excludedDomains.isEmpty()) {
+            entry.insert("excludedDomains", rule.excludedDomains);
+        }
+        rules.append(entry);
+        if (!indexed.at(i)) {
+            fallback.append(i);
+        }
+    }
+    tables.insert("rules", rules);
+    tables.insert("fallback", fallback);
+    return tables;
+}
+
+// Host labels from the top-level domain down; a node's rules apply to its host and every host below it.
+// Children are sorted by label so the backend can binary-search them.
+QVariantMap UrlFilter::compileDomainTrie(QVector<bool>* indexed) const {
+    struct Node {
+        QMap<QString, int> children;
+        QList<int> rules;
+    };
+    QVector<Node> nodes(1);
+    for (int i = 0; i < m_rules.size(); ++i) {
+        const Rule& rule = m_rules.at(i);
+        if (rule.host.isEmpty() || !rule.pattern.isEmpty()) {
+            continue;
+        }
+        const QStringList labels = rule.host.split('.', QString::SkipEmptyParts);
+        int node = 0;
+        for (int l = labels.size() - 1; l >= 0; --l) {
+            int child = nodes.at(node).children.value(labels.at(l), -1);
+            if (child < 0) {
+                child = nodes.size();
+                nodes.append(Node());
+                nodes[node].children.insert(labels.at(l), child);
+            }
+            node = child;
+        }
+        nodes[node].rules.append(i);
+        (*indexed)[i] = true;
+    }
+
+    QVariantList childStart, labels, children, ruleStart, rules;
+    for (const Node& node : nodes) {
+        childStart.append(labels.size());
+        ruleStart.append(rules.size());
+        for (auto it = node.children.constBegin(); it != node.children.constEnd(); ++it) {
+            labels.append(it.key());
+            children.append(it.value());
+        }
+        for (int rule : node.rules) {
+            rules.append(rule);
+        }
+    }
+    childStart.append(labels.size());
+    ruleStart.append(rules.size());
+    return QVariantMap { { "childStart", childStart }, { "labels", labels }, { "children", children },
+        { "ruleStart", ruleStart }, { "rules", rules } };
+}
+
+// Aho-Corasick automaton over the rule keywords (ASCII, lowercase). States are numbered breadth-first from the
+// root (0). `fail` is the longest proper suffix state, `outLink` the nearest state along the fail chain that ends
+// a keyword (-1 if none), so the backend can enumerate every keyword ending at a position without merged lists.
+QVariantMap UrlFilter::compileKeywords(QVector<bool>* indexed) const {
+    struct State {
+        QMap<int, int> next;
+        QList<int> rules;
+    };
+    QVector<State> states(1);
+    for (int i = 0; i < m_rules.size(); ++i) {
+        const Rule& rule = m_rules.at(i);
+        if (rule.keyword.isEmpty() || !rule.host.isEmpty()) {
+            continue;
+        }
+        int state = 0;
+        for (const QChar c : rule.keyword) {
+            int target = states.at(state).next.value(c.unicode(), -1);
+            if (target < 0) {
+                target = states.size();
+                states.append(State());
+                states[state].next.insert(c.unicode(), target);
+            }
+            state = target;
+        }
+        states[state].rules.append(i);
+        (*indexed)[i] = true;
+    }
+
+    // Renumber breadth-first while computing the failure links, so a state's fail and outLink targets (which
+    // are shallower) always precede it.
+    QVector<int> order { 0 };
+    QVector<int> fail(states.size(), 0);
+    QVector<int> outLink(states.size(), -1);
+    for (int head = 0; head < order.size(); ++head) {
+        const int s = order.at(head);
+        for (auto it = states.at(s).next.constBegin(); it != states.at(s).next.constEnd(); ++it) {
+            const int t = it.value();
+            order.append(t);
+            if (s != 0) {
+                int f = fail.at(s);
+                while (f != 0 && !states.at(f).next.contains(it.key())) {
+                    f = fail.at(f);
+                }
+                fail[t] = states.at(f).next.value(it.key(), 0);
+            }
+            outLink[t] = states.at(fail.at(t)).rules.isEmpty() ? outLink.at(fail.at(t)) : fail.at(t);
+        }
+    }
+    QVector<int> number(states.size());
+    for (int i = 0; i < order.size(); ++i) {
+        number[order.at(i)] = i;
+    }
+
+    QVariantList edgeStart, edgeChars, edgeTargets, failLinks, outLinks, outStart, outRules;
+    for (int s : order) {
+        const State& state = states.at(s);
+        edgeStart.append(edgeChars.size());
+        outStart.append(outRules.size());
+        for (auto it = state.next.constBegin(); it != state.next.constEnd(); ++it) {
+            edgeChars.append(it.key());
+            edgeTargets.append(number.at(it.value()));
+        }
+        for (int rule : state.rules) {
+            outRules.append(rule);
+        }
+        failLinks.append(number.at(fail.at(s)));
+        outLinks.append(outLink.at(s) < 0 ? -1 : number.at(outLink.at(s)));
+    }
+    edgeStart.append(edgeChars.size());
+    outStart.append(outRules.size());
+    return QVariantMap { { "edgeStart", edgeStart }, { "edgeChars", edgeChars }, { "edgeTargets", edgeTargets },
+        { "fail", failLinks }, { "outLink", outLinks }, { "outStart", outStart }, { "outRules", outRules } };
+}
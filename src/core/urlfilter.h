@@ -0,0 +1,64 @@
+#ifndef URLFILTER_H
+#define URLFILTER_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+
+// Compiles request blocking rules into flat tables that the backend matches every request against locally, so
+// filtering a request never costs a round-trip to C++.
+//
+// Rules use the Adblock Plus filter syntax (||host^, |anchors|, * and ^ wildcards, /regex/, @@exceptions and the
+// resource type, third-party, match-case and domain= options); hosts-file lines ("0.0.0.0 host") are accepted too.
+// Element hiding rules and options the backend cannot evaluate (popup, csp, redirect, ...) are skipped.
+//
+// compile() produces:
+//  - a domain trie over reversed host labels for host-only rules (||host^ and explicit domains), so a request
+//    costs one lookup per label of its host;
+//  - an Aho-Corasick automaton over the longest literal fragment of every other rule, so one pass over the URL
+//    finds the few rules worth testing with their full pattern;
+//  - the rules themselves (pattern as a regular expression, type mask, options), referenced by index.
+class UrlFilter {
+public:
+    UrlFilter();
+
+    // Adblock Plus filter list text, one rule per line.
+    void addRules(const QString& text);
+    // Blocks these hosts and their subdomains.
+    void addDomains(const QStringList& domains);
+    // Blocks every request of these types (Playwright or Adblock names: "font", "media", "image", "xmlhttprequest").
+    void addResourceTypes(const QStringList& types);
+
+    bool isEmpty() const { return m_rules.isEmpty() && m_blockedTypes == 0; }
+    int ruleCount() const { return m_rules.size(); }
+    int skippedCount() const { return m_skipped; }
+
+    // Tables for the backend's matcher (requestFilter in playwright_backend.js).
+    QVariantMap compile() const;
+
+private:
+    struct Rule {
+        QString pattern; // JavaScript regular expression source; empty for host-only rules
+        QString keyword; // Lowercase literal every matching URL contains; empty if there is none worth indexing
+        QString host; // Set for host-only rules, which go into the domain trie
+        bool exception = false;
+        bool matchCase = false;
+        quint32 types = 0;
+        int party = 0; // 0: any, 1: first-party only, 2: third-party only
+        QStringList domains; // domain= option: the page's host must be (under) one of these...
+        QStringList excludedDomains; // ...and none of these
+    };
+
+    bool parseRule(const QString& line, Rule* rule) const;
+    bool parseOptions(const QString& options, Rule* rule) const;
+    QVariantMap compileDomainTrie(QVector<bool>* indexed) const;
+    QVariantMap compileKeywords(QVector<bool>* indexed) const;
+
+    QList<Rule> m_rules;
+    quint32 m_blockedTypes;
+    int m_skipped;
+};
+
+#endif // URLFILTER_H
@@ -3,6 +3,13 @@
 #include "cookiejar.h"
 #include "terminal.h"
 #include "utils.h"
+#include "imageencoder.h"
+#include "imagescaler.h"
+#include "tiledframebuffer.h"
+#include "pngstreamwriter.h"
+#include "pdfmerger.h"
+#include "screencastwriter.h"
+#include "urlfilter.h"
 #include "playwrightenginebackend.h"
 #include "pagesettings.h" // Include the new page settings constants
 
@@ -16,6 +23,14 @@
 #include <QScreen>
 #include <QDebug>
 #include <QBuffer>
+#include <QMetaMethod>
+#include <QTemporaryDir>
+#include <QThread>
+
+namespace {
+const int DefaultTemplateTimeout = 3000; // ms a template gets to signal that it is ready
+const int DefaultInterceptDeadline = 500; // ms an intercepted request waits for onResourceRequested
+}
 
 WebPage::WebPage(QObject* parent, const QUrl& baseUrl, IEngineBackend* backend)
     : QObject(parent)
@@ -52,7 +67,14 @@ WebPage::WebPage(QObject* parent, const QUrl& baseUrl, IEngineBackend* backend)
     , m_cachedFramesCount(0)
     , m_cachedFramesName()
     , m_cachedFrameName("")
-    , m_cachedFocusedFrameName("") {
+    , m_cachedFocusedFrameName("")
+    , m_framebuffer(nullptr)
+    , m_repaintTracking(false)
+    , m_incrementalGeneration(0)
+    , m_screencast(nullptr)
+    , m_requestInterception(false)
+    , m_resourceForwardingPending(false)
+    , m_interceptDeadline(DefaultInterceptDeadline) {
     connect(m_engineBackend, &IEngineBackend::loadStarted, this, &WebPage::handleEngineLoadStarted);
     connect(m_engineBackend, &IEngineBackend::loadFinished, this, &WebPage::handleEngineLoadFinished);
     connect(m_engineBackend, &IEngineBackend::loadingProgress, this, &WebPage::handleEngineLoadingProgress);
@@ -66,12 +88,13 @@ WebPage::WebPage(QObject* parent, const QUrl& baseUrl, IEngineBackend* backend)
     connect(m_engineBackend, &IEngineBackend::javaScriptConsoleMessageSent, this,
         &WebPage::handleEngineJavaScriptConsoleMessageSent);
     connect(m_engineBackend, &IEngineBackend::javaScriptErrorSent, this, &WebPage::handleEngineJavaScriptErrorSent);
-    connect(m_engineBackend, &IEngineBackend::resourceRequested, this, &WebPage::handleEngineResourceRequested);
-    connect(m_engineBackend, &IEngineBackend::resourceReceived, this, &WebPage::handleEngineResourceReceived);
-    connect(m_engineBackend, &IEngineBackend::resourceError, this, &WebPage::handleEngineResourceError);
-    connect(m_engineBackend, &IEngineBackend::resourceTimeout, this, &WebPage::handleEngineResourceTimeout);
+    // resource* signals are connected on demand, see updateResourceForwarding()
     connect(m_engineBackend, &IEngineBackend::repaintRequested, this, &WebPage::handleEngineRepaintRequested);
+    connect(m_engineBackend, &IEngineBackend::pdfProgress, this, &WebPage::handleEnginePdfProgress);
+    connect(m_engineBackend, &IEngineBackend::screencastFrame, this, &WebPage::handleEngineScreencastFrame);
     connect(m_engineBackend, &IEngineBackend::initialized, this, &WebPage::handleEngineInitialized);
+    connect(m_engineBackend, &IEngineBackend::healthChanged, this, &WebPage::handleEngineHealthChanged);
+    connect(m_engineBackend, &IEngineBackend::backendRestarted, this, &WebPage::handleEngineBackendRestarted);
 
     connect(m_engineBackend, &IEngineBackend::javaScriptConfirmRequested, this,
         &WebPage::handleEngineJavaScriptConfirmRequested);
@@ -83,23 +106,115 @@ WebPage::WebPage(QObject* parent, const QUrl& baseUrl, IEngineBackend* backend)
 
     if (backend == nullptr && !baseUrl.isEmpty() && baseUrl != QUrl("about:blank")) {
         qDebug() << "WebPage: Initial load of base URL:" << baseUrl;
-        m_engineBackend->load(QNetworkRequest(baseUrl), QNetworkAccessManager::GetOperation, QByteArray());
+        m_engineBackend->load(
+            QNetworkRequest(baseUrl), QNetworkAccessManager::GetOperation, QByteArray(), QVariantMap());
     }
 }
 
 WebPage::~WebPage() {
     qDebug() << "WebPage: Destructor called.";
     emit closing(this);
+    delete m_framebuffer;
+    delete m_screencast; // Finishes writing whatever is still queued
 }
 
 IEngineBackend* WebPage::engineBackend() const { return m_engineBackend; }
 
+bool WebPage::backendHealthy() const { return m_engineBackend->isHealthy(); }
+
+// Resource events make up most of the backend traffic. Forwarding them from the engine only while this page's own
+// resource* signals have listeners lets the backend skip decoding events nobody asked for.
+//
+// connectNotify() and disconnectNotify() may run with QObject's internal lock held and must not call back into
+// QObject, so they only schedule a re-evaluation. Navigations apply a pending one first, so that e.g. an
+// onResourceRequested set right before open() intercepts that load's requests.
+void WebPage::connectNotify(const QMetaMethod& signal) {
+    QObject::connectNotify(signal);
+    scheduleResourceForwarding(signal);
+}
+
+void WebPage::disconnectNotify(const QMetaMethod& signal) {
+    QObject::disconnectNotify(signal);
+    scheduleResourceForwarding(signal);
+}
+
+void WebPage::scheduleResourceForwarding(const QMetaMethod& signal) {
+    // An invalid method means "all signals" (QObject::disconnect() without arguments)
+    if (signal.isValid() && signal != QMetaMethod::fromSignal(&WebPage::resourceRequested)
+        && signal != QMetaMethod::fromSignal(&WebPage::resourceReceived)
+        && signal != QMetaMethod::fromSignal(&WebPage::resourceError)
+        && signal != QMetaMethod::fromSignal(&WebPage::resourceTimeout)
+        && signal != QMetaMethod::fromSignal(&WebPage::repaintRequested)) {
+        return;
+    }
+    if (!m_resourceForwardingPending) {
+        m_resourceForwardingPending = true;
+        QMetaObject::invokeMethod(this, "updateResourceForwarding", Qt::QueuedConnection);
+    }
+}
+
+void WebPage::flushResourceForwarding() {
+    if (m_resourceForwardingPending) {
+        updateResourceForwarding();
+    }
+}
+
+void WebPage::updateResourceForwarding() {
+    if (!m_resourceForwardingPending) {
+        return; // Already applied by a navigation
+    }
+    m_resourceForwardingPending = false;
+
+    // Requests only wait for a decision from this side while onResourceRequested is set; otherwise the backend
+    // doesn't intercept them at all.
+    const bool intercept = isSignalConnected(QMetaMethod::fromSignal(&WebPage::resourceRequested));
+    if (intercept) {
+        connect(m_engineBackend, &IEngineBackend::resourceRequested, this, &WebPage::handleEngineResourceRequested,
+            Qt::UniqueConnection);
+    } else {
+        disconnect(m_engineBackend, &IEngineBackend::resourceRequested, this, &WebPage::handleEngineResourceRequested);
+    }
+    if (intercept != m_requestInterception) {
+        m_requestInterception = intercept;
+        m_engineBackend->setRequestInterception(intercept, m_interceptDeadline);
+    }
+    if (isSignalConnected(QMetaMethod::fromSignal(&WebPage::resourceReceived))) {
+        connect(m_engineBackend, &IEngineBackend::resourceReceived, this, &WebPage::handleEngineResourceReceived,
+            Qt::UniqueConnection);
+    } else {
+        disconnect(m_engineBackend, &IEngineBackend::resourceReceived, this, &WebPage::handleEngineResourceReceived);
+    }
+    if (isSignalConnected(QMetaMethod::fromSignal(&WebPage::resourceError))) {
+        connect(m_engineBackend, &IEngineBackend::resourceError, this, &WebPage::handleEngineResourceError,
+            Qt::UniqueConnection);
+    } else {
+        disconnect(m_engineBackend, &IEngineBackend::resourceError, this, &WebPage::handleEngineResourceError);
+    }
+    if (isSignalConnected(QMetaMethod::fromSignal(&WebPage::resourceTimeout))) {
+        connect(m_engineBackend, &IEngineBackend::resourceTimeout, this, &WebPage::handleEngineResourceTimeout,
+            Qt::UniqueConnection);
+    } else {
+        disconnect(m_engineBackend, &IEngineBackend::resourceTimeout, this, &WebPage::handleEngineResourceTimeout);
+    }
+    updateRepaintTracking();
+}
+
+// Repaint events are wanted by onRepaintRequested listeners and by the incremental capture framebuffer.
+void WebPage::updateRepaintTracking() {
+    const bool wanted = m_framebuffer || isSignalConnected(QMetaMethod::fromSignal(&WebPage::repaintRequested));
+    if (wanted != m_repaintTracking) {
+        m_repaintTracking = wanted;
+        m_engineBackend->setRepaintTracking(wanted);
+    }
+}
+
 QString WebPage::content() const {
     m_cachedContent = m_engineBackend->toHtml();
     return m_cachedContent;
 }
 void WebPage::setContent(const QString& content) { setContent(content, QUrl()); }
 void WebPage::setContent(const QString& content, const QString& baseUrl) {
+    flushResourceForwarding();
     m_engineBackend->setHtml(content, QUrl(baseUrl));
     m_cachedContent = content;
 }
@@ -157,7 +272,10 @@ bool WebPage::goBack() { return m_engineBackend->goBack(); }
 bool WebPage::canGoForward() { return m_engineBackend->canGoForward(); }
 bool WebPage::goForward() { return m_engineBackend->goForward(); }
 bool WebPage::go(int historyItemRelativeIndex) { return m_engineBackend->goToHistoryItem(historyItemRelativeIndex); }
-void WebPage::reload() { m_engineBackend->reload(); }
+void WebPage::reload() {
+    flushResourceForwarding();
+    m_engineBackend->reload();
+}
 void WebPage::stop() { m_engineBackend->stop(); }
 void WebPage::openUrl(const QString& address, const QVariant& op, const QVariantMap& settings) {
     QUrl url = address.startsWith("http") || address.startsWith("file") ? QUrl(address) : QUrl::fromLocalFile(address);
@@ -199,7 +317,15 @@ void WebPage::openUrl(const QString& address, const QVariant& op, const QVariant
             request.setRawHeader(it.key().toUtf8(), it.value().toByteArray());
         }
     }
-    m_engineBackend->load(request, operation, body);
+
+    // A bare event name is shorthand for { event }.
+    const QVariant waitUntil = settings.value(PAGE_SETTINGS_WAIT_UNTIL);
+    QVariantMap strategy = waitUntil.toMap();
+    if (waitUntil.type() == QVariant::String) {
+        strategy.insert("event", waitUntil.toString());
+    }
+    flushResourceForwarding();
+    m_engineBackend->load(request, operation, body, strategy);
 }
 
 bool WebPage::render(const QString& fileName, const QVariantMap& option) {
@@ -208,9 +334,11 @@ bool WebPage::render(const QString& fileName, const QVariantMap& option) {
         return false;
     }
 
-    QString format = option.value(PAGE_SETTINGS_FORMAT, "png").toString().toLower();
+    QString format = option.value(PAGE_SETTINGS_FORMAT).toString().toLower();
+    if (format.isEmpty()) {
+        format = QFileInfo(fileName).suffix().toLower() == "pdf" ? "pdf" : "png";
+    }
     bool onlyViewport = option.value(PAGE_SETTINGS_ONLY_VIEWPORT, false).toBool();
-    QPoint scrollPosition = m_engineBackend->scrollPosition();
 
     QRect clipRect;
     if (option.contains(PAGE_SETTINGS_CLIP_RECT)) {
@@ -221,47 +349,472 @@ bool WebPage::render(const QString& fileName, const QVariantMap& option) {
         clipRect = m_engineBackend->clipRect();
     }
 
-    QByteArray renderedData;
     if (format == "pdf") {
-        renderedData = m_engineBackend->renderPdf(m_paperSize, clipRect);
-        if (renderedData.isEmpty()) {
-            Terminal::instance()->cerr("WebPage::render: PDF rendering failed or returned empty data.");
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly)) {
+            Terminal::instance()->cerr("WebPage::render: Could not open file for writing: " + fileName);
             return false;
         }
-    } else {
-        renderedData = m_engineBackend->renderImage(clipRect, onlyViewport, scrollPosition);
-        if (renderedData.isEmpty()) {
-            Terminal::instance()->cerr("WebPage::render: Image rendering failed or returned empty data.");
+        // Streamed straight into the file, so even a very long document is never held in memory as a whole.
+        m_renderingFileName = fileName;
+        const bool streamed = m_engineBackend->renderPdfToDevice(m_paperSize, &file);
+        m_renderingFileName.clear();
+        if (!streamed && file.size() > 0) {
+            file.remove();
+            Terminal::instance()->cerr("WebPage::render: PDF streaming failed part way: " + fileName);
             return false;
         }
+        if (!streamed) {
+            // Nothing arrived (e.g. no streaming support in the engine); fall back to the buffered path.
+            const QByteArray renderedData = m_engineBackend->renderPdf(m_paperSize, clipRect);
+            if (renderedData.isEmpty()) {
+                file.remove();
+                Terminal::instance()->cerr("WebPage::render: PDF rendering failed or returned empty data.");
+                return false;
+            }
+            file.write(renderedData);
+        }
+        file.close();
+        qDebug() << "WebPage::render: Saved to" << fileName;
+        return true;
+    }
+
+    if (option.value(PAGE_SETTINGS_INCREMENTAL, false).toBool() && format != "pdf") {
+        return renderIncremental(fileName, option);
+    }
+    if (option.value(PAGE_SETTINGS_TILED, false).toBool() && !onlyViewport) {
+        if (ImageEncodeJob::fromOptions(option, fileName).format == "png") {
+            return renderTiled(fileName, option, clipRect);
+        }
+        Terminal::instance()->cerr("WebPage::render: Tiled capture writes PNG only, capturing " + fileName + " whole.");
+    }
+
+    if (onlyViewport && option.value(PAGE_SETTINGS_FAST, false).toBool() && renderFast(fileName, option, clipRect)) {
+        return true;
+    }
+
+    // Images are captured once and encoded here, so one capture can feed several outputs, each encoded on its
+    // own thread.
+    const QPoint scrollPosition = m_engineBackend->scrollPosition();
+    const QImage frame = m_engineBackend->captureFrame(clipRect, onlyViewport, scrollPosition);
+    if (frame.isNull()) {
+        Terminal::instance()->cerr("WebPage::render: Image rendering failed or returned empty data.");
+        return false;
+    }
+
+    QList<ImageEncodeJob> jobs;
+    jobs.append(ImageEncodeJob::fromOptions(option, fileName));
+    jobs.append(ImageEncodeJob::thumbnailsFromOptions(option.value(PAGE_SETTINGS_THUMBNAIL), jobs.first()));
+    for (const QVariant& output : option.value(PAGE_SETTINGS_OUTPUTS).toList()) {
+        const QVariantMap outputOptions = output.toMap();
+        jobs.append(ImageEncodeJob::fromOptions(outputOptions, outputOptions.value("file").toString()));
+    }
+
+    if (!ImageEncoder::encode(frame, jobs)) {
+        for (const ImageEncodeJob& job : jobs) {
+            if (!job.error.isEmpty()) {
+                Terminal::instance()->cerr("WebPage::render: " + job.fileName + ": " + job.error);
+            }
+        }
+        return false;
     }
 
+    qDebug() << "WebPage::render: Saved" << jobs.size() << "image(s), first to" << fileName;
+    return true;
+}
+
+bool WebPage::renderViewports(const QVariantList& viewports, const QVariantMap& options) {
+    QList<QSize> sizes;
+    QList<QVariantMap> entries;
+    for (const QVariant& viewport : viewports) {
+        const QVariantMap entry = viewport.toMap();
+        const QSize size(entry.value("width").toInt(), entry.value("height").toInt());
+        if (size.isEmpty() || entry.value("file").toString().isEmpty()) {
+            Terminal::instance()->cerr("WebPage::renderViewports: Each viewport needs a width, height and file.");
+            return false;
+        }
+        sizes.append(size);
+        entries.append(entry);
+    }
+
+    const bool onlyViewport = options.value(PAGE_SETTINGS_ONLY_VIEWPORT, false).toBool();
+    const int settleTime = options.value(PAGE_SETTINGS_SETTLE_TIME, 0).toInt();
+    const QList<QImage> frames = m_engineBackend->captureViewports(sizes, onlyViewport, settleTime);
+    if (frames.size() != sizes.size()) {
+        Terminal::instance()->cerr("WebPage::renderViewports: Capturing the viewports failed.");
+        return false;
+    }
+
+    // Entries take the same encoder keys as render() (format, quality, thumbnail, ...); `options` supplies defaults.
+    bool ok = true;
+    QList<QList<ImageEncodeJob>> jobsPerFrame;
+    for (const QVariantMap& entry : entries) {
+        QVariantMap merged = options;
+        for (auto it = entry.constBegin(); it != entry.constEnd(); ++it) {
+            merged.insert(it.key(), it.value());
+        }
+        merged.remove("width");
+        merged.remove("height");
+        QList<ImageEncodeJob> jobs;
+        jobs.append(ImageEncodeJob::fromOptions(merged, entry.value("file").toString()));
+        jobs.append(ImageEncodeJob::thumbnailsFromOptions(merged.value(PAGE_SETTINGS_THUMBNAIL), jobs.first()));
+        jobsPerFrame.append(jobs);
+    }
+    for (int i = 0; i < frames.size(); ++i) {
+        if (!ImageEncoder::encode(frames.at(i), jobsPerFrame[i])) {
+            ok = false;
+            for (const ImageEncodeJob& job : jobsPerFrame.at(i)) {
+                if (!job.error.isEmpty()) {
+                    Terminal::instance()->cerr("WebPage::renderViewports: " + job.fileName + ": " + job.error);
+                }
+            }
+        }
+    }
+    qDebug() << "WebPage::renderViewports: Captured" << frames.size() << "viewport(s) from one load";
+    return ok;
+}
+
+QVariantList WebPage::renderElements(const QVariantList& selectors, const QVariantMap& options) {
+    // A single capture of the area covering every element is cropped in C++, unless that area is so large that
+    // capturing the elements one by one is cheaper than holding it.
+    static const qint64 MaxSharedCapturePixels = 64LL * 1024 * 1024;
+
+    QStringList selectorList;
+    QList<QVariantMap> entries;
+    for (const QVariant& selector : selectors) {
+        QVariantMap entry = selector.type() == QVariant::String ? QVariantMap { { "selector", selector } }
+                                                                : selector.toMap();
+        selectorList.append(entry.value("selector").toString());
+        entries.append(entry);
+    }
+    const bool all = options.value("all", false).toBool();
+    const int padding = qMax(0, options.value("padding", 0).toInt());
+    const QList<QList<QRect>> matches = m_engineBackend->elementRects(selectorList, all);
+
+    QVariantList results;
+    QList<QRect> rects;
+    QList<ImageEncodeJob> jobs;
+    QRect area;
+    for (int i = 0; i < entries.size(); ++i) {
+        const QList<QRect> boxes = matches.value(i);
+        if (boxes.isEmpty()) {
+            results.append(QVariantMap { { "selector", selectorList.at(i) }, { "error", "no matching element" } });
+            continue;
+        }
+        QVariantMap entryOptions = options;
+        for (auto it = entries.at(i).constBegin(); it != entries.at(i).constEnd(); ++it) {
+            entryOptions.insert(it.key(), it.value());
+        }
+        for (int match = 0; match < boxes.size(); ++match) {
+            QRect rect = boxes.at(match).adjusted(-padding, -padding, padding, padding);
+            rect.setTopLeft(QPoint(qMax(0, rect.left()), qMax(0, rect.top()))); // Padding stops at the page edge
+            QString fileName = entryOptions.value("file").toString();
+            if (!fileName.isEmpty() && boxes.size() > 1) {
+                const QFileInfo info(fileName);
+                fileName = info.path() + "/" + info.completeBaseName() + "-" + QString::number(match)
+                    + (info.suffix().isEmpty() ? QString() : "." + info.suffix());
+            } else if (fileName.isEmpty() && options.contains("directory")) {
+                const QByteArray format = ImageEncodeJob::fromOptions(entryOptions).format;
+                fileName = options.value("directory").toString() + "/element-" + QString::number(i)
+                    + (boxes.size() > 1 ? "-" + QString::number(match) : QString()) + "." + format;
+            }
+            rects.append(rect);
+            jobs.append(ImageEncodeJob::fromOptions(entryOptions, fileName));
+            area |= rect;
+            results.append(QVariantMap { { "selector", selectorList.at(i) }, { "index", match },
+                { "rect",
+                    QVariantMap { { "left", rect.left() }, { "top", rect.top() }, { "width", rect.width() },
+                        { "height", rect.height() } } },
+                { "file", fileName } });
+        }
+    }
+    if (jobs.isEmpty()) {
+        return results;
+    }
+
+    const QPoint scrollPosition = m_engineBackend->scrollPosition();
+    QList<QImage> crops;
+    if (qint64(area.width()) * area.height() <= MaxSharedCapturePixels) {
+        const QImage frame = m_engineBackend->captureFrame(area, false, scrollPosition);
+        const qreal scale = frame.isNull() ? 0.0 : qreal(frame.width()) / area.width(); // Device pixel ratio
+        for (const QRect& rect : rects) {
+            const QRectF source = QRectF(rect.translated(-area.topLeft()));
+            crops.append(frame.copy(QRect(qRound(source.x() * scale), qRound(source.y() * scale),
+                qRound(source.width() * scale), qRound(source.height() * scale))));
+        }
+    } else {
+        for (const QRect& rect : rects) {
+            crops.append(m_engineBackend->captureFrame(rect, false, scrollPosition));
+        }
+    }
+    for (const QImage& crop : crops) {
+        if (crop.isNull()) {
+            Terminal::instance()->cerr("WebPage::renderElements: Capturing the elements failed.");
+            return QVariantList();
+        }
+    }
+
+    ImageEncoder::encode(crops, jobs);
+    int job = 0;
+    for (QVariant& result : results) {
+        QVariantMap map = result.toMap();
+        if (map.contains("error")) {
+            continue;
+        }
+        const ImageEncodeJob& encoded = jobs.at(job++);
+        if (!encoded.error.isEmpty()) {
+            map["error"] = encoded.error;
+            Terminal::instance()->cerr("WebPage::renderElements: " + encoded.fileName + ": " + encoded.error);
+        } else if (encoded.fileName.isEmpty()) {
+            map.remove("file");
+            map["data"] = QString::fromLatin1(encoded.data.toBase64());
+        }
+        result = map;
+    }
+    qDebug() << "WebPage::renderElements: Rendered" << jobs.size() << "element(s) from one capture";
+    return results;
+}
+
+// The fast path writes the browser's encoding as-is, so it only applies to a single PNG or JPEG output at the
+// viewport's own size; anything else goes through the encoder. Returns false to fall back to the regular capture.
+bool WebPage::renderFast(const QString& fileName, const QVariantMap& option, const QRect& clipRect) {
+    const ImageEncodeJob job = ImageEncodeJob::fromOptions(option, fileName);
+    if ((job.format != "png" && job.format != "jpeg") || job.size.isValid() || job.scale > 0
+        || option.contains(PAGE_SETTINGS_THUMBNAIL) || option.contains(PAGE_SETTINGS_OUTPUTS)) {
+        return false;
+    }
+    const QByteArray data = m_engineBackend->captureViewportFast(clipRect, job.format, job.quality);
+    if (data.isEmpty()) {
+        return false;
+    }
     QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly)) {
-        Terminal::instance()->cerr("WebPage::render: Could not open file for writing: " + fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+        Terminal::instance()->cerr("WebPage::render: Could not write " + fileName);
+        return false;
+    }
+    return true;
+}
+
+// Viewport capture through the tiled framebuffer: only tiles repainted since the previous call are captured again,
+// and an unchanged frame rendered to the same file again is not re-encoded at all.
+bool WebPage::renderIncremental(const QString& fileName, const QVariantMap& option) {
+    if (!m_framebuffer) {
+        m_framebuffer = new TiledFramebuffer(option.value(PAGE_SETTINGS_TILE_SIZE, 256).toInt());
+        updateRepaintTracking();
+    } else {
+        // A paint right before this capture may not have reached handleEngineRepaintRequested yet.
+        for (const QRect& dirtyRect : m_engineBackend->takeRepaints()) {
+            handleEngineRepaintRequested(dirtyRect);
+        }
+    }
+
+    QList<QRect> changed;
+    if (!m_framebuffer->update(m_engineBackend, m_engineBackend->scrollPosition(), &changed)) {
+        Terminal::instance()->cerr("WebPage::render: Incremental capture failed.");
         return false;
     }
-    file.write(renderedData);
-    file.close();
+    if (fileName == m_incrementalFileName && m_framebuffer->generation() == m_incrementalGeneration
+        && QFile::exists(fileName)) {
+        qDebug() << "WebPage::render: Viewport unchanged, kept" << fileName;
+        return true;
+    }
+
+    QList<ImageEncodeJob> jobs;
+    jobs.append(ImageEncodeJob::fromOptions(option, fileName));
+    jobs.append(ImageEncodeJob::thumbnailsFromOptions(option.value(PAGE_SETTINGS_THUMBNAIL), jobs.first()));
+    if (!ImageEncoder::encode(m_framebuffer->image(), jobs)) {
+        for (const ImageEncodeJob& job : jobs) {
+            if (!job.error.isEmpty()) {
+                Terminal::instance()->cerr("WebPage::render: " + job.fileName + ": " + job.error);
+            }
+        }
+        return false;
+    }
+    m_incrementalFileName = fileName;
+    m_incrementalGeneration = m_framebuffer->generation();
+    qDebug() << "WebPage::render: Saved" << fileName << "after re-capturing" << changed.size() << "rect(s)";
+    return true;
+}
 
-    qDebug() << "WebPage::render: Saved to" << fileName;
+// Full-page capture in fixed-height bands, each streamed straight into the PNG file, so peak memory is one band
+// however tall the page is. The page size is taken once up front; content that grows while capturing is cut off.
+bool WebPage::renderTiled(const QString& fileName, const QVariantMap& option, const QRect& clipRect) {
+    QRect area = clipRect;
+    if (area.isEmpty()) {
+        const QVariantMap size = m_engineBackend
+                                     ->evaluateJavaScript("({ width: document.documentElement.scrollWidth, "
+                                                          "height: document.documentElement.scrollHeight })")
+                                     .toMap();
+        area = QRect(0, 0, size.value("width").toInt(), size.value("height").toInt());
+    }
+    if (area.isEmpty()) {
+        Terminal::instance()->cerr("WebPage::render: Could not determine the page size for a tiled capture.");
+        return false;
+    }
+    const int bandHeight = qMax(1, option.value(PAGE_SETTINGS_BAND_HEIGHT, 2048).toInt());
+    const ImageEncodeJob job = ImageEncodeJob::fromOptions(option, fileName);
+
+    PngStreamWriter writer;
+    if (!writer.open(fileName, area.width(), area.height(), false, job.compressionLevel)) {
+        Terminal::instance()->cerr("WebPage::render: " + writer.errorString());
+        return false;
+    }
+    const QPoint scrollPosition = m_engineBackend->scrollPosition();
+    for (int top = area.top(); top <= area.bottom(); top += bandHeight) {
+        const QRect bandRect(area.left(), top, area.width(), qMin(bandHeight, area.bottom() + 1 - top));
+        QImage band = m_engineBackend->captureFrame(bandRect, false, scrollPosition);
+        if (band.isNull()) {
+            Terminal::instance()->cerr(
+                "WebPage::render: Capturing rows " + QString::number(top) + " and below failed.");
+            return false;
+        }
+        if (band.size() != bandRect.size()) {
+            band = ImageScaler::scale(band, bandRect.size()); // Device pixel ratio != 1
+        }
+        if (!writer.writeRows(band)) {
+            Terminal::instance()->cerr("WebPage::render: " + writer.errorString());
+            return false;
+        }
+    }
+    if (!writer.close()) {
+        Terminal::instance()->cerr("WebPage::render: " + writer.errorString());
+        return false;
+    }
+    qDebug() << "WebPage::render: Saved" << area.size() << "in" << (area.height() + bandHeight - 1) / bandHeight
+             << "band(s) to" << fileName;
     return true;
 }
 
-QString WebPage::renderBase64(const QByteArray& format) {
+// Large documents print in parallel: page ranges go to worker copies of the page in the backend and the parts are
+// merged here, object by object, into the target file.
+bool WebPage::renderPdfParallel(const QString& fileName, const QVariantMap& options) {
+    const int workers = qBound(1, options.value("workers", QThread::idealThreadCount()).toInt(), 16);
+    const int pagesPerPart = qMax(1, options.value("pagesPerPart", 16).toInt());
+
+    QTemporaryDir directory;
+    if (!directory.isValid()) {
+        Terminal::instance()->cerr("WebPage::renderPdfParallel: Could not create a temporary directory.");
+        return false;
+    }
+    const QStringList parts = m_engineBackend->renderPdfParts(m_paperSize, workers, pagesPerPart, directory.path());
+    if (parts.isEmpty()) {
+        Terminal::instance()->cerr("WebPage::renderPdfParallel: Rendering the page ranges failed.");
+        return false;
+    }
+
+    PdfMerger merger;
+    bool ok = merger.open(fileName);
+    for (int i = 0; ok && i < parts.size(); ++i) {
+        ok = merger.append(parts.at(i));
+        QFile::remove(parts.at(i)); // Keep at most one part on disk beyond the output
+        emit renderProgress(QVariantMap {
+            { "file", fileName }, { "bytesWritten", merger.bytesWritten() }, { "done", false } });
+    }
+    ok = ok && merger.close();
+    if (!ok) {
+        QFile::remove(fileName);
+        Terminal::instance()->cerr("WebPage::renderPdfParallel: " + merger.errorString());
+        return false;
+    }
+    emit renderProgress(
+        QVariantMap { { "file", fileName }, { "bytesWritten", QFileInfo(fileName).size() }, { "done", true } });
+    qDebug() << "WebPage::renderPdfParallel: Saved" << merger.pageCount() << "page(s) from" << parts.size()
+             << "part(s) to" << fileName;
+    return true;
+}
+
+bool WebPage::renderTemplate(const QVariantMap& data, const QString& fileName, const QVariantMap& options) {
+    if (!m_engineBackend->applyTemplateData(data, options.value("timeout", DefaultTemplateTimeout).toInt())) {
+        Terminal::instance()->cerr("WebPage::renderTemplate: The template did not accept the data.");
+        return false;
+    }
+    return render(fileName, options);
+}
+
+QVariantList WebPage::renderTemplateBatch(const QVariantList& jobs, const QVariantMap& options) {
+    // The backend writes the files itself; only formats the browser produces natively are accepted.
+    QVariantList results;
+    QVariantList backendJobs;
+    QList<int> backendIndexes;
+    for (const QVariant& job : jobs) {
+        const QVariantMap entry = job.toMap();
+        const QString fileName = entry.value("file").toString();
+        QString format = entry.value("format", options.value("format")).toString().toLower();
+        if (format.isEmpty()) {
+            format = QFileInfo(fileName).suffix().toLower();
+        }
+        if (format == "jpg") {
+            format = "jpeg";
+        }
+
+        QVariantMap result { { "file", fileName } };
+        if (fileName.isEmpty()) {
+            result.insert("error", "no file name");
+        } else if (format != "pdf" && format != "png" && format != "jpeg") {
+            result.insert("error", "unsupported format: " + format);
+        } else {
+            backendIndexes.append(results.size());
+            // The backend runs in a process of its own; make sure it writes where this script means.
+            const QString path = QFileInfo(fileName).absoluteFilePath();
+            backendJobs.append(QVariantMap { { "data", entry.value("data").toMap() }, { "file", path },
+                { "format", format }, { "quality", entry.value("quality", options.value("quality", -1)).toInt() } });
+        }
+        results.append(result);
+    }
+    if (backendJobs.isEmpty()) {
+        return results;
+    }
+
+    const int workers = qBound(1, options.value("workers", QThread::idealThreadCount()).toInt(), 16);
+    const QStringList errors = m_engineBackend->renderTemplateBatch(
+        backendJobs, workers, m_paperSize, options.value("timeout", DefaultTemplateTimeout).toInt());
+    for (int i = 0; i < backendIndexes.size(); ++i) {
+        // An empty reply means the batch as a whole failed (e.g. the backend went away)
+        const QString error = errors.size() == backendJobs.size() ? errors.at(i) : QString("rendering failed");
+        if (!error.isEmpty()) {
+            QVariantMap result = results.at(backendIndexes.at(i)).toMap();
+            result.insert("error", error);
+            results[backendIndexes.at(i)] = result;
+        }
+    }
+    return results;
+}
+
+QString WebPage::renderBase64(const QByteArray& format) { return renderBase64(format, QVariantMap()); }
+
+QString WebPage::renderBase64(const QByteArray& format, const QVariantMap& options) {
     QString fmt = QString::fromUtf8(format).toLower();
     QByteArray renderedData;
 
     QRect clipRect = m_engineBackend->clipRect();
-    QPoint scrollPosition = m_engineBackend->scrollPosition();
     bool onlyViewport
         = m_engineBackend->viewportSize()
               .isValid(); // This logic might need refinement if PAGE_SETTINGS_ONLY_VIEWPORT is used differently
 
+    // Same conditions as render()'s fast path: a plain PNG or JPEG the browser can produce itself
+    ImageEncodeJob fastJob = ImageEncodeJob::fromOptions(options);
+    fastJob.format = ImageEncoder::normalizeFormat(fmt.isEmpty() ? QString("png") : fmt);
+    const bool fast = options.value(PAGE_SETTINGS_FAST, false).toBool() && onlyViewport
+        && (fastJob.format == "png" || fastJob.format == "jpeg") && !fastJob.size.isValid() && fastJob.scale <= 0
+        && !options.contains(PAGE_SETTINGS_THUMBNAIL);
+
     if (fmt == "pdf") {
         renderedData = m_engineBackend->renderPdf(m_paperSize, clipRect);
+    } else if (fast) {
+        renderedData = m_engineBackend->captureViewportFast(clipRect, fastJob.format, fastJob.quality);
     } else {
-        renderedData = m_engineBackend->renderImage(clipRect, onlyViewport, scrollPosition);
+        const QImage frame = m_engineBackend->captureFrame(clipRect, onlyViewport, m_engineBackend->scrollPosition());
+        ImageEncodeJob job = ImageEncodeJob::fromOptions(options);
+        job.format = fmt.isEmpty() ? QByteArray("png") : ImageEncoder::normalizeFormat(fmt);
+        // A single thumbnail size replaces the scale/size options; there is only one string to return.
+        const QList<ImageEncodeJob> thumbnails
+            = ImageEncodeJob::thumbnailsFromOptions(options.value(PAGE_SETTINGS_THUMBNAIL), job);
+        if (!thumbnails.isEmpty()) {
+            job = thumbnails.first();
+        }
+        if (!frame.isNull() && ImageEncoder::encode(frame, job)) {
+            renderedData = job.data;
+        }
     }
 
     if (!renderedData.isEmpty()) {
@@ -271,6 +824,43 @@ QString WebPage::renderBase64(const QByteArray& format) {
     return QString();
 }
 
+bool WebPage::startScreencast(const QVariantMap& options) {
+    if (m_screencast) {
+        stopScreencast();
+    }
+    ScreencastWriter* writer = new ScreencastWriter(options.value("queueSize", 8).toInt());
+    if (!writer->open(options.value("file").toString())) {
+        Terminal::instance()->cerr("WebPage::startScreencast: " + writer->errorString());
+        delete writer;
+        return false;
+    }
+    m_screencast = writer;
+    const QSize maxSize(options.value("maxWidth", 0).toInt(), options.value("maxHeight", 0).toInt());
+    if (!m_engineBackend->startScreencast(
+            options.value("fps", 10).toInt(), options.value("quality", 80).toInt(), maxSize)) {
+        Terminal::instance()->cerr("WebPage::startScreencast: The backend could not start the screencast.");
+        stopScreencast();
+        return false;
+    }
+    return true;
+}
+
+QVariantMap WebPage::stopScreencast() {
+    if (!m_screencast) {
+        return QVariantMap();
+    }
+    m_engineBackend->stopScreencast();
+    m_screencast->finish();
+    const QVariantMap result { { "file", m_screencast->fileName() }, { "frames", m_screencast->framesWritten() },
+        { "dropped", m_screencast->framesDropped() } };
+    if (!m_screencast->errorString().isEmpty()) {
+        Terminal::instance()->cerr("WebPage::stopScreencast: " + m_screencast->errorString());
+    }
+    delete m_screencast;
+    m_screencast = nullptr;
+    return result;
+}
+
 void WebPage::setViewportSize(const QVariantMap& size) {
     m_cachedViewportSize = QSize(size.value("width").toInt(), size.value("height").toInt());
     m_engineBackend->setViewportSize(m_cachedViewportSize);
@@ -372,6 +962,11 @@ void WebPage::applySettings(const QVariantMap& def) {
         m_engineBackend->setResourceTimeout(def[PAGE_SETTINGS_RESOURCE_TIMEOUT].toInt());
     if (def.contains(PAGE_SETTINGS_MAX_AUTH_ATTEMPTS))
         m_engineBackend->setMaxAuthAttempts(def[PAGE_SETTINGS_MAX_AUTH_ATTEMPTS].toInt());
+    if (def.contains(PAGE_SETTINGS_INTERCEPT_DEADLINE)) {
+        m_interceptDeadline = qMax(1, def[PAGE_SETTINGS_INTERCEPT_DEADLINE].toInt());
+        if (m_requestInterception)
+            m_engineBackend->setRequestInterception(true, m_interceptDeadline);
+    }
 
     if (def.contains(PAGE_SETTINGS_OFFLINE_STORAGE_PATH))
         m_cachedOfflineStoragePath = def[PAGE_SETTINGS_OFFLINE_STORAGE_PATH].toString();
@@ -417,6 +1012,99 @@ QVariantMap WebPage::customHeaders() const {
     return m_cachedCustomHeaders;
 }
 
+QVariantMap WebPage::setRequestFilter(const QVariant& options) {
+    const QVariantMap map = options.toMap();
+    UrlFilter filter;
+    const QVariant rules = map.value("rules");
+    filter.addRules(rules.type() == QVariant::List ? rules.toStringList().join('\n') : rules.toString());
+    const QVariant files = map.value("rulesFile");
+    for (const QString& path : files.type() == QVariant::List ? files.toStringList() : QStringList(files.toString())) {
+        if (path.isEmpty()) {
+            continue;
+        }
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            Terminal::instance()->cerr("WebPage::setRequestFilter: Could not read " + path);
+            continue;
+        }
+        filter.addRules(QString::fromUtf8(file.readAll()));
+    }
+    filter.addDomains(map.value("domains").toStringList());
+    filter.addResourceTypes(map.value("resourceTypes").toStringList());
+
+    m_engineBackend->setRequestFilter(filter.isEmpty() ? QVariantMap() : filter.compile());
+    qDebug() << "WebPage::setRequestFilter:" << filter.ruleCount() << "rule(s)," << filter.skippedCount() << "skipped";
+    return QVariantMap { { "rules", filter.ruleCount() }, { "skipped", filter.skippedCount() } };
+}
+
+bool WebPage::startNetworkRecording(const QString& fileName) {
+    if (!m_networkRecording.isEmpty()) {
+        stopNetworkRecording();
+    }
+    // The backend runs in a process of its own; make sure it writes where this script means.
+    const QString path = QFileInfo(fileName).absoluteFilePath();
+    if (!m_engineBackend->startNetworkRecording(path)) {
+        Terminal::instance()->cerr("WebPage::startNetworkRecording: Could not write " + fileName);
+        return false;
+    }
+    m_networkRecording = path;
+    return true;
+}
+
+QVariantMap WebPage::stopNetworkRecording() {
+    if (m_networkRecording.isEmpty()) {
+        return QVariantMap();
+    }
+    const QVariantMap result { { "file", m_networkRecording },
+        { "responses", m_engineBackend->stopNetworkRecording() } };
+    m_networkRecording.clear();
+    return result;
+}
+
+bool WebPage::replayNetwork(const QString& fileName, const QVariantMap& options) {
+    const QString onMiss = options.value("onMiss", "fail").toString();
+    if (onMiss != "fail" && onMiss != "network") {
+        Terminal::instance()->cerr("WebPage::replayNetwork: onMiss must be \"fail\" or \"network\"");
+        return false;
+    }
+    const QString path = QFileInfo(fileName).absoluteFilePath();
+    const int responses = m_engineBackend->setNetworkReplay(path, onMiss == "network");
+    if (responses < 0) {
+        Terminal::instance()->cerr("WebPage::replayNetwork: " + fileName + " is not a readable network archive");
+        return false;
+    }
+    qDebug() << "WebPage::replayNetwork:" << responses << "response(s) in" << fileName;
+    return true;
+}
+
+void WebPage::stopNetworkReplay() { m_engineBackend->setNetworkReplay(QString(), false); }
+
+bool WebPage::startHar(const QString& fileName) {
+    if (!m_harFile.isEmpty()) {
+        stopHar();
+    }
+    const QString path = QFileInfo(fileName).absoluteFilePath();
+    if (!m_engineBackend->startHar(path)) {
+        Terminal::instance()->cerr("WebPage::startHar: Could not write " + fileName);
+        return false;
+    }
+    m_harFile = path;
+    return true;
+}
+
+QVariantMap WebPage::stopHar() {
+    if (m_harFile.isEmpty()) {
+        return QVariantMap();
+    }
+    const int entries = m_engineBackend->stopHar();
+    if (entries < 0) {
+        Terminal::instance()->cerr("WebPage::stopHar: Could not complete " + m_harFile);
+    }
+    const QVariantMap result { { "file", m_harFile }, { "entries", entries } };
+    m_harFile.clear();
+    return result;
+}
+
 void WebPage::setCookieJar(CookieJar* cookieJar) {
     m_cookieJar = cookieJar;
     m_engineBackend->setCookieJar(cookieJar);
@@ -573,6 +1261,9 @@ void WebPage::handleEngineLoadStarted(const QUrl& url) {
     qDebug() << "WebPage: Load started for URL:" << url;
     m_cachedUrl = url;
     m_loadingProgress = 0;
+    if (m_framebuffer) {
+        m_framebuffer->invalidateAll();
+    }
     emit loadStarted();
 }
 void WebPage::handleEngineLoadFinished(bool success, const QUrl& url) {
@@ -655,7 +1346,20 @@ void WebPage::handleEngineResourceReceived(const QVariantMap& responseData) { em
 void WebPage::handleEngineResourceError(const QVariantMap& errorData) { emit resourceError(errorData); }
 void WebPage::handleEngineResourceTimeout(const QVariantMap& errorData) { emit resourceTimeout(errorData); }
 
+void WebPage::handleEngineScreencastFrame(const QByteArray& jpeg, qreal timestamp) {
+    if (m_screencast) {
+        m_screencast->enqueue(jpeg, timestamp);
+    }
+}
+
+void WebPage::handleEnginePdfProgress(qint64 bytesWritten, bool done) {
+    emit renderProgress(QVariantMap {
+        { "file", m_renderingFileName }, { "bytesWritten", bytesWritten }, { "done", done } });
+}
 void WebPage::handleEngineRepaintRequested(const QRect& dirtyRect) {
+    if (m_framebuffer) {
+        m_framebuffer->invalidate(dirtyRect);
+    }
     emit repaintRequested(dirtyRect.x(), dirtyRect.y(), dirtyRect.width(), dirtyRect.height());
 }
 
@@ -664,6 +1368,16 @@ void WebPage::handleEngineInitialized() {
     emit initialized();
 }
 
+void WebPage::handleEngineHealthChanged(bool healthy) {
+    qDebug() << "WebPage: Engine backend health changed:" << healthy;
+    emit backendHealthChanged(healthy);
+}
+
+void WebPage::handleEngineBackendRestarted(int attempt) {
+    qWarning() << "WebPage: Engine backend restarted, attempt" << attempt;
+    emit backendRestarted(attempt);
+}
+
 void WebPage::finish(bool ok) { Q_UNUSED(ok); }
 void WebPage::changeCurrentFrame(IEngineBackend* frameBackend) {
     m_currentFrameBackend = frameBackend;
@@ -22,6 +22,8 @@
 class Callback;
 class Phantom;
 class QPdfWriter;
+class ScreencastWriter;
+class TiledFramebuffer;
 
 class WebPage : public QObject {
     Q_OBJECT
@@ -60,6 +62,26 @@ public:
     // --- Rendering ---
     bool render(const QString& fileName, const QVariantMap& option);
     QString renderBase64(const QByteArray& format);
+    QString renderBase64(const QByteArray& format, const QVariantMap& options);
+    // [{ width, height, file, ...render() encoder options }], captured from the current load one size after another.
+    bool renderViewports(const QVariantList& viewports, const QVariantMap& options = QVariantMap());
+    // Selectors are strings or { selector, file, ...encoder options }. Returns one entry per captured element with
+    // its rect and either the file written or base64 data.
+    QVariantList renderElements(const QVariantList& selectors, const QVariantMap& options = QVariantMap());
+    // { workers, pagesPerPart }: page ranges printed concurrently and merged into `fileName`.
+    bool renderPdfParallel(const QString& fileName, const QVariantMap& options = QVariantMap());
+    // Template mode: the loaded page is a template that receives `data` through window.applyTemplateData(data)
+    // (or a 'templatedata' event) and is captured without reloading. The options are those of render(), plus
+    // `timeout` for the template's ready signal.
+    bool renderTemplate(const QVariantMap& data, const QString& fileName, const QVariantMap& options = QVariantMap());
+    // Renders many documents from the loaded template, [{ data, file, format?, quality? }], spread over
+    // `options.workers` pooled copies of the page. Results are [{ file, error? }] in job order.
+    QVariantList renderTemplateBatch(const QVariantList& jobs, const QVariantMap& options = QVariantMap());
+    // Records the page to { file, fps, maxWidth, maxHeight, quality, queueSize }: an .mjpeg stream or an image
+    // sequence ("frame-%05d.jpg"). Frames the writer cannot keep up with are dropped.
+    bool startScreencast(const QVariantMap& options);
+    // Stops recording and returns { file, frames, dropped }.
+    QVariantMap stopScreencast();
     void setViewportSize(const QVariantMap& size);
     QVariantMap viewportSize() const;
     void setClipRect(const QVariantMap& size);
@@ -85,6 +107,19 @@ public:
     bool navigationLocked();
     void setCustomHeaders(const QVariantMap& headers);
     QVariantMap customHeaders() const;
+    // { rules (Adblock filter text or a list of lines), rulesFile (path or list), domains, resourceTypes }, matched
+    // by the backend without consulting this page. null removes the filter. Returns { rules, skipped }.
+    QVariantMap setRequestFilter(const QVariant& options);
+    // Network archives: record every response of this page into one file, and later serve the page's requests
+    // from it with no network access. Replay options: { onMiss: "fail" (default) | "network" }.
+    bool startNetworkRecording(const QString& fileName);
+    QVariantMap stopNetworkRecording();
+    bool replayNetwork(const QString& fileName, const QVariantMap& options = QVariantMap());
+    void stopNetworkReplay();
+    // Streams a HAR 1.2 log of this page's requests, with the browser's timings, to the file until stopHar(),
+    // which returns { file, entries }.
+    bool startHar(const QString& fileName);
+    QVariantMap stopHar();
 
     // --- Cookie Management ---
     void setCookieJar(CookieJar* cookieJar);
@@ -149,6 +184,7 @@ public:
     void javascriptInterrupt();
 
     IEngineBackend* engineBackend() const;
+    bool backendHealthy() const;
 
 signals:
     void loadStarted();
@@ -168,10 +204,22 @@ signals:
     void resourceTimeout(QVariant errorData);
 
     void repaintRequested(int x, int y, int width, int height);
+    // Streamed PDF output: { file, bytesWritten, done }
+    void renderProgress(const QVariantMap& progress);
 
     void closing(WebPage* page);
 
+    // The engine backend stopped answering (or came back); a pool manager can use this to replace the page.
+    void backendHealthChanged(bool healthy);
+    // A crashed backend was replaced and the page state (viewport, headers, cookies, URL) replayed to it.
+    void backendRestarted(int attempt);
+
+protected:
+    void connectNotify(const QMetaMethod& signal) override;
+    void disconnectNotify(const QMetaMethod& signal) override;
+
 private slots:
+    void updateResourceForwarding();
     void handleEngineLoadStarted(const QUrl& url);
     void handleEngineLoadFinished(bool success, const QUrl& url);
     void handleEngineLoadingProgress(int progress);
@@ -193,7 +241,11 @@ private slots:
     void handleEngineResourceError(const QVariantMap& errorData);
     void handleEngineResourceTimeout(const QVariantMap& errorData);
     void handleEngineRepaintRequested(const QRect& dirtyRect);
+    void handleEnginePdfProgress(qint64 bytesWritten, bool done);
+    void handleEngineScreencastFrame(const QByteArray& jpeg, qreal timestamp);
     void handleEngineInitialized();
+    void handleEngineHealthChanged(bool healthy);
+    void handleEngineBackendRestarted(int attempt);
 
     void finish(bool ok);
     void changeCurrentFrame(IEngineBackend* frameBackend);
@@ -242,6 +294,21 @@ private:
 
     QVariantMap m_paperSize;
     QString m_libraryPath;
+    QString m_renderingFileName; // Target of the PDF being streamed, for renderProgress
+
+    // Incremental capture state, created by the first render() with { incremental: true }
+    TiledFramebuffer* m_framebuffer;
+    bool m_repaintTracking;
+    QString m_incrementalFileName;
+    quint64 m_incrementalGeneration;
+
+    ScreencastWriter* m_screencast; // Set between startScreencast() and stopScreencast()
+
+    bool m_requestInterception; // onResourceRequested is set, so requests wait for its decisions
+    bool m_resourceForwardingPending; // A listener changed; updateResourceForwarding() is queued
+    QString m_networkRecording; // Archive being recorded, empty when not recording
+    QString m_harFile; // HAR being written, empty when not recording one
+    int m_interceptDeadline;
 
     qreal stringToPointSize(const QString& string) const;
     qreal printMargin(const QVariantMap& map, const QString& key);
@@ -249,6 +316,12 @@ private:
     QString header(int page, int numPages);
     QString footer(int page, int numPages);
     void _appendScriptElement(const QString& scriptUrl);
+    void scheduleResourceForwarding(const QMetaMethod& signal);
+    void flushResourceForwarding();
+    void updateRepaintTracking();
+    bool renderFast(const QString& fileName, const QVariantMap& option, const QRect& clipRect);
+    bool renderIncremental(const QString& fileName, const QVariantMap& option);
+    bool renderTiled(const QString& fileName, const QVariantMap& option, const QRect& clipRect);
 };
 
 #endif // WEBPAGE_H
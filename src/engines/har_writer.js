@@ -0,0 +1,145 @@
+// har_writer.js
+// Streams an HTTP Archive (HAR 1.2) to disk while the page loads, for playwright_backend.js.
+//
+// Entries are serialised as their requests finish and handed to a file stream, whose writes run on libuv's thread
+// pool; neither the entries nor the events they are built from go to C++ or the control script. The log object is
+// written around them: the header when the HAR starts, the entries array as they come, and the pages (whose titles
+// and load timings are only known later) when it stops. JSON doesn't care about the order of an object's keys, so
+// the file is a regular HAR.
+
+const fs = require('fs');
+const { finished } = require('stream/promises');
+
+// HAR timings from Playwright's request.timing(), which gives phase boundaries in ms relative to startTime and -1
+// for the phases that did not happen (reused connections, cache hits, fulfilled requests). `ssl` is part of
+// `connect`, as the HAR spec has it; send, wait and receive may not be -1 there.
+function harTimings(timing) {
+    const span = (start, end) => (start >= 0 && end >= start ? end - start : -1);
+    const firstPhase = [timing.domainLookupStart, timing.connectStart, timing.requestStart].find(t => t >= 0);
+    const timings = {
+        blocked: firstPhase !== undefined ? firstPhase : -1,
+        dns: span(timing.domainLookupStart, timing.domainLookupEnd),
+        connect: span(timing.connectStart, timing.connectEnd),
+        ssl: span(timing.secureConnectionStart, timing.connectEnd),
+        send: 0,
+        wait: Math.max(0, span(timing.requestStart, timing.responseStart)),
+        receive: Math.max(0, span(timing.responseStart, timing.responseEnd))
+    };
+    const time = ['blocked', 'dns', 'connect', 'send', 'wait', 'receive']
+        .reduce((sum, phase) => sum + Math.max(0, timings[phase]), 0);
+    return { timings, time };
+}
+
+function harHeaders(headers) {
+    return Object.entries(headers).map(([name, value]) => ({ name, value: String(value) }));
+}
+
+function harQueryString(url) {
+    try {
+        return [...new URL(url).searchParams].map(([name, value]) => ({ name, value }));
+    } catch (e) {
+        return [];
+    }
+}
+
+class HarWriter {
+    constructor(fileName, creator) {
+        this.fileName = fileName;
+        // Opened synchronously, so a file that cannot be written fails right here.
+        this.stream = fs.createWriteStream(fileName, { fd: fs.openSync(fileName, 'w') });
+        this.entries = 0;
+        this.closed = false;
+        this.pages = [];
+        this.pending = new Set(); // Entries waiting for data that is only available asynchronously (sizes)
+        this.stream.write(`{"log":{"version":"1.2","creator":${JSON.stringify(creator)},"entries":[\n`);
+    }
+
+    // Starts a page; entries belong to the latest one.
+    startPage(url) {
+        const page = {
+            startedDateTime: new Date().toISOString(),
+            id: `page_${this.pages.length + 1}`,
+            title: url,
+            pageTimings: { onContentLoad: -1, onLoad: -1 },
+            started: Date.now()
+        };
+        this.pages.push(page);
+        return page;
+    }
+
+    currentPage() {
+        return this.pages.length ? this.pages[this.pages.length - 1] : this.startPage('');
+    }
+
+    // Builds the entry for a finished or failed request. Its sizes need one more round-trip to the browser, so
+    // the entry is written once they are in; stop() waits for entries still on their way.
+    addRequest(request, failure) {
+        const pageref = this.currentPage().id;
+        const work = this.buildEntry(request, failure, pageref).then(entry => {
+            if (!this.closed) {
+                this.stream.write(`${this.entries ? ',\n' : ''}${JSON.stringify(entry)}`);
+                ++this.entries;
+            }
+        }).catch(() => {}).finally(() => this.pending.delete(work));
+        this.pending.add(work);
+    }
+
+    async buildEntry(request, failure, pageref) {
+        const response = failure ? null : await request.response();
+        const sizes = await request.sizes().catch(() => null);
+        const timing = request.timing();
+        const { timings, time } = harTimings(timing);
+        const postData = request.postData();
+        const responseHeaders = response ? response.headers() : {};
+        const entry = {
+            pageref,
+            startedDateTime: new Date(timing.startTime).toISOString(),
+            time,
+            request: {
+                method: request.method(),
+                url: request.url(),
+                httpVersion: 'HTTP/1.1',
+                cookies: [],
+                headers: harHeaders(request.headers()),
+                queryString: harQueryString(request.url()),
+                headersSize: sizes ? sizes.requestHeadersSize : -1,
+                bodySize: sizes ? sizes.requestBodySize : (postData ? Buffer.byteLength(postData) : 0)
+            },
+            response: {
+                status: response ? response.status() : 0,
+                statusText: response ? response.statusText() : '',
+                httpVersion: 'HTTP/1.1',
+                cookies: [],
+                headers: harHeaders(responseHeaders),
+                content: {
+                    size: sizes ? sizes.responseBodySize : -1,
+                    mimeType: responseHeaders['content-type'] || 'x-unknown'
+                },
+                redirectURL: responseHeaders.location || '',
+                headersSize: sizes ? sizes.responseHeadersSize : -1,
+                bodySize: sizes ? sizes.responseBodySize : -1
+            },
+            cache: {},
+            timings
+        };
+        if (postData) {
+            entry.request.postData = { mimeType: request.headers()['content-type'] || '', text: postData };
+        }
+        if (failure) {
+            entry._error = failure;
+        }
+        return entry;
+    }
+
+    // Writes the pages, closes the log and resolves with the number of entries once everything is on disk.
+    async stop() {
+        await Promise.all([...this.pending]);
+        this.closed = true;
+        const pages = this.pages.map(({ started, ...page }) => page);
+        this.stream.end(`\n],"pages":${JSON.stringify(pages)}}}\n`);
+        await finished(this.stream);
+        return this.entries;
+    }
+}
+
+module.exports = { HarWriter, harTimings };
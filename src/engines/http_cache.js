@@ -0,0 +1,307 @@
+// http_cache.js
+// A persistent HTTP response cache for playwright_backend.js, shared by every backend process through the
+// filesystem.
+//
+// Layout of the cache directory:
+//   blobs/<sha256 of body>     response bodies, content-addressed: identical assets are stored once
+//   index/<sha256 of key>.json one entry per request key: status, headers, Vary values, timestamps and body hash
+//
+// Files are written to a temporary name and renamed into place, so concurrent backends never read half an entry.
+// Each process keeps an in-memory index (built by scanning index/ when the cache opens) to account sizes and evict
+// the least recently used entries once the cache outgrows its budget; entry file mtimes record the last use, so
+// the LRU order survives restarts and is shared between processes. A backend that finds an entry's body missing
+// (evicted by another process) treats it as a miss.
+
+const crypto = require('crypto');
+const fs = require('fs/promises');
+const path = require('path');
+
+const CacheableStatus = new Set([200, 203, 204, 300, 301, 308, 404, 410]);
+// Describe the body as it came over the wire; stored bodies are already decoded and served with their own length.
+const TransferHeaders = new Set(['content-encoding', 'content-length', 'transfer-encoding']);
+
+function sha256(data) {
+    return crypto.createHash('sha256').update(data).digest('hex');
+}
+
+// Lowercase directive -> value (true for directives without one).
+function parseCacheControl(value) {
+    const directives = {};
+    for (const part of (value || '').split(',')) {
+        const [name, arg] = part.split('=');
+        if (name.trim()) {
+            directives[name.trim().toLowerCase()] = arg === undefined ? true : arg.trim().replace(/^"|"$/g, '');
+        }
+    }
+    return directives;
+}
+
+function headerValue(headers, name) {
+    for (const key of Object.keys(headers)) {
+        if (key.toLowerCase() === name) {
+            return headers[key];
+        }
+    }
+    return undefined;
+}
+
+// Headers to serve a decoded body with.
+function storedHeaders(headers) {
+    return Object.fromEntries(Object.entries(headers).filter(([name]) => !TransferHeaders.has(name.toLowerCase())));
+}
+
+function varyNames(headers) {
+    return (headerValue(headers, 'vary') || '').split(',').map(name => name.trim().toLowerCase()).filter(Boolean);
+}
+
+// Whether a private cache may store this response (RFC 9111 section 3), and with which request header values.
+function storableVary(method, status, requestHeaders, responseHeaders) {
+    if (method !== 'GET' || !CacheableStatus.has(status)) {
+        return null;
+    }
+    const cc = parseCacheControl(headerValue(responseHeaders, 'cache-control'));
+    if (cc['no-store'] || headerValue(responseHeaders, 'set-cookie') !== undefined) {
+        return null;
+    }
+    const explicit = cc['max-age'] !== undefined || headerValue(responseHeaders, 'expires') !== undefined;
+    const validated = headerValue(responseHeaders, 'etag') !== undefined
+        || headerValue(responseHeaders, 'last-modified') !== undefined;
+    if (!explicit && !validated) {
+        return null;
+    }
+    const vary = {};
+    for (const name of varyNames(responseHeaders)) {
+        if (name === '*') {
+            return null;
+        }
+        vary[name] = headerValue(requestHeaders, name) || '';
+    }
+    return vary;
+}
+
+function varyMatches(vary, requestHeaders) {
+    return Object.keys(vary).every(name => (headerValue(requestHeaders, name) || '') === vary[name]);
+}
+
+// Milliseconds the response stays fresh after it was received: max-age, else Expires, else 10% of its age since
+// Last-Modified (the usual heuristic). no-cache responses are stored but always revalidated.
+function freshnessLifetime(headers) {
+    const cc = parseCacheControl(headerValue(headers, 'cache-control'));
+    if (cc['no-cache']) {
+        return 0;
+    }
+    if (cc['max-age'] !== undefined) {
+        return Math.max(0, parseInt(cc['max-age'], 10) || 0) * 1000;
+    }
+    const date = Date.parse(headerValue(headers, 'date')) || Date.now();
+    const expires = headerValue(headers, 'expires');
+    if (expires !== undefined) {
+        return Math.max(0, (Date.parse(expires) || 0) - date);
+    }
+    const lastModified = Date.parse(headerValue(headers, 'last-modified'));
+    return lastModified ? Math.max(0, (date - lastModified) / 10) : 0;
+}
+
+// Headers for a conditional request that revalidates `entry`, or null if it has no validators.
+function revalidationHeaders(entry) {
+    const headers = {};
+    const etag = headerValue(entry.headers, 'etag');
+    const lastModified = headerValue(entry.headers, 'last-modified');
+    if (etag !== undefined) {
+        headers['If-None-Match'] = etag;
+    }
+    if (lastModified !== undefined) {
+        headers['If-Modified-Since'] = lastModified;
+    }
+    return Object.keys(headers).length ? headers : null;
+}
+
+// A 304 carries updated metadata for the stored response; the body and its length stay as they were.
+function mergeNotModified(stored, fresh) {
+    const headers = { ...stored };
+    for (const [name, value] of Object.entries(fresh)) {
+        const lower = name.toLowerCase();
+        if (TransferHeaders.has(lower)) {
+            continue;
+        }
+        for (const key of Object.keys(headers)) {
+            if (key.toLowerCase() === lower) {
+                delete headers[key];
+            }
+        }
+        headers[name] = value;
+    }
+    return headers;
+}
+
+class DiskCache {
+    constructor(directory, maxBytes) {
+        this.directory = directory;
+        this.maxBytes = maxBytes;
+        this.entries = new Map(); // key hash -> { blob, size, lastUsed }, in LRU order (oldest first)
+        this.blobs = new Map(); // blob hash -> { size, refs }
+        this.totalBytes = 0;
+        this.opened = null;
+    }
+
+    open() {
+        if (!this.opened) {
+            this.opened = this.scan();
+        }
+        return this.opened;
+    }
+
+    async scan() {
+        await fs.mkdir(path.join(this.directory, 'index'), { recursive: true });
+        await fs.mkdir(path.join(this.directory, 'blobs'), { recursive: true });
+        const found = [];
+        for (const name of await fs.readdir(path.join(this.directory, 'index'))) {
+            if (!name.endsWith('.json')) {
+                continue;
+            }
+            try {
+                const file = path.join(this.directory, 'index', name);
+                const [stat, entry] = await Promise.all([fs.stat(file), fs.readFile(file, 'utf8').then(JSON.parse)]);
+                found.push({ hash: name.slice(0, -5), blob: entry.blob, size: entry.size, lastUsed: stat.mtimeMs });
+            } catch (e) {
+                // Being written or removed by another backend right now
+            }
+        }
+        found.sort((a, b) => a.lastUsed - b.lastUsed);
+        for (const entry of found) {
+            this.remember(entry.hash, entry.blob, entry.size, entry.lastUsed);
+        }
+        await this.evict();
+    }
+
+    remember(hash, blob, size, lastUsed) {
+        this.forget(hash);
+        this.entries.set(hash, { blob, size, lastUsed });
+        const stored = this.blobs.get(blob);
+        if (stored) {
+            ++stored.refs;
+        } else {
+            this.blobs.set(blob, { size, refs: 1 });
+            this.totalBytes += size;
+        }
+    }
+
+    // Returns the hash of a blob nothing refers to any more, if forgetting the entry released one.
+    forget(hash) {
+        const entry = this.entries.get(hash);
+        if (!entry) {
+            return null;
+        }
+        this.entries.delete(hash);
+        const stored = this.blobs.get(entry.blob);
+        if (stored && --stored.refs === 0) {
+            this.blobs.delete(entry.blob);
+            this.totalBytes -= stored.size;
+            return entry.blob;
+        }
+        return null;
+    }
+
+    async evict() {
+        while (this.totalBytes > this.maxBytes && this.entries.size) {
+            await this.remove(this.entries.keys().next().value);
+        }
+    }
+
+    async remove(hash) {
+        const blob = this.forget(hash);
+        await fs.unlink(this.indexFile(hash)).catch(() => {});
+        if (blob) {
+            await fs.unlink(this.blobFile(blob)).catch(() => {});
+        }
+    }
+
+    indexFile(hash) {
+        return path.join(this.directory, 'index', `${hash}.json`);
+    }
+
+    blobFile(blob) {
+        return path.join(this.directory, 'blobs', blob);
+    }
+
+    async writeAtomically(file, data) {
+        const temporary = `${file}.${process.pid}.tmp`;
+        await fs.writeFile(temporary, data);
+        await fs.rename(temporary, file);
+    }
+
+    static key(method, url) {
+        return sha256(`${method} ${url}`);
+    }
+
+    // The stored entry for a request, with its body, or null. Entries from other processes are picked up too.
+    async lookup(method, url, requestHeaders) {
+        await this.open();
+        const hash = DiskCache.key(method, url);
+        let entry;
+        try {
+            entry = JSON.parse(await fs.readFile(this.indexFile(hash), 'utf8'));
+        } catch (e) {
+            return null;
+        }
+        if (entry.url !== url || !varyMatches(entry.vary || {}, requestHeaders)) {
+            return null;
+        }
+        try {
+            entry.body = await fs.readFile(this.blobFile(entry.blob));
+        } catch (e) {
+            await this.remove(hash);
+            return null;
+        }
+        this.remember(hash, entry.blob, entry.size, Date.now());
+        const now = new Date();
+        fs.utimes(this.indexFile(hash), now, now).catch(() => {});
+        return entry;
+    }
+
+    isFresh(entry) {
+        return Date.now() - entry.responseTime < freshnessLifetime(entry.headers);
+    }
+
+    async store(method, url, requestHeaders, status, headers, body) {
+        const vary = storableVary(method, status, requestHeaders, headers);
+        if (!vary || body.length > this.maxBytes / 8) {
+            return false;
+        }
+        await this.open();
+        const blob = sha256(body);
+        // The in-memory index can be stale: another process may have evicted the file since.
+        if (!this.blobs.has(blob) || !await fs.access(this.blobFile(blob)).then(() => true, () => false)) {
+            await this.writeAtomically(this.blobFile(blob), body);
+        }
+        const hash = DiskCache.key(method, url);
+        const entry = {
+            url, status, headers: storedHeaders(headers), vary, blob, size: body.length, responseTime: Date.now()
+        };
+        await this.writeAtomically(this.indexFile(hash), JSON.stringify(entry));
+        this.remember(hash, blob, body.length, Date.now());
+        await this.evict();
+        return true;
+    }
+
+    // Updates a stored entry after a 304 and returns it.
+    async refresh(method, url, entry, headers) {
+        const hash = DiskCache.key(method, url);
+        const updated = { ...entry, headers: mergeNotModified(entry.headers, headers), responseTime: Date.now() };
+        delete updated.body;
+        await this.writeAtomically(this.indexFile(hash), JSON.stringify(updated));
+        updated.body = entry.body;
+        return updated;
+    }
+}
+
+module.exports = {
+    DiskCache,
+    freshnessLifetime,
+    headerValue,
+    mergeNotModified,
+    revalidationHeaders,
+    storableVary,
+    storedHeaders,
+    varyMatches
+};
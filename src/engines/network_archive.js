@@ -0,0 +1,164 @@
+// network_archive.js
+// Network archives for playwright_backend.js: every response of a session recorded into one file, and served back
+// from it later without touching the network.
+//
+// File layout (integers little-endian):
+//   "PJSNARC1"                                  magic
+//   record*                                     u32 meta length, meta JSON { key, status, headers }, body
+//   slot[slotCount]                             u64 key hash, u64 record offset (0: empty), u32 record length, u32 0
+//   u64 index offset, u32 slot count, u32 record count, "PJSNIDX1"
+//
+// The index is an open-addressing hash table (power-of-two size, at most half full, linear probing) stored as it is
+// used: a reader loads the slot array as one buffer and looks a request up with a hash and, almost always, a single
+// probe, then reads the record with one positional read. Nothing is parsed when an archive is opened, whatever its
+// size.
+
+const crypto = require('crypto');
+const fs = require('fs');
+
+const Magic = Buffer.from('PJSNARC1');
+const IndexMagic = Buffer.from('PJSNIDX1');
+const SlotSize = 24;
+const FooterSize = 24;
+
+// Identifies a request across runs: method and URL, plus a digest of the body for requests that have one.
+function requestKey(method, url, postData) {
+    let key = `${method} ${url}`;
+    if (postData && postData.length) {
+        key += ` ${crypto.createHash('sha256').update(postData).digest('hex')}`;
+    }
+    return key;
+}
+
+// The first 8 bytes of the key's SHA-1; the low 32 bits pick the slot.
+function keyHash(key) {
+    const digest = crypto.createHash('sha1').update(key).digest();
+    return { high: digest.readUInt32LE(4), low: digest.readUInt32LE(0) };
+}
+
+function slotCountFor(records) {
+    let count = 2;
+    while (count < records * 2) {
+        count *= 2;
+    }
+    return count;
+}
+
+class ArchiveWriter {
+    constructor(fileName) {
+        this.fileName = fileName;
+        this.fd = fs.openSync(fileName, 'w');
+        this.offset = 0;
+        this.records = new Map(); // key -> { offset, length }; the first response recorded for a key is kept
+        this.writes = Promise.resolve();
+        this.finished = false;
+        this.append(Magic);
+    }
+
+    append(buffer) {
+        const position = this.offset;
+        this.offset += buffer.length;
+        this.writes = this.writes.then(() => new Promise((resolve, reject) => {
+            fs.write(this.fd, buffer, 0, buffer.length, position, error => (error ? reject(error) : resolve()));
+        }));
+    }
+
+    add(key, status, headers, body) {
+        if (this.finished || this.records.has(key)) {
+            return;
+        }
+        const meta = Buffer.from(JSON.stringify({ key, status, headers }));
+        const length = Buffer.alloc(4);
+        length.writeUInt32LE(meta.length, 0);
+        const record = Buffer.concat([length, meta, body]);
+        this.records.set(key, { offset: this.offset, length: record.length });
+        this.append(record);
+    }
+
+    // Writes the index after the records and closes the file; resolves with the number of records.
+    async finish() {
+        this.finished = true;
+        const slotCount = slotCountFor(this.records.size);
+        const slots = Buffer.alloc(slotCount * SlotSize);
+        for (const [key, record] of this.records) {
+            const hash = keyHash(key);
+            let slot = hash.low & (slotCount - 1);
+            while (slots.readUInt32LE(slot * SlotSize + 8) !== 0 || slots.readUInt32LE(slot * SlotSize + 12) !== 0) {
+                slot = (slot + 1) & (slotCount - 1);
+            }
+            const base = slot * SlotSize;
+            slots.writeUInt32LE(hash.low, base);
+            slots.writeUInt32LE(hash.high, base + 4);
+            slots.writeUInt32LE(record.offset % 0x100000000, base + 8);
+            slots.writeUInt32LE(Math.floor(record.offset / 0x100000000), base + 12);
+            slots.writeUInt32LE(record.length, base + 16);
+        }
+        const footer = Buffer.alloc(FooterSize);
+        footer.writeUInt32LE(this.offset % 0x100000000, 0);
+        footer.writeUInt32LE(Math.floor(this.offset / 0x100000000), 4);
+        footer.writeUInt32LE(slotCount, 8);
+        footer.writeUInt32LE(this.records.size, 12);
+        IndexMagic.copy(footer, 16);
+        this.append(slots);
+        this.append(footer);
+        try {
+            await this.writes;
+        } finally {
+            fs.closeSync(this.fd);
+        }
+        return this.records.size;
+    }
+}
+
+class ArchiveReader {
+    constructor(fileName) {
+        this.fd = fs.openSync(fileName, 'r');
+        try {
+            const size = fs.fstatSync(this.fd).size;
+            const footer = Buffer.alloc(FooterSize);
+            if (size < Magic.length + FooterSize
+                || fs.readSync(this.fd, footer, 0, FooterSize, size - FooterSize) !== FooterSize
+                || !footer.subarray(16).equals(IndexMagic)) {
+                throw new Error(`${fileName} is not a network archive, or its recording was not stopped`);
+            }
+            const indexOffset = footer.readUInt32LE(0) + footer.readUInt32LE(4) * 0x100000000;
+            this.slotCount = footer.readUInt32LE(8);
+            this.recordCount = footer.readUInt32LE(12);
+            this.slots = Buffer.alloc(this.slotCount * SlotSize);
+            fs.readSync(this.fd, this.slots, 0, this.slots.length, indexOffset);
+        } catch (e) {
+            fs.closeSync(this.fd);
+            throw e;
+        }
+    }
+
+    close() {
+        fs.closeSync(this.fd);
+    }
+
+    // { status, headers, body } recorded for the key, or null.
+    async lookup(key) {
+        const hash = keyHash(key);
+        for (let slot = hash.low & (this.slotCount - 1); ; slot = (slot + 1) & (this.slotCount - 1)) {
+            const base = slot * SlotSize;
+            const offset = this.slots.readUInt32LE(base + 8) + this.slots.readUInt32LE(base + 12) * 0x100000000;
+            if (offset === 0) {
+                return null;
+            }
+            if (this.slots.readUInt32LE(base) !== hash.low || this.slots.readUInt32LE(base + 4) !== hash.high) {
+                continue;
+            }
+            const record = Buffer.alloc(this.slots.readUInt32LE(base + 16));
+            await new Promise((resolve, reject) => {
+                fs.read(this.fd, record, 0, record.length, offset, error => (error ? reject(error) : resolve()));
+            });
+            const metaLength = record.readUInt32LE(0);
+            const meta = JSON.parse(record.toString('utf8', 4, 4 + metaLength));
+            if (meta.key === key) {
+                return { status: meta.status, headers: meta.headers, body: record.subarray(4 + metaLength) };
+            }
+        }
+    }
+}
+
+module.exports = { ArchiveReader, ArchiveWriter, requestKey };
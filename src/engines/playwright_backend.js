@@ -1,53 +1,135 @@
 // playwright_backend.js
 // This script runs in a Node.js environment and interacts with Playwright.
+//
+// Messages are length-prefixed JSON (`<byte length>\n<json>`) on stdin/stdout. Command and event ids come from
+// playwright_protocol.js, which is generated from playwright_protocol.json together with the C++ side.
 
 const playwright = require('playwright');
-const fs = require('fs/promises'); // Node.js file system for injectJsFile
+const fs = require('fs/promises'); // Node.js file system for injectJavaScriptFile
+const path = require('path');
+const { PROTOCOL_VERSION, Command, Event, buildDispatchTable } = require('./playwright_protocol');
+const {
+    DiskCache, freshnessLifetime, headerValue, revalidationHeaders, storableVary, storedHeaders
+} = require('./http_cache');
+const { ArchiveReader, ArchiveWriter, requestKey } = require('./network_archive');
+const { HarWriter } = require('./har_writer');
 
 let browser;
 let browserContext; // Use a browser context for better isolation and settings management
-let page; // The main/default page for convenience
-let pages = new Map(); // Stores active pages, keyed by Playwright Page object reference (or unique ID if managing multiple contexts)
+let page; // The main/default page
+let currentFrame = null; // Frame selected by the switchTo* commands; null means the main frame
 let exposedObjects = new Map(); // Stores QObjects metadata exposed from C++, keyed by their JS name
-let syncResponseResolvers = new Map(); // Stores resolvers for synchronous IPC calls from JS back to C++
+let replyResolvers = new Map(); // Pending events that wait for a reply from C++, keyed by request id
+let nextRequestId = 1;
+let shuttingDown = null; // Promise of the running shutdown, if any
+let repaintTracker = null; // CDP LayerTree session feeding repaintRequested, while C++ asks for it
+let extraHeaders = {}; // Last headers given to setExtraHTTPHeaders, copied into PDF worker contexts
+let captureSession = null; // CDP session of the main page, kept for captureViewportFast
+let requestFilter = null; // Compiled blocking rules, see loadRequestFilter()
+let interception = null; // { deadline } while onResourceRequested decides about requests
+let pendingRequests = new Map(); // Intercepted requests waiting for their route and/or decision, keyed by resource id
+let nextResourceId = 1;
+let resourceIds = new WeakMap(); // Request -> numeric id shared by its resource events
+let fulfilledHere = new WeakMap(); // Request -> { fromCache, encodedSize, decodedSize }, for those fulfilled here
+let screencast = null; // { session, interval, last } while a CDP screencast is running
+let templatePool = null; // { url, clones } kept by renderTemplateBatch until the main page navigates
+let diskCacheSettings = { enabled: false, maxSize: 0, path: '' }; // maxSize in MB, 0 for the default
+let diskCache = null; // DiskCache while diskCacheSettings enable it
+let responseCacheEnabled = false; // Static subresources go through the process-wide ResponseCache in C++
+let archiveWriter = null; // ArchiveWriter between startNetworkRecording and stopNetworkRecording
+let archiveReplay = null; // { reader, fallThrough } while requests are served from a network archive
+let harWriter = null; // HarWriter between startHar and stopHar
+let loadTimeout = 30000; // ms a load strategy may take, Playwright's default until setResourceTimeout
+let currentLoad = 0; // Number of the latest navigation; an older load() still settling reports nothing
+let loadInProgress = false; // load() has not reported loadFinished yet
+let ownsLoadEvents = false; // The page's load events belong to a load() that reports loadFinished itself
+
+// --- IPC ---
+
+// PLAYWRIGHT_BACKEND_RECORD=<file> keeps a copy of everything sent to C++, e.g. as input for
+// test/benchmark/ipcframe_benchmark.
+const recording = process.env.PLAYWRIGHT_BACKEND_RECORD
+    ? require('fs').createWriteStream(process.env.PLAYWRIGHT_BACKEND_RECORD)
+    : null;
+
+function writeMessage(message) {
+    const json = JSON.stringify(message);
+    const frame = `${Buffer.byteLength(json)}\n${json}`;
+    process.stdout.write(frame);
+    if (recording) {
+        recording.write(frame);
+    }
+}
 
-process.stdin.setEncoding('utf8');
+function sendResponse(id, result, error) {
+    if (error) {
+        writeMessage({ type: 'response', id, error: { message: String(error) } });
+    } else {
+        writeMessage({ type: 'response', id, result: result === undefined ? null : result });
+    }
+}
 
-// Function to send messages back to the C++ process
-function sendMessage(type, command, data = {}, id = null) {
-    const message = { type, command, data };
-    if (id !== null) {
-        message.id = id;
+function sendEvent(name, data = {}) {
+    const event = Event[name];
+    if (event === undefined) {
+        throw new Error(`Unknown protocol event '${name}'`);
     }
-    const jsonString = JSON.stringify(message);
-    const messageWithLength = `${jsonString.length}\n${jsonString}`;
-    process.stdout.write(messageWithLength);
+    writeMessage({ type: 'event', event, data });
 }
 
-// Function to send synchronous responses back to the C++ process
-function sendSyncResponse(id, result) {
-    const response = { type: "sync_response", id: id, result: result };
-    const jsonString = JSON.stringify(response);
-    const messageWithLength = `${jsonString.length}\n${jsonString}`;
-    process.stdout.write(messageWithLength);
+// Sends an event that C++ answers with a 'reply' message and resolves with the reply's result object. With a
+// timeout, resolves with `fallback` once it expires; the reply, if it still comes, is then dropped.
+function requestReply(name, data = {}, timeoutMs = 0, fallback = {}) {
+    return new Promise((resolve) => {
+        const id = nextRequestId++;
+        replyResolvers.set(id, resolve);
+        writeMessage({ type: 'event', event: Event[name], id, data });
+        if (timeoutMs > 0) {
+            setTimeout(() => {
+                if (replyResolvers.get(id) === resolve) {
+                    replyResolvers.set(id, () => {});
+                    resolve(fallback);
+                }
+            }, timeoutMs);
+        }
+    });
 }
 
-// IPC Protocol: Read length-prefixed JSON messages from stdin
-let buffer = "";
+// Commands run one at a time and in arrival order, so that e.g. setViewportSize issued right after init waits for
+// the browser to exist. Replies are resolved immediately since a running command may be waiting on one, and so are
+// heartbeat pings and shutdown: a slow command must neither look like a hung backend nor hold up process exit.
+// resolveRequests answers requests of the navigation a queued load is waiting for, so it cannot wait behind it.
+// Read-only queries (often made from onLoadStarted or onResourceRequested, while a navigation runs) only wait for
+// the queued commands that could change their answer: everything up to the last command that is not a network
+// navigation. setHtml replaces the document itself, so queries after it wait for it; evaluateJavaScript can change
+// the page and stays in order with everything else.
+let commandQueue = Promise.resolve();
+let settledQueue = Promise.resolve();
+const ImmediateCommands = new Set([Command.ping, Command.shutdown, Command.resolveRequests]);
+const NavigationCommands = new Set([
+    Command.load, Command.reload, Command.goBack, Command.goForward, Command.goToHistoryItem
+]);
+const QueryCommands = new Set([
+    Command.getUrl, Command.getTitle, Command.getHtml, Command.getPlainText, Command.getWindowName,
+    Command.canGoBack, Command.canGoForward, Command.getViewportSize, Command.getClipRect, Command.getScrollPosition,
+    Command.getZoomFactor, Command.getUserAgent, Command.getNavigationLocked, Command.getCustomHeaders,
+    Command.getLocalStorageQuota, Command.getOfflineStorageQuota, Command.getCookies, Command.getFramesCount,
+    Command.getFramesName, Command.getFrameName, Command.getFocusedFrameName, Command.getElementRects
+]);
+
+let buffer = Buffer.alloc(0);
 process.stdin.on('data', (chunk) => {
-    buffer += chunk;
+    buffer = Buffer.concat([buffer, chunk]);
     while (true) {
-        const newlineIndex = buffer.indexOf('\n');
+        const newlineIndex = buffer.indexOf(0x0a);
         if (newlineIndex === -1) {
             break; // No full length prefix yet
         }
 
-        const lengthStr = buffer.substring(0, newlineIndex);
-        const messageLength = parseInt(lengthStr, 10);
-
+        const messageLength = parseInt(buffer.toString('utf8', 0, newlineIndex), 10);
         if (isNaN(messageLength) || messageLength < 0) {
             console.error('PLAYWRIGHT_BACKEND_JS: Invalid message length received. Clearing buffer.');
-            buffer = ""; // Clear corrupted buffer
+            buffer = Buffer.alloc(0); // Clear corrupted buffer
             break;
         }
 
@@ -55,923 +137,1859 @@ process.stdin.on('data', (chunk) => {
             break; // Not enough data for the full message yet
         }
 
-        const jsonMessage = buffer.substring(newlineIndex + 1, newlineIndex + 1 + messageLength);
-        buffer = buffer.substring(newlineIndex + 1 + messageLength); // Remove processed message
+        const jsonMessage = buffer.toString('utf8', newlineIndex + 1, newlineIndex + 1 + messageLength);
+        buffer = buffer.subarray(newlineIndex + 1 + messageLength);
 
+        let message;
         try {
-            const parsedMessage = JSON.parse(jsonMessage);
-            if (parsedMessage.type === "sync_response_from_cpp_callback") {
-                // This is a response from C++ for a synchronous callback initiated by JS
-                const resolver = syncResponseResolvers.get(parsedMessage.id);
-                if (resolver) {
-                    syncResponseResolvers.delete(parsedMessage.id);
-                    resolver(parsedMessage.result);
-                } else {
-                    console.warn(`PLAYWRIGHT_BACKEND_JS: Received callback result for unknown ID: ${parsedMessage.id}`);
-                }
-            } else {
-                // Regular command from C++ to JS
-                handleCommand(parsedMessage);
-            }
+            message = JSON.parse(jsonMessage);
         } catch (e) {
             console.error('PLAYWRIGHT_BACKEND_JS: JSON parse error:', e.message, 'Message:', jsonMessage);
+            continue;
+        }
+
+        if (message.type === 'reply') {
+            const resolve = replyResolvers.get(message.id);
+            if (resolve) {
+                replyResolvers.delete(message.id);
+                resolve(message.result || {});
+            } else {
+                console.warn(`PLAYWRIGHT_BACKEND_JS: Received reply for unknown ID: ${message.id}`);
+            }
+        } else if (ImmediateCommands.has(message.cmd)) {
+            handleCommand(message);
+        } else if (QueryCommands.has(message.cmd)) {
+            settledQueue.then(() => handleCommand(message));
+        } else {
+            commandQueue = commandQueue.then(() => handleCommand(message));
+            if (!NavigationCommands.has(message.cmd)) {
+                settledQueue = commandQueue;
+            }
         }
     }
 });
 
-// Generic function to send a synchronous request to C++ and wait for a response
-async function callCPlusPlusSynchronously(commandName, data = {}) {
-    return new Promise((resolve) => {
-        const id = `${Date.now()}-${Math.random()}`; // Unique ID for this request
-        syncResponseResolvers.set(id, resolve); // Store resolver for this ID
-        sendMessage('sync_command_to_cpp', commandName, data, id);
+process.stdin.on('end', () => {
+    // The C++ side went away; don't leave a browser running.
+    handlers.shutdown();
+});
+
+// --- Helpers ---
+
+function requirePage() {
+    if (!page) {
+        throw new Error('Page not initialized.');
+    }
+    return page;
+}
+
+function requireContext() {
+    if (!browserContext) {
+        throw new Error('Browser context not initialized.');
+    }
+    return browserContext;
+}
+
+function frame() {
+    return currentFrame || requirePage().mainFrame();
+}
+
+function hasArea(rect) {
+    return rect && rect.width > 0 && rect.height > 0;
+}
+
+function toPlaywrightCookie(c) {
+    return {
+        name: c.name,
+        value: c.value,
+        domain: c.domain,
+        path: c.path || '/',
+        // Playwright expects seconds since epoch; PhantomJS cookies carry a GMT date string.
+        expires: c.expires ? (new Date(c.expires).getTime() / 1000) : undefined, // undefined means session cookie
+        httpOnly: c.httponly,
+        secure: c.secure
+    };
+}
+
+// Settings that Playwright only accepts when the browser or context is created.
+function launchOption(name) {
+    return async () => {
+        console.warn(`PLAYWRIGHT_BACKEND_JS: '${name}' is a browser/context launch option, not dynamically changeable.`);
+        return true;
+    };
+}
+
+// --- Repaint tracking ---
+
+// Chromium reports paints per compositing layer (LayerTree.layerPainted, clip in layer space). Layer offsets are
+// tracked from layerTreeDidChange so the clips can be mapped to page coordinates. Paints are coalesced for one
+// frame; a burst of many small rects, or a layer tree change (scrolling, new layers), is reported as a whole-page
+// repaint, which is always safe for the tiled framebuffer on the C++ side.
+const RepaintFlushMs = 16;
+const RepaintMaxRects = 16;
+
+async function startRepaintTracking(p) {
+    const session = await requireContext().newCDPSession(p);
+    const tracker = { session, layers: new Map(), pending: [], everything: false, timer: null };
+
+    const schedule = () => {
+        if (!tracker.timer) {
+            tracker.timer = setTimeout(() => flushRepaints(tracker), RepaintFlushMs);
+        }
+    };
+    session.on('LayerTree.layerTreeDidChange', ({ layers }) => {
+        tracker.layers = new Map((layers || []).map(l => [l.layerId, l]));
+        tracker.everything = true;
+        schedule();
+    });
+    session.on('LayerTree.layerPainted', ({ layerId, clip }) => {
+        let x = clip.x;
+        let y = clip.y;
+        for (let layer = tracker.layers.get(layerId); layer; layer = tracker.layers.get(layer.parentLayerId)) {
+            x += layer.offsetX;
+            y += layer.offsetY;
+        }
+        tracker.pending.push({ x: Math.floor(x), y: Math.floor(y), width: Math.ceil(clip.width),
+            height: Math.ceil(clip.height) });
+        schedule();
     });
+    await session.send('LayerTree.enable');
+    return tracker;
 }
 
+// Hands over the coalesced paints and resets the tracker. An empty rect means "everything".
+function takeRepaints(tracker) {
+    clearTimeout(tracker.timer);
+    tracker.timer = null;
+    const rects = tracker.everything || tracker.pending.length > RepaintMaxRects
+        ? [{ x: 0, y: 0, width: 0, height: 0 }]
+        : tracker.pending.filter(hasArea);
+    tracker.pending = [];
+    tracker.everything = false;
+    return rects;
+}
 
-// Command handler
-async function handleCommand(message) {
-    const { type, command, id, params } = message;
+function flushRepaints(tracker) {
+    takeRepaints(tracker).forEach(rect => sendEvent('repaintRequested', { rect }));
+}
 
-    // console.log(`PLAYWRIGHT_BACKEND_JS: Received ${type} command: ${command} (ID: ${id || 'N/A'})`);
+async function stopRepaintTracking(tracker) {
+    clearTimeout(tracker.timer);
+    await tracker.session.detach().catch(() => {});
+}
 
-    let result;
-    let error = null;
+// --- PDF ---
+
+// Paper sizes in inches, as Playwright's page.pdf() knows them.
+const PaperFormats = {
+    letter: [8.5, 11], legal: [8.5, 14], tabloid: [11, 17], ledger: [17, 11],
+    a0: [33.1, 46.8], a1: [23.4, 33.1], a2: [16.54, 23.4], a3: [11.7, 16.54], a4: [8.27, 11.7], a5: [5.83, 8.27],
+    a6: [4.13, 5.83]
+};
+// CSS pixels per unit, with page.pdf()'s rounding, so both print paths size pages identically.
+const PixelsPerUnit = { px: 1, in: 96, cm: 37.8, mm: 3.78 };
+
+// A page.pdf() length: a number of pixels, or a string with an optional px/in/cm/mm unit.
+function toInches(value) {
+    if (value === undefined || value === null || value === '') {
+        return undefined;
+    }
+    let pixels;
+    if (typeof value === 'number') {
+        pixels = value;
+    } else {
+        const text = String(value);
+        const unit = text.slice(-2).toLowerCase();
+        const known = Object.prototype.hasOwnProperty.call(PixelsPerUnit, unit);
+        pixels = Number(known ? text.slice(0, -2) : text) * PixelsPerUnit[known ? unit : 'px'];
+        if (isNaN(pixels)) {
+            throw new Error(`Failed to parse parameter value: ${text}`);
+        }
+    }
+    return pixels / PixelsPerUnit.in;
+}
 
-    try {
-        switch (command) {
-            case "init":
-                // Launch browser, create default page
-                browser = await playwright.chromium.launch({ headless: true }); // headless: true for production
-                browserContext = await browser.newContext(); // Use a context for settings
-                page = await browserContext.newPage();
-                pages.set('default', page); // Store the default page
-                console.log('PLAYWRIGHT_BACKEND_JS: Browser and default page initialized.');
-
-                // Attach common page event listeners
-                setupPageEventListeners(page, 'default'); // For default page
-
-                sendMessage('event', 'initialized'); // Inform C++ that page is ready
-                break;
+// The PhantomJS paperSize object as page.pdf() options.
+function pdfOptions(paperSize) {
+    const options = { printBackground: true };
+    if (paperSize.format) options.format = paperSize.format;
+    if (paperSize.width) options.width = paperSize.width; // e.g., "8.5in"
+    if (paperSize.height) options.height = paperSize.height; // e.g., "11in"
+    if (paperSize.margin && typeof paperSize.margin === 'object') {
+        options.margin = paperSize.margin;
+    } else if (paperSize.margin) {
+        const m = paperSize.margin;
+        options.margin = { top: m, right: m, bottom: m, left: m };
+    }
+    if (paperSize.orientation === 'landscape') options.landscape = true;
+    return options;
+}
 
-            case "shutdown":
-                if (browser) {
-                    await browser.close();
-                    browser = null;
-                    browserContext = null;
-                    page = null;
-                    pages.clear();
-                    exposedObjects.clear();
-                    console.log('PLAYWRIGHT_BACKEND_JS: Browser closed.');
-                }
-                process.exit(0);
-                break;
+// The same paperSize as Page.printToPDF parameters, for the streamed and parallel paths (page.pdf() exposes
+// neither). Converted the way page.pdf() does it: a format wins over width and height, a missing dimension is
+// Letter's, margins default to 0 rather than Chromium's own, and unknown formats or lengths throw.
+function printToPdfParams(paperSize) {
+    const options = pdfOptions(paperSize);
+    let [paperWidth, paperHeight] = PaperFormats.letter;
+    if (options.format) {
+        const format = PaperFormats[String(options.format).toLowerCase()];
+        if (!format) {
+            throw new Error(`Unknown paper format: ${options.format}`);
+        }
+        [paperWidth, paperHeight] = format;
+    } else {
+        paperWidth = toInches(options.width) || paperWidth;
+        paperHeight = toInches(options.height) || paperHeight;
+    }
+    const margin = options.margin || {};
+    return {
+        printBackground: options.printBackground,
+        landscape: !!options.landscape,
+        paperWidth,
+        paperHeight,
+        marginTop: toInches(margin.top) || 0,
+        marginRight: toInches(margin.right) || 0,
+        marginBottom: toInches(margin.bottom) || 0,
+        marginLeft: toInches(margin.left) || 0,
+        preferCSSPageSize: false
+    };
+}
 
-            case "closePage": // Command to close a specific page
-                // params: { pageId: 'default' or some other ID }
-                // For now, only 'default' page is explicitly handled.
-                if (params.pageId === 'default' && page) {
-                    await page.close();
-                    pages.delete('default');
-                    page = null; // Clear main page
-                } else {
-                    // Logic for closing other pages if they were tracked by ID
-                }
-                break;
+const KeepaliveIntervalMs = 1000;
 
-            // --- Core Page Navigation and Loading ---
-            case "load":
-                // params: { url, operation, body, headers }
-                if (page) {
-                    try {
-                        // Playwright doesn't have direct 'operation' like Get/Post for page.goto
-                        // For POST, page.goto is usually for forms. For direct POST, use page.request.post()
-                        // For headers, set them globally on context or per request.
-                        const headers = params.headers || {};
-                        await page.setExtraHTTPHeaders(headers); // Set custom headers for this navigation
-
-                        if (params.operation === 1 || params.operation === 2) { // GET or HEAD
-                            const response = await page.goto(params.url, { waitUntil: 'domcontentloaded', timeout: params.timeout || 30000 });
-                            result = !!response;
-                        } else if (params.operation === 3) { // POST
-                            // Playwright's page.goto doesn't handle POST bodies directly.
-                            // Needs to use page.request for full control.
-                            // For simplicity, let's just do a GET for now or require content.
-                            // A proper POST would involve:
-                            // const response = await page.request.post(params.url, { data: Buffer.from(params.body, 'base64') });
-                            // For now, let's just navigate to the URL and log a warning for POST body.
-                            console.warn(`PLAYWRIGHT_BACKEND_JS: POST operation with body is not fully implemented via page.goto. URL: ${params.url}`);
-                            const response = await page.goto(params.url, { waitUntil: 'domcontentloaded', timeout: params.timeout || 30000 });
-                            result = !!response;
-                        } else {
-                            console.warn(`PLAYWRIGHT_BACKEND_JS: Unsupported network operation: ${params.operation}. Falling back to GET.`);
-                            const response = await page.goto(params.url, { waitUntil: 'domcontentloaded', timeout: params.timeout || 30000 });
-                            result = !!response;
-                        }
-                    } catch (e) {
-                        console.error('PLAYWRIGHT_BACKEND_JS: Error during load:', e.message);
-                        error = e.message;
-                        result = false;
-                    }
-                } else {
-                    error = "Page not initialized.";
-                    result = false;
-                }
-                break;
+// Sends `event` until the returned function is called, for work that produces no output for a while (a print
+// before its stream is handed out, cloning pages): C++ waits with a sync timeout and takes it as progress.
+function keepalive(event, data) {
+    const timer = setInterval(() => sendEvent(event, data()), KeepaliveIntervalMs);
+    return () => clearInterval(timer);
+}
 
-            case "setHtml":
-                // params: { html, baseUrl }
-                if (page) {
-                    try {
-                        await page.setContent(params.html, { baseURL: params.baseUrl, waitUntil: 'domcontentloaded' });
-                        result = true;
-                    } catch (e) {
-                        console.error('PLAYWRIGHT_BACKEND_JS: Error during setHtml:', e.message);
-                        error = e.message;
-                        result = false;
-                    }
-                } else {
-                    error = "Page not initialized.";
-                    result = false;
-                }
-                break;
+// Yields the chunks of a CDP IO stream as Buffers, then closes it.
+async function* readStream(session, handle, size) {
+    for (;;) {
+        const chunk = await session.send('IO.read', { handle, size });
+        yield { data: Buffer.from(chunk.data, chunk.base64Encoded ? 'base64' : 'binary'), eof: chunk.eof };
+        if (chunk.eof) {
+            break;
+        }
+    }
+    await session.send('IO.close', { handle });
+}
 
-            case "reload":
-                if (page) {
-                    await page.reload({ waitUntil: 'load' });
-                    result = true;
-                }
-                break;
+async function printToFile(session, printParams, file) {
+    const { stream } = await session.send('Page.printToPDF', { ...printParams, transferMode: 'ReturnAsStream' });
+    const out = await fs.open(file, 'w');
+    try {
+        for await (const chunk of readStream(session, stream, 1024 * 1024)) {
+            await out.write(chunk.data);
+        }
+    } finally {
+        await out.close();
+    }
+}
 
-            case "stop":
-                if (page) {
-                    // Playwright doesn't have a direct 'stop' method.
-                    // The closest is often to abort requests or close the page/context.
-                    // For now, we'll try to stop any pending navigation.
-                    // A more robust solution might involve aborting specific network requests.
-                    // Playwright's `page.waitForNavigation` can be cancelled by `page.close()`, but this is too drastic.
-                    console.warn("PLAYWRIGHT_BACKEND_JS: 'stop' command is a no-op for Playwright currently. Consider implementing request interception to abort.");
-                    result = true; // Assume success for now
-                }
-                break;
+// How Page.printToPDF rejects a range that starts past the last page; any other failure is an error.
+const PageRangePastEnd = /page range exceeds page count/i;
 
-            case "canGoBack":
-            case "goBack":
-            case "canGoForward":
-            case "goForward":
-            case "goToHistoryItem":
-                console.warn(`PLAYWRIGHT_BACKEND_JS: History navigation command '${command}' is not directly supported by Playwright's page object. Returning false.`);
-                result = false; // Playwright doesn't expose a direct history API like QtWebKit.
-                break;
+function countPdfPages(pdf) {
+    return (pdf.toString('latin1').match(/\/Type\s*\/Page(?![a-zA-Z])/g) || []).length;
+}
 
-            // --- Page Content Properties ---
-            case "getHtml":
-                if (page) result = await page.content();
-                break;
-            case "getTitle":
-                if (page) result = await page.title();
-                break;
-            case "getUrl":
-                if (page) result = page.url();
-                break;
-            case "getPlainText":
-                if (page) result = await page.textContent('body'); // Gets text content of body element
-                break;
-            case "getWindowName":
-                if (page) result = await page.evaluate(() => window.name);
-                break;
+// A copy of the current page in its own browser context (and so its own renderer process): the live DOM is
+// served in place of the page's URL, so relative resources resolve and cookies and headers still apply. That DOM is
+// what the page's scripts built, with the scripts still in it: a clone that is only printed runs without
+// JavaScript, or they would run a second time over their own output.
+async function clonePage({ javaScriptEnabled = true } = {}) {
+    const source = requirePage();
+    const html = await source.content();
+    const url = source.url();
+    const context = await browser.newContext({ viewport: source.viewportSize(), javaScriptEnabled });
+    await context.addCookies(await requireContext().cookies());
+    await context.setExtraHTTPHeaders(extraHeaders);
+    const clone = await context.newPage();
+    if (/^(https?|file):/.test(url)) {
+        await clone.route(url, route => route.fulfill({ body: html, contentType: 'text/html' }), { times: 1 });
+        await clone.goto(url, { waitUntil: 'load' });
+    } else {
+        await clone.setContent(html, { waitUntil: 'load' });
+    }
+    return { context, page: clone };
+}
 
+// Hands a data object to the template loaded in `target` and resolves once the template is ready and painted.
+// A template defines window.applyTemplateData(data), which may return a promise for its render-ready signal;
+// without it the data is dispatched as the detail of a 'templatedata' event.
+async function fillTemplate(target, data, timeout) {
+    await target.evaluate(async ({ data, timeout }) => {
+        const ready = typeof window.applyTemplateData === 'function'
+            ? window.applyTemplateData(data)
+            : window.dispatchEvent(new CustomEvent('templatedata', { detail: data }));
+        let timer;
+        await Promise.race([
+            Promise.resolve(ready).then(() => document.fonts.ready),
+            new Promise((resolve, reject) => {
+                timer = setTimeout(() => reject(new Error(`Template not ready after ${timeout} ms`)), timeout);
+            })
+        ]).finally(() => clearTimeout(timer));
+        await new Promise(resolve => requestAnimationFrame(() => requestAnimationFrame(resolve)));
+    }, { data: data || {}, timeout: timeout > 0 ? timeout : 3000 });
+}
 
-            // --- JavaScript Execution & Interaction ---
-            case "evaluateJs":
-                // params: { script }
-                if (page) {
-                    result = await page.evaluate(params.script);
-                }
-                break;
+async function closeTemplatePool() {
+    if (templatePool) {
+        const clones = templatePool.clones;
+        templatePool = null;
+        await Promise.all(clones.map(clone => clone.context.close().catch(() => {})));
+    }
+}
 
-            case "injectJsFile":
-                // params: { filePath, encoding, libraryPath, inPhantomScope }
-                if (page) {
-                    try {
-                        const scriptContent = await fs.readFile(params.filePath, params.encoding || 'utf8');
-                        result = await page.evaluate(scriptContent);
-                    } catch (e) {
-                        console.error('PLAYWRIGHT_BACKEND_JS: Failed to inject JS file:', e.message);
-                        error = e.message;
-                        result = false;
-                    }
-                } else {
-                    error = "Page not initialized.";
-                    result = false;
-                }
-                break;
+// --- Request routing ---
 
-            case "appendScriptElement":
-                // params: { scriptUrl }
-                if (page) {
-                    await page.addScriptTag({ url: params.scriptUrl });
-                }
-                break;
+// Every request goes through routeRequest while at least one routing feature is on, and through nothing at all
+// otherwise: an installed route costs a hop per request even when it just continues.
+let routeInstalled = false;
 
-            case "sendEvent":
-                // params: { type, arg1, arg2, mouseButton, modifierArg }
-                if (page) {
-                    const eventType = params.type;
-                    switch (eventType) {
-                        case "click":
-                        case "dblclick":
-                        case "mousedown":
-                        case "mouseup":
-                        case "mousemove":
-                            // arg1, arg2 are x, y coordinates
-                            await page.mouse[eventType](params.arg1, params.arg2, { button: params.mouseButton || 'left' });
-                            break;
-                        case "keydown":
-                        case "keyup":
-                        case "keypress":
-                            // arg1 is key, arg2 is text (optional)
-                            // Playwright typically uses page.keyboard.press or page.keyboard.type
-                            // Need to map Qt key codes to Playwright keys or use direct character.
-                            if (params.arg2) { // If text provided, assume direct typing
-                                await page.keyboard.type(params.arg2);
-                            } else if (params.arg1) { // Else, try to press the key code
-                                // This requires mapping Qt virtual key codes to Playwright string keys
-                                console.warn(`PLAYWRIGHT_BACKEND_JS: sendEvent keydown/up/press with Qt key codes (arg1) not fully mapped. Arg1: ${params.arg1}`);
-                                await page.keyboard.press(String.fromCharCode(params.arg1)); // Basic attempt
-                            }
-                            break;
-                        default:
-                            console.warn(`PLAYWRIGHT_BACKEND_JS: Unsupported event type for sendEvent: ${eventType}`);
-                            break;
-                    }
-                    result = true;
-                } else {
-                    error = "Page not initialized.";
-                    result = false;
-                }
-                break;
+function routingWanted() {
+    return !!requestFilter || !!interception || !!diskCache || responseCacheEnabled || !!archiveWriter
+        || !!archiveReplay;
+}
 
-            case "uploadFile":
-                // params: { selector, fileNames[] }
-                if (page) {
-                    await page.setInputFiles(params.selector, params.fileNames);
-                    result = true;
-                }
-                break;
+async function updateRouting() {
+    const wanted = routingWanted();
+    if (wanted !== routeInstalled) {
+        routeInstalled = wanted;
+        if (wanted) {
+            await requirePage().route('**/*', routeRequest);
+        } else {
+            await requirePage().unroute('**/*', routeRequest);
+        }
+    }
+}
 
-            case "applySettings":
-                // params: { settingsMap }
-                if (browserContext) {
-                    const settings = params.settingsMap;
+async function routeRequest(route, request) {
+    if (requestFilter && filterBlocks(requestFilter, request)) {
+        return route.abort('blockedbyclient');
+    }
+    if (interception) {
+        const pending = pendingRequest(resourceId(request));
+        pending.route = route;
+        if (pending.decision !== undefined) {
+            settleRequest(resourceId(request));
+        }
+        return;
+    }
+    return forwardRequest(route);
+}
 
-                    if (settings.userAgent !== undefined) {
-                        await browserContext.setUserAgent(settings.userAgent);
-                    }
-                    if (settings.customHeaders !== undefined) {
-                        // Playwright's setExtraHTTPHeaders is for *future* requests on the page.
-                        // For context-wide headers, it's set during context creation.
-                        // If it's a page setting, apply to current page:
-                        if (page) await page.setExtraHTTPHeaders(settings.customHeaders);
-                    }
-                    if (settings.viewportSize !== undefined && page) {
-                        await page.setViewportSize(settings.viewportSize);
-                    }
-                    if (settings.ignoreSslErrors !== undefined) {
-                        // This is a browser launch option, or context option for newContext.
-                        // Can't change on existing context/page dynamically for this.
-                        console.warn(`PLAYWRIGHT_BACKEND_JS: 'ignoreSslErrors' cannot be changed dynamically on existing context. Apply during browser/context creation.`);
-                    }
-                    if (settings.offlineStoragePath !== undefined) {
-                        console.warn(`PLAYWRIGHT_BACKEND_JS: 'offlineStoragePath' not directly configurable post-context creation.`);
-                    }
-                    if (settings.localStoragePath !== undefined) {
-                        console.warn(`PLAYWRIGHT_BACKEND_JS: 'localStoragePath' not directly configurable post-context creation.`);
-                    }
-                    // Disk cache settings are typically browser launch args.
-                    // Playwright contexts can clear cache with browserContext.clearCookies/clearPermissions().
-                    // Max disk cache size is not directly exposed.
-
-                    // Resource timeout can be set per page or per operation.
-                    if (settings.resourceTimeout !== undefined && page) {
-                        page.setDefaultTimeout(settings.resourceTimeout);
-                        page.setDefaultNavigationTimeout(settings.resourceTimeout);
-                    }
-                    if (settings.zoomFactor !== undefined && page) {
-                        // Playwright page doesn't have a direct zoomFactor. You'd evaluate JS to change CSS zoom.
-                        await page.evaluate(z => document.body.style.zoom = z, settings.zoomFactor);
-                    }
+// Sends a request on to the network, or through the replayed archive and the caches that apply to it.
+function forwardRequest(route, overrides = {}) {
+    if (archiveReplay) {
+        return replayRequest(archiveReplay, route, overrides).catch(() => route.abort('failed').catch(() => {}));
+    }
+    return forwardToNetwork(route, overrides);
+}
 
-                    // SSL protocols/ciphers/certs are mostly browser launch options.
-                    console.warn("PLAYWRIGHT_BACKEND_JS: SSL, disk cache, and some storage settings are typically set at browser/context launch and are not dynamically changeable.");
-                    result = true;
-                } else {
-                    error = "Browser context not initialized.";
-                    result = false;
-                }
-                break;
+function forwardToNetwork(route, overrides) {
+    const request = route.request();
+    const cached = request.method() === 'GET' && (diskCache || sharesResponse(request));
+    if (!cached && !archiveWriter) {
+        return route.continue(overrides);
+    }
+    return serveFromCaches(route, overrides).catch(() => route.continue(overrides).catch(() => {}));
+}
 
-            case "getUserAgent":
-                if (page) result = await page.evaluate(() => navigator.userAgent);
-                break;
-            case "setUserAgent":
-                if (browserContext) await browserContext.setUserAgent(params.userAgent);
-                else if (page) await page.setUserAgent(params.userAgent); // Fallback for old Playwright or just current page
-                break;
+// The shared memory cache is consulted first, then the disk cache, then the network. Whatever is fetched is
+// fulfilled from here (redirects included, which the browser then follows), so it can be stored, and recorded, on
+// the way.
+async function serveFromCaches(route, overrides) {
+    const request = route.request();
+    const url = overrides.url || request.url();
+    const headers = overrides.headers || request.headers();
+    const get = request.method() === 'GET';
+    const shared = get && sharesResponse(request);
+    let response = null;
+    if (shared) {
+        const lowercase = {};
+        for (const [name, value] of Object.entries(headers)) {
+            lowercase[name.toLowerCase()] = value;
+        }
+        const cached = await requestReply('responseCacheLookup', { url, headers: lowercase },
+            ResponseCacheLookupTimeoutMs, { found: false });
+        if (cached.found) {
+            const body = Buffer.from(cached.body, 'base64');
+            response = { status: cached.status, headers: cached.headers, body, fromCache: true };
+        }
+    }
+    if (!response) {
+        if (get && diskCache) {
+            response = await diskCacheResponse(diskCache, route, url, headers, overrides);
+        } else {
+            const fetched = await route.fetch({ ...overrides, maxRedirects: 0 });
+            const body = await fetched.body();
+            response = { status: fetched.status(), headers: storedHeaders(fetched.headers()), body,
+                encodedSize: transferSize(fetched.headers()) };
+        }
+        if (shared) {
+            shareResponse(url, headers, response);
+        }
+    }
+    if (archiveWriter) {
+        archiveWriter.add(requestKey(request.method(), url, request.postDataBuffer()), response.status,
+            response.headers, response.body);
+    }
+    fulfilledHere.set(request, {
+        fromCache: !!response.fromCache,
+        // Cached bodies are stored decoded, so what was read from a cache is the body itself.
+        encodedSize: response.fromCache ? response.body.length : response.encodedSize,
+        decodedSize: response.body.length
+    });
+    return route.fulfill({ status: response.status, headers: response.headers, body: response.body });
+}
 
-            case "getViewportSize":
-                if (page) result = await page.viewportSize();
-                break;
-            case "setViewportSize":
-                if (page) await page.setViewportSize({ width: params.width, height: params.height });
-                break;
+// --- Network archive ---
+
+// Replay serves every recorded request straight from the archive. A request that wasn't recorded fails as if
+// the machine were offline, or goes to the network when the replay falls through.
+async function replayRequest(replay, route, overrides) {
+    const request = route.request();
+    const url = overrides.url || request.url();
+    const recorded = await replay.reader.lookup(requestKey(request.method(), url, request.postDataBuffer()));
+    if (recorded) {
+        const size = recorded.body.length;
+        fulfilledHere.set(request, { fromCache: true, encodedSize: size, decodedSize: size });
+        return route.fulfill(recorded);
+    }
+    if (replay.fallThrough) {
+        return forwardToNetwork(route, overrides);
+    }
+    return route.abort('internetdisconnected');
+}
 
-            case "getClipRect":
-                // Playwright screenshot options handle clipRect directly. No persistent clipRect on page.
-                result = { x: 0, y: 0, width: 0, height: 0 }; // Placeholder
-                break;
-            case "setClipRect":
-                // This is a rendering setting, not a persistent page property in Playwright.
-                // We'll pass it to renderImage/renderPdf.
-                console.warn("PLAYWRIGHT_BACKEND_JS: setClipRect is a rendering-specific parameter, not a persistent page property.");
-                break;
+// --- Shared memory cache ---
 
-            case "getScrollPosition":
-                if (page) result = await page.evaluate(() => ({ x: window.scrollX, y: window.scrollY }));
-                break;
-            case "setScrollPosition":
-                if (page) await page.evaluate(pos => window.scrollTo(pos.x, pos.y), params);
-                break;
+// Only the static subresources pages of one site have in common; documents and XHRs are rarely reused as they are.
+const SharedResourceTypes = new Set(['script', 'stylesheet', 'image', 'font']);
+// C++ answers lookups between commands, so one busy in another page's long sync command (a PDF export, say) would
+// stall every subresource of this one; past this, the lookup counts as a miss and the response is fetched.
+const ResponseCacheLookupTimeoutMs = 250;
 
-            case "setNavigationLocked":
-                // Playwright doesn't have a direct 'navigation locked' flag.
-                // This would involve request interception to block navigations.
-                console.warn("PLAYWRIGHT_BACKEND_JS: setNavigationLocked not implemented. Requires request interception.");
-                result = true;
-                break;
-            case "navigationLocked":
-                result = false; // Not implemented
-                break;
+function sharesResponse(request) {
+    return responseCacheEnabled && SharedResourceTypes.has(request.resourceType());
+}
 
-            case "getCustomHeaders":
-                if (page) result = page.request.headers(); // Headers of last request, not globally set
-                break;
-            case "setCustomHeaders":
-                if (page) await page.setExtraHTTPHeaders(params.headers);
-                break;
+// Offers a response to the cache in C++ with its expiry; responses without a freshness lifetime are left out, as
+// the memory cache never revalidates.
+function shareResponse(url, requestHeaders, response) {
+    const vary = storableVary('GET', response.status, requestHeaders, response.headers);
+    const lifetime = vary ? freshnessLifetime(response.headers) : 0;
+    if (lifetime > 0) {
+        sendEvent('responseCacheStore', {
+            url,
+            vary,
+            expires: (response.responseTime || Date.now()) + lifetime,
+            status: response.status,
+            headers: response.headers,
+            body: response.body.toString('base64')
+        });
+    }
+}
 
-            case "getZoomFactor":
-                if (page) result = await page.evaluate(() => parseFloat(document.body.style.zoom) || 1.0);
-                break;
-            case "setZoomFactor":
-                if (page) await page.evaluate(z => document.body.style.zoom = z, params.zoom);
-                break;
+function resourceId(request) {
+    let id = resourceIds.get(request);
+    if (id === undefined) {
+        id = nextResourceId++;
+        resourceIds.set(request, id);
+    }
+    return id;
+}
 
-            case "getOfflineStoragePath":
-            case "getOfflineStorageQuota":
-            case "getLocalStoragePath":
-            case "getLocalStorageQuota":
-                console.warn(`PLAYWRIGHT_BACKEND_JS: Storage path/quota commands '${command}' are not directly exposed by Playwright.`);
-                result = (command.includes("Quota")) ? -1 : "";
-                break;
+// Phases of a request in ms, from Playwright's request.timing(); -1 for those that did not happen (reused
+// connection, plain HTTP, fulfilled by the backend) or are not known yet. `connect` is TCP only, `tls` the
+// handshake after it, `total` from the start of the request to the last byte.
+function resourceTimings(timing) {
+    const span = (start, end) => (start >= 0 && end >= start ? end - start : -1);
+    const tcpEnd = timing.secureConnectionStart >= 0 ? timing.secureConnectionStart : timing.connectEnd;
+    return {
+        dns: span(timing.domainLookupStart, timing.domainLookupEnd),
+        connect: span(timing.connectStart, tcpEnd),
+        tls: span(timing.secureConnectionStart, timing.connectEnd),
+        ttfb: span(timing.requestStart, timing.responseStart),
+        download: span(timing.responseStart, timing.responseEnd),
+        total: timing.responseEnd >= 0 ? timing.responseEnd : -1
+    };
+}
 
+// resourceReceived data as PhantomJS had it: a 'start' stage when the headers are in, an 'end' stage when the
+// body is.
+function receivedData(response, stage) {
+    const headers = response.headers();
+    return {
+        id: resourceId(response.request()),
+        url: response.url(),
+        status: response.status(),
+        statusText: response.statusText(),
+        headers,
+        contentType: headers['content-type'] || null,
+        redirectURL: headers.location || null,
+        time: new Date().toISOString(),
+        stage
+    };
+}
 
-            case "renderImage":
-                // params: { clipRect, onlyViewport, scrollPosition }
-                if (page) {
-                    const screenshotOptions = {};
-                    if (params.clipRect && (params.clipRect.width > 0 || params.clipRect.height > 0)) {
-                        screenshotOptions.clip = params.clipRect;
-                    }
-                    screenshotOptions.fullPage = !params.onlyViewport;
-                    screenshotOptions.encoding = 'base64'; // Always base64 for IPC
+// The end stage adds the timing breakdown and the body sizes: `encodedSize` as it came over the network,
+// `decodedSize` after content decoding. The browser doesn't report decoded sizes, so they are only known for
+// responses the backend fulfilled itself or that were not content-encoded; -1 otherwise.
+async function sendResourceFinished(request) {
+    const response = await request.response().catch(() => null);
+    if (!response) {
+        return;
+    }
+    const sizes = await request.sizes().catch(() => null);
+    const local = fulfilledHere.get(request);
+    const data = receivedData(response, 'end');
+    if (local) {
+        data.encodedSize = local.encodedSize;
+        data.decodedSize = local.decodedSize;
+    } else {
+        data.encodedSize = sizes ? sizes.responseBodySize : -1;
+        data.decodedSize = data.headers['content-encoding'] ? -1 : data.encodedSize;
+    }
+    data.fromCache = local ? local.fromCache : false;
+    data.timings = resourceTimings(request.timing());
+    sendEvent('resourceReceived', data);
+}
 
-                    // Apply scroll position before screenshot if not full page
-                    if (page && params.scrollPosition && !screenshotOptions.fullPage) {
-                        await page.evaluate(pos => window.scrollTo(pos.x, pos.y), params.scrollPosition);
-                    }
+// --- Load completion ---
+
+// What load() waits for before it reports loadFinished, from the page's waitUntil setting. `event` is the
+// navigation milestone: 'domcontentloaded', 'load' (the default) or 'networkidle', which waits for the load event
+// and then for at most `connections` requests in flight during `idleTime` ms. A `selector` to appear and a
+// `predicate` (a JavaScript expression) to become truthy are waited for after it. All of it has to happen within
+// `timeout` ms, or the load fails.
+function loadStrategy(waitUntil) {
+    const strategy = {
+        event: waitUntil.event || 'load',
+        connections: Math.max(0, waitUntil.connections || 0),
+        idleTime: waitUntil.idleTime >= 0 ? waitUntil.idleTime : 500,
+        selector: waitUntil.selector || null,
+        predicate: waitUntil.predicate || null,
+        timeout: waitUntil.timeout > 0 ? waitUntil.timeout : loadTimeout
+    };
+    if (!['domcontentloaded', 'load', 'networkidle'].includes(strategy.event)) {
+        console.warn(`PLAYWRIGHT_BACKEND_JS: Unknown waitUntil event '${strategy.event}', waiting for 'load'`);
+        strategy.event = 'load';
+    }
+    return strategy;
+}
 
-                    try {
-                        result = await page.screenshot(screenshotOptions);
-                    } catch (e) {
-                        console.error('PLAYWRIGHT_BACKEND_JS: Error taking screenshot:', e.message);
-                        error = e.message;
-                        result = "";
-                    }
-                } else {
-                    error = "Page not initialized.";
-                    result = "";
-                }
-                break;
+// Tracks the page's requests in flight. idle() resolves once no more than `connections` of them have been in
+// flight for `idleTime` ms, counting from when it is called.
+class NetworkIdleWatcher {
+    constructor(p, connections, idleTime) {
+        this.page = p;
+        this.connections = connections;
+        this.idleTime = idleTime;
+        this.inFlight = new Set();
+        this.timer = null;
+        this.resolve = null;
+        this.started = request => {
+            this.inFlight.add(request);
+            this.check();
+        };
+        this.ended = request => {
+            if (this.inFlight.delete(request)) {
+                this.check();
+            }
+        };
+        p.on('request', this.started);
+        p.on('requestfinished', this.ended);
+        p.on('requestfailed', this.ended);
+    }
 
-            case "renderPdf":
-                // params: { paperSize, clipRect }
-                if (page) {
-                    const pdfOptions = {
-                        printBackground: true, // Typically needed for accurate renders
-                    };
-
-                    // Map paperSize options
-                    if (params.paperSize) {
-                        if (params.paperSize.format) pdfOptions.format = params.paperSize.format;
-                        if (params.paperSize.width) pdfOptions.width = params.paperSize.width; // e.g., "8.5in"
-                        if (params.paperSize.height) pdfOptions.height = params.paperSize.height; // e.g., "11in"
-                        // Margins
-                        const margins = {};
-                        if (params.paperSize.margin && typeof params.paperSize.margin === 'object') {
-                            if (params.paperSize.margin.top) margins.top = params.paperSize.margin.top;
-                            if (params.paperSize.margin.bottom) margins.bottom = params.paperSize.margin.bottom;
-                            if (params.paperSize.margin.left) margins.left = params.paperSize.margin.left;
-                            if (params.paperSize.margin.right) margins.right = params.paperSize.margin.right;
-                            if (Object.keys(margins).length > 0) pdfOptions.margin = margins;
-                        }
-                        if (params.paperSize.orientation === 'landscape') pdfOptions.landscape = true;
-                        // Header/Footer templates (more complex, might need JS evaluation)
-                        // Playwright uses displayHeaderFooter with template for this.
-                        if (params.paperSize.header) {
-                            console.warn("PLAYWRIGHT_BACKEND_JS: PDF headers not fully implemented.");
-                        }
-                        if (params.paperSize.footer) {
-                            console.warn("PLAYWRIGHT_BACKEND_JS: PDF footers not fully implemented.");
-                        }
-                    }
+    check() {
+        clearTimeout(this.timer);
+        this.timer = this.resolve && this.inFlight.size <= this.connections
+            ? setTimeout(this.resolve, this.idleTime)
+            : null;
+    }
 
-                    try {
-                        const pdfBuffer = await page.pdf(pdfOptions);
-                        result = pdfBuffer.toString('base64');
-                    } catch (e) {
-                        console.error('PLAYWRIGHT_BACKEND_JS: Error generating PDF:', e.message);
-                        error = e.message;
-                        result = "";
-                    }
-                } else {
-                    error = "Page not initialized.";
-                    result = "";
-                }
-                break;
+    idle() {
+        return new Promise(resolve => {
+            this.resolve = resolve;
+            this.check();
+        });
+    }
 
+    dispose() {
+        clearTimeout(this.timer);
+        this.page.off('request', this.started);
+        this.page.off('requestfinished', this.ended);
+        this.page.off('requestfailed', this.ended);
+    }
+}
 
-            // --- Cookie Management ---
-            case "getCookies":
-                if (browserContext) {
-                    const cookies = await browserContext.cookies();
-                    result = cookies.map(c => ({
-                        name: c.name,
-                        value: c.value,
-                        domain: c.domain,
-                        path: c.path,
-                        expires: c.expires ? new Date(c.expires * 1000).toGMTString() : undefined, // Convert timestamp to GMT string
-                        httponly: c.httpOnly,
-                        secure: c.secure,
-                        // session: c.session // Playwright has this, PhantomJS might not
-                    }));
-                } else {
-                    error = "Browser context not initialized.";
-                }
-                break;
+// The part of a load() after the navigation milestone: network idle, selector and predicate, in that order.
+async function settleLoad(p, load, strategy, idle, deadline) {
+    const remaining = () => Math.max(1, deadline - Date.now());
+    let success = true;
+    try {
+        if (idle) {
+            let timer;
+            await Promise.race([
+                idle.idle(),
+                new Promise((resolve, reject) => {
+                    timer = setTimeout(() => reject(new Error(`Network not idle after ${strategy.timeout} ms`)),
+                        remaining());
+                })
+            ]).finally(() => clearTimeout(timer));
+        }
+        if (strategy.selector) {
+            await p.waitForSelector(strategy.selector, { timeout: remaining() });
+        }
+        if (strategy.predicate) {
+            await p.waitForFunction(strategy.predicate, undefined, { timeout: remaining() });
+        }
+    } catch (e) {
+        console.error('PLAYWRIGHT_BACKEND_JS: Load strategy not met:', e.message);
+        success = false;
+    } finally {
+        if (idle) {
+            idle.dispose();
+        }
+    }
+    finishLoad(load, success, p.url());
+}
 
-            case "setCookies":
-                if (browserContext) {
-                    const cookies = params.cookies.map(c => ({
-                        name: c.name,
-                        value: c.value,
-                        domain: c.domain,
-                        path: c.path,
-                        // expires: c.expires ? Math.floor(new Date(c.expires).getTime() / 1000) : -1, // Convert GMT string to timestamp
-                        // Playwright expects expires as seconds since epoch or Date object.
-                        // If expires is a string like "GMT format", parse it.
-                        expires: c.expires ? (new Date(c.expires).getTime() / 1000) : undefined, // Playwright handles undefined for session
-                        httpOnly: c.httponly,
-                        secure: c.secure
-                    })).filter(c => c.name && c.value && c.domain); // Filter out invalid cookies
-
-                    await browserContext.addCookies(cookies);
-                    result = true;
-                } else {
-                    error = "Browser context not initialized.";
-                    result = false;
-                }
-                break;
+// Reports a load() once, unless a later navigation superseded it.
+function finishLoad(load, success, url) {
+    if (load !== currentLoad) {
+        return;
+    }
+    loadInProgress = false;
+    sendEvent('loadFinished', { success, url });
+}
 
-            case "addCookie":
-                if (browserContext) {
-                    const c = params.cookie;
-                    const cookie = {
-                        name: c.name,
-                        value: c.value,
-                        domain: c.domain,
-                        path: c.path,
-                        expires: c.expires ? (new Date(c.expires).getTime() / 1000) : undefined,
-                        httpOnly: c.httponly,
-                        secure: c.secure
-                    };
-                    if (cookie.name && cookie.value && cookie.domain) { // Basic validation
-                        await browserContext.addCookies([cookie]);
-                        result = true;
-                    } else {
-                        result = false;
-                        error = "Invalid cookie format for addCookie.";
-                    }
-                } else {
-                    error = "Browser context not initialized.";
-                    result = false;
-                }
-                break;
+// setHtml, reload and history navigation report loadFinished from the page's load event, as PhantomJS did.
+function releaseLoadEvents() {
+    ++currentLoad;
+    loadInProgress = false;
+    ownsLoadEvents = false;
+}
 
-            case "deleteCookie":
-                if (browserContext) {
-                    // Playwright doesn't have a direct deleteCookie by name.
-                    // Need to get all, filter, then set the rest. Or clear all and re-add.
-                    // The easiest way is to set an expired cookie.
-                    const cookieName = params.cookieName;
-                    await browserContext.addCookies([{
-                        name: cookieName,
-                        value: 'deleted',
-                        domain: page.url().split('/')[2], // Use current page's domain as a guess
-                        path: '/',
-                        expires: 0 // Set to expire immediately
-                    }]);
-                    result = true; // Assume success
-                } else {
-                    error = "Browser context not initialized.";
-                    result = false;
-                }
-                break;
+// --- Request interception ---
+
+// An intercepted request waits for two things: its route (routeRequest) and the decision C++ makes when it sees
+// the resourceRequested event (resolveRequests). Either may come first. A request whose decision doesn't arrive
+// within the deadline continues unchanged, so a slow or missing callback never stalls a page load.
+function pendingRequest(id) {
+    let pending = pendingRequests.get(id);
+    if (!pending) {
+        pending = { route: null, decision: undefined, timer: null };
+        pending.timer = setTimeout(() => {
+            if (pending.decision === undefined) {
+                pending.decision = null;
+            }
+            if (pending.route) {
+                settleRequest(id);
+            } else {
+                pendingRequests.delete(id);
+            }
+        }, interception ? interception.deadline : 0);
+        pendingRequests.set(id, pending);
+    }
+    return pending;
+}
 
-            case "clearCookies":
-                if (browserContext) {
-                    await browserContext.clearCookies();
-                    result = true;
-                } else {
-                    error = "Browser context not initialized.";
-                    result = false;
-                }
-                break;
+function settleRequest(id) {
+    const pending = pendingRequests.get(id);
+    pendingRequests.delete(id);
+    clearTimeout(pending.timer);
+    const decision = pending.decision;
+    if (decision && decision.action === 'abort') {
+        pending.route.abort('aborted').catch(() => {});
+        return;
+    }
+    const overrides = {};
+    if (decision && decision.url) {
+        overrides.url = decision.url;
+    }
+    if (decision && decision.headers) {
+        const headers = { ...pending.route.request().headers() };
+        for (const [name, value] of Object.entries(decision.headers)) {
+            const key = Object.keys(headers).find(k => k.toLowerCase() === name.toLowerCase());
+            if (key !== undefined) {
+                delete headers[key];
+            }
+            if (value !== null && value !== undefined) {
+                headers[name] = String(value);
+            }
+        }
+        overrides.headers = headers;
+    }
+    forwardRequest(pending.route, overrides).catch(() => {});
+}
 
-            // --- Network / Proxy ---
-            case "setNetworkProxy":
-                // Playwright proxy settings are typically on browser launch or newContext.
-                // Re-creating browserContext is not ideal for dynamic changes.
-                // For now, log a warning. A full solution would restart context or use request interception.
-                console.warn("PLAYWRIGHT_BACKEND_JS: Dynamic proxy change not fully supported. Apply proxy at browser/context launch.");
-                result = true; // Assume success for now
-                break;
+// --- Disk cache ---
+
+const DefaultDiskCacheSize = 50; // MB, as QNetworkDiskCache
+
+async function configureDiskCache() {
+    const { enabled, maxSize, path: directory } = diskCacheSettings;
+    if (!enabled || !directory) {
+        diskCache = null;
+    } else {
+        const maxBytes = (maxSize > 0 ? maxSize : DefaultDiskCacheSize) * 1024 * 1024;
+        if (!diskCache || diskCache.directory !== directory) {
+            diskCache = new DiskCache(directory, maxBytes);
+        } else if (diskCache.maxBytes !== maxBytes) {
+            diskCache.maxBytes = maxBytes;
+            await diskCache.open();
+            await diskCache.evict();
+        }
+    }
+    await updateRouting();
+}
 
-            case "clearMemoryCache":
-                if (browserContext) {
-                    // Playwright context.clearCookies clears cache-related storage
-                    // and context.clearPermissions() might also affect.
-                    await browserContext.clearCookies(); // Clears HTTP cache, session cookies, etc.
-                    await browserContext.clearPermissions();
-                    result = true;
-                } else {
-                    error = "Browser context not initialized.";
-                    result = false;
-                }
-                break;
+// Fresh entries are served without touching the network; stale ones are revalidated with their validators, and a
+// 304 serves the stored body. Redirects are not followed here, so the browser sees (and caches) each hop itself.
+async function diskCacheResponse(cache, route, url, headers, overrides) {
+    const entry = await cache.lookup('GET', url, headers);
+    if (entry && cache.isFresh(entry)) {
+        return { ...entry, fromCache: true };
+    }
+    const conditional = entry ? revalidationHeaders(entry) : null;
+    const response = await route.fetch({
+        ...overrides,
+        headers: conditional ? { ...headers, ...conditional } : overrides.headers,
+        maxRedirects: 0
+    });
+    if (entry && response.status() === 304) {
+        return { ...await cache.refresh('GET', url, entry, response.headers()), fromCache: true };
+    }
+    const body = await response.body();
+    await cache.store('GET', url, headers, response.status(), response.headers(), body).catch(() => {});
+    return { status: response.status(), headers: storedHeaders(response.headers()), body,
+        encodedSize: transferSize(response.headers()) };
+}
 
-            case "setIgnoreSslErrors":
-                // This is a launch option, not dynamically changeable.
-                console.warn("PLAYWRIGHT_BACKEND_JS: 'setIgnoreSslErrors' is a browser launch option, not dynamically changeable.");
-                result = true;
-                break;
+// Body bytes as they came over the network: route.fetch() hands the body over decoded, so only the server's
+// Content-Length tells, when there is one.
+function transferSize(headers) {
+    const length = parseInt(headerValue(headers, 'content-length'), 10);
+    return length >= 0 ? length : -1;
+}
 
-            case "setSslProtocol":
-            case "setSslCiphers":
-            case "setSslCertificatesPath":
-            case "setSslClientCertificateFile":
-            case "setSslClientKeyFile":
-            case "setSslClientKeyPassphrase":
-                console.warn(`PLAYWRIGHT_BACKEND_JS: SSL configuration '${command}' is a browser launch option, not dynamically changeable.`);
-                result = true;
-                break;
+// --- Request filter ---
 
-            case "setResourceTimeout":
-                if (page) {
-                    page.setDefaultTimeout(params.timeoutMs);
-                    page.setDefaultNavigationTimeout(params.timeoutMs);
-                    result = true;
-                }
-                break;
+// Matches requests against the tables compiled by UrlFilter (src/core/urlfilter.cpp): host-only rules through the
+// domain trie, rules with a literal keyword through the Aho-Corasick automaton, the few others one by one. Only
+// the candidate rules found that way have their full pattern and options checked.
+function loadRequestFilter(tables) {
+    if (!tables || !tables.rules) {
+        return null;
+    }
+    const typeBits = new Map(tables.typeNames.map((name, i) => [name, 1 << i]));
+    return { ...tables, typeBits, patterns: new Array(tables.rules.length) };
+}
 
-            case "setMaxAuthAttempts":
-                console.warn("PLAYWRIGHT_BACKEND_JS: setMaxAuthAttempts not directly supported by Playwright.");
-                result = true;
-                break;
+// Sorted-array lookups into the flattened tables; -1 when there is no such edge or child.
+function binarySearch(values, begin, end, value) {
+    while (begin < end) {
+        const mid = (begin + end) >> 1;
+        if (values[mid] < value) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    return begin < values.length && values[begin] === value ? begin : -1;
+}
 
+function trieChild(trie, node, label) {
+    const i = binarySearch(trie.labels, trie.childStart[node], trie.childStart[node + 1], label);
+    return i < 0 || i >= trie.childStart[node + 1] ? -1 : trie.children[i];
+}
 
-            // --- Frame Management ---
-            // Playwright's `page.frames()` returns all frames, and `frame.childFrames()` for children.
-            // A "current frame" is usually set implicitly when interacting with page/frame elements.
-            // For these commands, we will operate on `page.mainFrame()` or explicitly provided frame references.
-            case "getFramesCount":
-                if (page) result = page.frames().length;
-                break;
-            case "getFramesName":
-                if (page) result = page.frames().map(f => f.name()).filter(Boolean); // Filter empty names
-                break;
-            case "getFrameName":
-                // For the currently active frame (main frame by default)
-                if (page) result = page.mainFrame().name();
-                break;
-            case "getFocusedFrameName":
-                // Playwright doesn't have a direct 'focused frame'.
-                // This would need custom tracking (e.g., via page.keyboard.press focusing elements in a frame)
-                console.warn("PLAYWRIGHT_BACKEND_JS: getFocusedFrameName not implemented. Returning empty string.");
-                result = "";
-                break;
+function keywordEdge(keywords, state, c) {
+    const i = binarySearch(keywords.edgeChars, keywords.edgeStart[state], keywords.edgeStart[state + 1], c);
+    return i < 0 || i >= keywords.edgeStart[state + 1] ? -1 : keywords.edgeTargets[i];
+}
 
-            case "switchToFrameByName":
-                // params: { name }
-                if (page) {
-                    const targetFrame = page.frames().find(f => f.name() === params.name);
-                    if (targetFrame) {
-                        // For Playwright, switching frame means making subsequent operations target that frame.
-                        // We need to store which frame is "current" for subsequent evaluateJs etc.
-                        // This implies state management in the backend. For now, assume page.mainFrame() is the default.
-                        page = targetFrame; // !!! This is a simplification: subsequent calls to `page` will now operate on `targetFrame`. This breaks the "main page" concept.
-                                           // A better way is to pass a `frameId` from C++ and use `pages.get(frameId)`.
-                        console.warn("PLAYWRIGHT_BACKEND_JS: switchToFrameByName currently makes the target frame the new 'page' object. This might not be desired for all operations.");
-                        result = true;
-                    } else {
-                        result = false;
-                        error = `Frame with name '${params.name}' not found.`;
-                    }
-                } else { result = false; error = "Page not initialized."; }
-                break;
+function hostUnder(host, domain) {
+    return host === domain || host.endsWith('.' + domain);
+}
 
-            case "switchToFrameByPosition":
-                // params: { position }
-                if (page) {
-                    const frames = page.frames();
-                    if (params.position >= 0 && params.position < frames.length) {
-                        page = frames[params.position]; // Simplification, see above
-                        result = true;
-                    } else {
-                        result = false;
-                        error = `Frame at position ${params.position} not found.`;
-                    }
-                } else { result = false; error = "Page not initialized."; }
-                break;
+// Registrable domain without a public suffix list: the last two labels, or three under a short second-level
+// label ("example.co.uk"). Good enough to tell first- from third-party requests.
+function siteOf(host) {
+    const labels = host.split('.');
+    const n = labels.length >= 3 && labels[labels.length - 1].length === 2 && labels[labels.length - 2].length <= 3
+        ? 3 : 2;
+    return labels.slice(-n).join('.');
+}
 
-            case "switchToMainFrame":
-                if (browserContext) {
-                    page = pages.get('default'); // Restore default page
-                    result = true;
-                } else { result = false; error = "Browser context not initialized."; }
-                break;
+function requestTypeBit(filter, request) {
+    let type = request.resourceType();
+    if (type === 'document' && request.frame() !== request.frame().page().mainFrame()) {
+        type = 'subdocument';
+    }
+    return filter.typeBits.get(type) || filter.typeBits.get('other');
+}
 
-            case "switchToParentFrame":
-                if (page && page.parentFrame()) {
-                    page = page.parentFrame(); // Switch to parent
-                    result = true;
-                } else { result = false; error = "No parent frame to switch to."; }
-                break;
+function ruleMatches(filter, index, target) {
+    const rule = filter.rules[index];
+    if (!(rule.types & target.type)) {
+        return false;
+    }
+    if ((rule.party === 1 && target.thirdParty) || (rule.party === 2 && !target.thirdParty)) {
+        return false;
+    }
+    if (rule.domains && !rule.domains.some(domain => hostUnder(target.pageHost, domain))) {
+        return false;
+    }
+    if (rule.excludedDomains && rule.excludedDomains.some(domain => hostUnder(target.pageHost, domain))) {
+        return false;
+    }
+    if (rule.pattern === undefined) {
+        return true; // Host-only rule, already matched by the trie
+    }
+    if (filter.patterns[index] === undefined) {
+        try {
+            filter.patterns[index] = new RegExp(rule.pattern, rule.matchCase ? '' : 'i');
+        } catch (e) {
+            filter.patterns[index] = null; // Not valid JavaScript syntax; the rule never matches
+        }
+    }
+    return !!filter.patterns[index] && filter.patterns[index].test(target.url);
+}
 
-            case "switchToFocusedFrame":
-                // Not directly supported, see getFocusedFrameName.
-                console.warn("PLAYWRIGHT_BACKEND_JS: switchToFocusedFrame not implemented.");
-                result = false;
-                break;
+function filterBlocks(filter, request) {
+    const target = { url: request.url(), type: requestTypeBit(filter, request) };
+    if (filter.blockedTypes & target.type) {
+        return true;
+    }
+    let host;
+    try {
+        host = new URL(target.url).hostname.toLowerCase();
+    } catch (e) {
+        return false;
+    }
+    let pageHost = host;
+    try {
+        pageHost = new URL(requirePage().url()).hostname.toLowerCase() || host;
+    } catch (e) {
+        // about:blank and the like: treat the request as first-party
+    }
+    target.pageHost = pageHost;
+    target.thirdParty = siteOf(host) !== siteOf(pageHost);
+
+    const candidates = [];
+    const trie = filter.trie;
+    const labels = host.split('.');
+    for (let node = 0, i = labels.length - 1; i >= 0; --i) {
+        node = trieChild(trie, node, labels[i]);
+        if (node < 0) {
+            break;
+        }
+        for (let r = trie.ruleStart[node]; r < trie.ruleStart[node + 1]; ++r) {
+            candidates.push(trie.rules[r]);
+        }
+    }
+    const keywords = filter.keywords;
+    const url = target.url.toLowerCase();
+    for (let i = 0, state = 0; i < url.length; ++i) {
+        const c = url.charCodeAt(i);
+        let next = keywordEdge(keywords, state, c);
+        while (next < 0 && state !== 0) {
+            state = keywords.fail[state];
+            next = keywordEdge(keywords, state, c);
+        }
+        state = next < 0 ? 0 : next;
+        for (let s = state; s > 0; s = keywords.outLink[s]) {
+            for (let r = keywords.outStart[s]; r < keywords.outStart[s + 1]; ++r) {
+                candidates.push(keywords.outRules[r]);
+            }
+        }
+    }
+    candidates.push(...filter.fallback);
+
+    const blocked = candidates.some(index => !filter.rules[index].exception && ruleMatches(filter, index, target));
+    return blocked && !candidates.some(index => filter.rules[index].exception && ruleMatches(filter, index, target));
+}
 
+// --- Command handlers (one per command in playwright_protocol.json) ---
 
-            // --- JavaScript-to-C++ Callbacks (Exposing QObject for JS bridge) ---
-            case "exposeObject":
-                // params: { objectName, methods[], properties{} }
-                if (page) {
-                    const objectName = params.objectName;
-                    const methodsToExpose = params.methods || [];
-                    const propertiesToExpose = params.properties || {};
-
-                    // Store exposed object metadata for potential later use (e.g., property access)
-                    exposedObjects.set(objectName, { methods: new Set(methodsToExpose), properties: new Set(Object.keys(propertiesToExpose)) });
-
-                    // Expose a general function that browser JS can call to invoke C++ methods
-                    await page.exposeFunction(`_callCPlusPlus_${objectName}`, async (methodName, args) => {
-                        console.log(`PLAYWRIGHT_BACKEND_JS: JS called C++ method via exposed function: ${objectName}.${methodName}(${JSON.stringify(args)})`);
-                        const response = await callCPlusPlusSynchronously('callExposedQObjectMethod', {
-                            objectName: objectName,
-                            methodName: methodName,
-                            args: args
-                        });
-                        return response.result; // Return the result from C++ back to browser JS
-                    });
-
-                    // Inject a script that creates the global object in the browser
-                    // and maps its methods to the exposed Playwright function.
-                    const jsExposureScript = `(() => {
-                        window.${objectName} = {};
-                        const methods = ${JSON.stringify(Array.from(methodsToExpose))};
-                        for (const methodName of methods) {
-                            window.${objectName}[methodName] = async (...args) => {
-                                // Calls the Playwright exposed function
-                                return await window._callCPlusPlus_${objectName}(methodName, args);
-                            };
+const handlers = {
+    async init(params) {
+        if (params.protocolVersion !== PROTOCOL_VERSION) {
+            console.error(`PLAYWRIGHT_BACKEND_JS: Protocol version mismatch (C++ ${params.protocolVersion}, ` +
+                `Node ${PROTOCOL_VERSION}). Regenerate the bindings with tools/generate-protocol.py.`);
+        }
+        browser = await playwright.chromium.launch({ headless: true });
+        browserContext = await browser.newContext();
+        page = await browserContext.newPage();
+        setupPageEventListeners(page);
+        console.error('PLAYWRIGHT_BACKEND_JS: Browser and default page initialized.');
+        sendEvent('initialized');
+    },
+
+    // Reached both from the shutdown command and from stdin closing; only the first call closes the browser.
+    shutdown() {
+        if (!shuttingDown) {
+            shuttingDown = (async () => {
+                // A recording or HAR still running is finished, so the file can be used.
+                if (archiveWriter) {
+                    await archiveWriter.finish().catch(() => {});
+                    archiveWriter = null;
+                }
+                if (harWriter) {
+                    await harWriter.stop().catch(() => {});
+                    harWriter = null;
+                }
+                if (browser) {
+                    await browser.close();
+                    browser = null;
+                    browserContext = null;
+                    page = null;
+                    captureSession = null;
+                    exposedObjects.clear();
+                }
+                process.exit(0);
+            })();
+        }
+        return shuttingDown;
+    },
+
+    // --- Page content ---
+    async getUrl() { return requirePage().url(); },
+    async getTitle() { return await requirePage().title(); },
+    async getHtml() { return await frame().content(); },
+    async getPlainText() { return await frame().evaluate(() => document.body ? document.body.innerText : ''); },
+    async getWindowName() { return await requirePage().evaluate(() => window.name); },
+
+    // --- Navigation ---
+    async load(params) {
+        const p = requirePage();
+        await closeTemplatePool();
+        if (params.headers && Object.keys(params.headers).length > 0) {
+            extraHeaders = params.headers;
+            await p.setExtraHTTPHeaders(params.headers);
+        }
+        if (params.method && params.method !== 'GET') {
+            // page.goto() can only issue GET navigations.
+            console.warn(`PLAYWRIGHT_BACKEND_JS: ${params.method} navigation is not supported, using GET for ${params.url}`);
+        }
+        const strategy = loadStrategy(params.waitUntil || {});
+        const load = ++currentLoad;
+        const deadline = Date.now() + strategy.timeout;
+        // Counts requests from before the navigation starts, so the document's own are in flight when it loads.
+        const idle = strategy.event === 'networkidle'
+            ? new NetworkIdleWatcher(p, strategy.connections, strategy.idleTime)
+            : null;
+        loadInProgress = true;
+        ownsLoadEvents = true;
+        sendEvent('loadStarted', { url: params.url });
+        try {
+            await p.goto(params.url, {
+                waitUntil: strategy.event === 'domcontentloaded' ? 'domcontentloaded' : 'load',
+                timeout: strategy.timeout
+            });
+        } catch (e) {
+            console.error('PLAYWRIGHT_BACKEND_JS: Error during load:', e.message);
+            if (idle) {
+                idle.dispose();
+            }
+            finishLoad(load, false, params.url);
+            return;
+        }
+        // Not awaited: commands from the control script don't wait for the page to settle.
+        settleLoad(p, load, strategy, idle, deadline);
+    },
+
+    async setHtml(params) {
+        await closeTemplatePool();
+        releaseLoadEvents();
+        sendEvent('loadStarted', { url: params.baseUrl || 'about:blank' });
+        await requirePage().setContent(params.html, { waitUntil: 'load' });
+    },
+
+    async reload() {
+        await closeTemplatePool();
+        releaseLoadEvents();
+        sendEvent('loadStarted', { url: requirePage().url() });
+        await page.reload({ waitUntil: 'load' });
+    },
+
+    async stop() {
+        // Playwright has no equivalent of QWebPage::triggerAction(Stop).
+        await requirePage().evaluate(() => window.stop());
+    },
+
+    async canGoBack() { return false; },
+    async goBack() {
+        releaseLoadEvents();
+        return !!(await requirePage().goBack());
+    },
+    async canGoForward() { return false; },
+    async goForward() {
+        releaseLoadEvents();
+        return !!(await requirePage().goForward());
+    },
+    async goToHistoryItem(params) {
+        releaseLoadEvents();
+        await requirePage().evaluate(delta => history.go(delta), params.relativeIndex);
+        return true;
+    },
+
+    // --- Rendering ---
+    async setViewportSize(params) {
+        await requirePage().setViewportSize({ width: params.width, height: params.height });
+    },
+    async getViewportSize() { return requirePage().viewportSize(); },
+
+    // The clip rect is a rendering parameter in Playwright; C++ keeps it and passes it to renderImage/renderPdf.
+    async setClipRect() {},
+    async getClipRect() { return null; },
+
+    async setScrollPosition(params) {
+        await requirePage().evaluate(pos => window.scrollTo(pos.x, pos.y), { x: params.x, y: params.y });
+    },
+    async getScrollPosition() {
+        return await requirePage().evaluate(() => ({ x: window.scrollX, y: window.scrollY }));
+    },
+
+    async renderImage(params) {
+        const p = requirePage();
+        const options = { fullPage: !params.onlyViewport, type: params.format === 'jpeg' ? 'jpeg' : 'png' };
+        if (hasArea(params.clipRect)) {
+            options.clip = params.clipRect;
+        }
+        if (params.onlyViewport && params.scrollPosition) {
+            await p.evaluate(pos => window.scrollTo(pos.x, pos.y), params.scrollPosition);
+        }
+        const image = await p.screenshot(options);
+        return image.toString('base64');
+    },
+
+    // Viewport capture for latency-sensitive callers: straight from the compositor surface over a CDP session that
+    // lives as long as the page, without page.screenshot()'s bookkeeping and without a scroll round-trip (the page
+    // is captured where it is scrolled to). Resolves with the base64 PNG or JPEG.
+    async captureViewportFast(params) {
+        const p = requirePage();
+        captureSession = captureSession || await requireContext().newCDPSession(p);
+        const format = params.format === 'jpeg' ? 'jpeg' : 'png';
+        const options = { format, fromSurface: true, optimizeForSpeed: true };
+        if (format === 'jpeg' && params.quality >= 0) {
+            options.quality = params.quality;
+        }
+        try {
+            if (hasArea(params.clipRect)) {
+                // CDP clips in document coordinates, the clip rect is relative to the viewport.
+                const { cssVisualViewport } = await captureSession.send('Page.getLayoutMetrics');
+                options.clip = { ...params.clipRect, x: params.clipRect.x + cssVisualViewport.pageX,
+                    y: params.clipRect.y + cssVisualViewport.pageY, scale: 1 };
+            }
+            const { data } = await captureSession.send('Page.captureScreenshot', options);
+            return data;
+        } catch (e) {
+            captureSession = null; // Start over with a fresh session next time
+            throw e;
+        }
+    },
+
+    // Captures the loaded page at several viewport sizes without reloading it, then restores the viewport.
+    async renderViewports(params) {
+        const p = requirePage();
+        const original = p.viewportSize();
+        const images = [];
+        try {
+            for (const size of params.viewports || []) {
+                await p.setViewportSize({ width: size.width, height: size.height });
+                // Two animation frames: media queries and resize handlers have run and the result is painted.
+                await p.evaluate(() => new Promise(resolve =>
+                    requestAnimationFrame(() => requestAnimationFrame(resolve))));
+                if (params.settleTime > 0) {
+                    await p.waitForTimeout(params.settleTime);
+                }
+                const image = await p.screenshot({ fullPage: !params.onlyViewport, type: 'png' });
+                images.push(image.toString('base64'));
+            }
+        } finally {
+            if (original) {
+                await p.setViewportSize(original);
+            }
+        }
+        return images;
+    },
+
+    // Document-coordinate boxes (rounded outwards) of the elements matching each selector; [] when nothing matches.
+    async getElementRects(params) {
+        return await frame().evaluate(({ selectors, all }) => selectors.map(selector => {
+            const elements = all ? Array.from(document.querySelectorAll(selector))
+                : [document.querySelector(selector)].filter(Boolean);
+            return elements.map(element => {
+                const r = element.getBoundingClientRect();
+                const x = Math.floor(r.left + window.scrollX);
+                const y = Math.floor(r.top + window.scrollY);
+                return {
+                    x, y,
+                    width: Math.ceil(r.right + window.scrollX) - x,
+                    height: Math.ceil(r.bottom + window.scrollY) - y
+                };
+            }).filter(r => r.width > 0 && r.height > 0);
+        }), { selectors: params.selectors || [], all: !!params.all });
+    },
+
+    async renderPdf(params) {
+        const paperSize = params.paperSize || {};
+        if (paperSize.header || paperSize.footer) {
+            console.warn('PLAYWRIGHT_BACKEND_JS: PDF headers/footers are not implemented.');
+        }
+        const pdf = await requirePage().pdf(pdfOptions(paperSize));
+        return pdf.toString('base64');
+    },
+
+    // Prints with the output kept in the browser and relays it in chunks as pdfChunk events, so neither side ever
+    // holds the whole document. Resolves with the byte count once the last chunk has been sent.
+    async renderPdfStream(params) {
+        const session = await requireContext().newCDPSession(requirePage());
+        let bytes = 0;
+        try {
+            // Chromium only hands out the stream once it has laid out and printed the whole document, which can
+            // take much longer than C++ waits for a sync reply.
+            const stopKeepalive = keepalive('pdfPrinting', () => ({ streamId: params.streamId }));
+            const { stream } = await session.send('Page.printToPDF',
+                { ...printToPdfParams(params.paperSize || {}), transferMode: 'ReturnAsStream' })
+                .finally(stopKeepalive);
+            const size = params.chunkSize > 0 ? params.chunkSize : 1024 * 1024;
+            for await (const chunk of readStream(session, stream, size)) {
+                bytes += chunk.data.length;
+                const data = chunk.data.toString('base64');
+                sendEvent('pdfChunk', { streamId: params.streamId, data, eof: chunk.eof });
+            }
+        } finally {
+            await session.detach().catch(() => {});
+        }
+        return { bytes };
+    },
+
+    // Prints the document as consecutive page ranges of `pagesPerPart` pages, spread over `workers` cloned pages
+    // that pull the next range as soon as they are done. The page count isn't known up front: a range that comes
+    // back short, or that Chromium rejects as past the end, marks the end of the document. Resolves with the
+    // part files in page order; C++ merges them.
+    async renderPdfParts(params) {
+        const printParams = printToPdfParams(params.paperSize || {});
+        const pagesPerPart = Math.max(1, params.pagesPerPart);
+        // Loading the clones and printing the first ranges of a heavy page can outlast C++'s sync timeout before
+        // the first pdfPartRendered. There is no stream here; -1 stands for none.
+        const stopKeepalive = keepalive('pdfPrinting', () => ({ streamId: -1 }));
+        const clones = await Promise.all(Array.from({ length: Math.max(1, params.workers) },
+            () => clonePage({ javaScriptEnabled: false })))
+            .catch(e => {
+                stopKeepalive();
+                throw e;
+            });
+        const parts = [];
+        let next = 0;
+        let end = Infinity;
+
+        const work = async (clone) => {
+            const session = await clone.context.newCDPSession(clone.page);
+            for (let index = next++; index < end; index = next++) {
+                const first = index * pagesPerPart + 1;
+                const file = path.join(params.directory, `part-${index}.pdf`);
+                try {
+                    await printToFile(session, { ...printParams, pageRanges: `${first}-${first + pagesPerPart - 1}` },
+                        file);
+                } catch (e) {
+                    if (index === 0 || !PageRangePastEnd.test(e.message)) {
+                        throw e;
+                    }
+                    end = Math.min(end, index);
+                    break;
+                }
+                const pages = countPdfPages(await fs.readFile(file));
+                if (pages === 0) {
+                    end = Math.min(end, index);
+                    break;
+                }
+                parts[index] = file;
+                if (pages < pagesPerPart) {
+                    end = Math.min(end, index + 1);
+                }
+                sendEvent('pdfPartRendered', { index, pages });
+            }
+        };
+        try {
+            await Promise.all(clones.map(work));
+        } finally {
+            stopKeepalive();
+            await Promise.all(clones.map(clone => clone.context.close().catch(() => {})));
+        }
+
+        const ordered = parts.slice(0, end);
+        if (ordered.length === 0 || ordered.some(file => !file)) {
+            throw new Error('PDF page ranges are incomplete');
+        }
+        return ordered;
+    },
+
+    // --- Template mode ---
+    async applyTemplateData(params) {
+        await fillTemplate(requirePage(), params.data, params.timeout);
+        return true;
+    },
+
+    // Fills and captures the template once per job ({ data, file, format, quality }), spread over the main page
+    // and `workers - 1` copies of it. The copies stay open for later batches on the same template. Resolves with
+    // one error message per job, '' for the ones that were written.
+    async renderTemplateBatch(params) {
+        const p = requirePage();
+        const jobs = params.jobs || [];
+        const printParams = printToPdfParams(params.paperSize || {});
+        if (templatePool && templatePool.url !== p.url()) {
+            await closeTemplatePool();
+        }
+        templatePool = templatePool || { url: p.url(), clones: [] };
+        const wanted = Math.min(Math.max(1, params.workers), jobs.length) - 1;
+        // The copies load one after the other, which for a heavy template easily outlasts C++'s sync timeout
+        // before the first templateRendered.
+        const pool = templatePool;
+        const stopKeepalive = keepalive('templatePreparing', () => ({ clones: pool.clones.length }));
+        try {
+            while (pool.clones.length < wanted) {
+                pool.clones.push(await clonePage());
+                sendEvent('templatePreparing', { clones: pool.clones.length });
+            }
+        } finally {
+            stopKeepalive();
+        }
+        const targets = [p, ...templatePool.clones.slice(0, Math.max(0, wanted)).map(clone => clone.page)];
+        const errors = new Array(jobs.length).fill('');
+        let next = 0;
+
+        const work = async (target) => {
+            const session = await target.context().newCDPSession(target);
+            try {
+                for (let index = next++; index < jobs.length; index = next++) {
+                    const job = jobs[index];
+                    try {
+                        await fillTemplate(target, job.data, params.timeout);
+                        if (job.format === 'pdf') {
+                            await printToFile(session, printParams, job.file);
+                        } else {
+                            const options = { path: job.file, fullPage: true, type: job.format };
+                            if (job.format === 'jpeg' && job.quality >= 0) {
+                                options.quality = job.quality;
+                            }
+                            await target.screenshot(options);
                         }
-                        // Property getters/setters: for properties, we'd ideally expose getters/setters too.
-                        // For now, if JS calls a method that is actually a C++ property setter/getter,
-                        // it will be routed through the method call mechanism.
-                        // For example, if 'phantom.cookiesEnabled = true;' is called, Playwright will
-                        // look for a 'setCookiesEnabled' method on the exposed object.
-                        // Q_PROPERTY conversion handles this implicitly in C++.
-                        console.log('PLAYWRIGHT_BACKEND_JS: Injected JS for exposed object: ${objectName}');
-                    })();`;
-
-                    await page.addInitScript({ content: jsExposureScript });
-
-                    console.log(`PLAYWRIGHT_BACKEND_JS: Exposed object '${objectName}' to browser JS.`);
-                    result = true;
+                    } catch (e) {
+                        errors[index] = e.message || String(e);
+                    }
+                    sendEvent('templateRendered', { index, error: errors[index] });
+                }
+            } finally {
+                await session.detach().catch(() => {});
+            }
+        };
+        await Promise.all(targets.map(work));
+        return errors;
+    },
+
+    // --- Request filtering ---
+    async setRequestFilter(params) {
+        requestFilter = loadRequestFilter(params.tables);
+        await updateRouting();
+    },
+
+    // --- Request interception ---
+    async setRequestInterception(params) {
+        interception = params.enabled ? { deadline: params.deadline > 0 ? params.deadline : 500 } : null;
+        if (!interception) {
+            for (const [id, pending] of pendingRequests) {
+                pending.decision = null;
+                if (pending.route) {
+                    settleRequest(id);
                 } else {
-                    error = "Page not initialized.";
-                    result = false;
+                    clearTimeout(pending.timer);
+                    pendingRequests.delete(id);
                 }
-                break;
+            }
+        }
+        await updateRouting();
+    },
+
+    // Decisions of one batch, in the order C++ saw the requests.
+    async resolveRequests(params) {
+        for (const decision of params.decisions || []) {
+            const pending = pendingRequests.get(decision.id);
+            if (!pending || pending.decision !== undefined) {
+                continue; // Past its deadline already
+            }
+            pending.decision = decision;
+            if (pending.route) {
+                settleRequest(decision.id);
+            }
+        }
+    },
 
-            case "clickElement":
-                // params: { selector }
-                if (page) {
-                    await page.click(params.selector);
-                    result = true;
-                } else { error = "Page not initialized."; result = false; }
-                break;
+    // --- Shared memory cache ---
+    async setResponseCacheEnabled(params) {
+        responseCacheEnabled = !!params.enabled;
+        await updateRouting();
+    },
 
-            case "showInspector":
-                // Playwright does not have an embedded inspector in the same way QtWebKit did.
-                // This command would typically launch Playwright in non-headless mode for visual debugging.
-                // The `remotePort` param is not directly used by Playwright's built-in inspector.
-                console.log("PLAYWRIGHT_BACKEND_JS: 'showInspector' command received. Launching Playwright in non-headless mode for visual inspection if not already in headless mode.");
-                // To actually open DevTools, you need to launch non-headless browser and then `page.evaluate(() => { debugger; })`
-                // or just launch with `headless: false`.
-                // For now, this is just a log.
-                result = 0; // Indicate no specific port opened for external connection
-                break;
+    // --- Network archive ---
+    async startNetworkRecording(params) {
+        await handlers.stopNetworkRecording();
+        try {
+            archiveWriter = new ArchiveWriter(params.file);
+        } catch (e) {
+            console.error(`PLAYWRIGHT_BACKEND_JS: Cannot record to ${params.file}: ${e.message}`);
+            return false;
+        }
+        await updateRouting();
+        return true;
+    },
+
+    // Returns the number of responses written.
+    async stopNetworkRecording() {
+        if (!archiveWriter) {
+            return 0;
+        }
+        const writer = archiveWriter;
+        archiveWriter = null;
+        await updateRouting();
+        return await writer.finish();
+    },
+
+    // Returns the number of responses in the archive, or -1 if it cannot be read. An empty file stops replaying.
+    async setNetworkReplay(params) {
+        if (archiveReplay) {
+            archiveReplay.reader.close();
+            archiveReplay = null;
+        }
+        let records = 0;
+        if (params.file) {
+            try {
+                archiveReplay = { reader: new ArchiveReader(params.file), fallThrough: params.fallThrough };
+                records = archiveReplay.reader.recordCount;
+            } catch (e) {
+                console.error(`PLAYWRIGHT_BACKEND_JS: Cannot replay ${params.file}: ${e.message}`);
+                records = -1;
+            }
+        }
+        await updateRouting();
+        return records;
+    },
 
+    // --- HAR ---
+    async startHar(params) {
+        await handlers.stopHar();
+        try {
+            harWriter = new HarWriter(params.file, { name: 'PhantomJS', version: params.creatorVersion });
+        } catch (e) {
+            console.error(`PLAYWRIGHT_BACKEND_JS: Cannot write HAR to ${params.file}: ${e.message}`);
+            return false;
+        }
+        // Requests of a page that is already loading belong to it.
+        harWriter.startPage(requirePage().url()).title = await requirePage().title().catch(() => '');
+        return true;
+    },
+
+    // Returns the number of entries written, -1 if the file could not be completed.
+    async stopHar() {
+        if (!harWriter) {
+            return 0;
+        }
+        const writer = harWriter;
+        harWriter = null;
+        return await writer.stop().catch(e => {
+            console.error(`PLAYWRIGHT_BACKEND_JS: Writing ${writer.fileName} failed: ${e.message}`);
+            return -1;
+        });
+    },
+
+    // --- Screencast ---
+    // Chromium pushes a JPEG whenever the page paints and sends the next one once the previous is acknowledged.
+    // Frames are acknowledged straight away so the browser never stalls; frames arriving faster than `fps` are
+    // dropped here, so they don't even cross the pipe.
+    async startScreencast(params) {
+        await handlers.stopScreencast();
+        const session = await requireContext().newCDPSession(requirePage());
+        const state = { session, interval: params.fps > 0 ? 1000 / params.fps : 0, last: -Infinity };
+        session.on('Page.screencastFrame', ({ data, metadata, sessionId }) => {
+            session.send('Page.screencastFrameAck', { sessionId }).catch(() => {});
+            const timestamp = metadata.timestamp || Date.now() / 1000; // Seconds; optional in CDP
+            if (timestamp * 1000 - state.last >= state.interval) {
+                state.last = timestamp * 1000;
+                sendEvent('screencastFrame', { data, timestamp });
+            }
+        });
+        const options = { format: 'jpeg', quality: params.quality >= 0 ? params.quality : 80 };
+        if (params.maxWidth > 0) {
+            options.maxWidth = params.maxWidth;
+        }
+        if (params.maxHeight > 0) {
+            options.maxHeight = params.maxHeight;
+        }
+        await session.send('Page.startScreencast', options);
+        screencast = state;
+        return true;
+    },
+
+    async stopScreencast() {
+        if (screencast) {
+            const { session } = screencast;
+            screencast = null;
+            await session.send('Page.stopScreencast').catch(() => {});
+            await session.detach().catch(() => {});
+        }
+    },
+
+    async getZoomFactor() {
+        return await requirePage().evaluate(() => parseFloat(document.body.style.zoom) || 1.0);
+    },
+    async setZoomFactor(params) {
+        await requirePage().evaluate(z => { document.body.style.zoom = z; }, params.zoom);
+    },
+
+    // --- JavaScript execution ---
+    async evaluateJavaScript(params) {
+        return await frame().evaluate(params.code);
+    },
+
+    async injectJavaScriptFile(params) {
+        const source = await fs.readFile(params.path, 'utf8');
+        const frames = params.forEachFrame ? requirePage().frames() : [frame()];
+        for (const f of frames) {
+            await f.evaluate(source);
+        }
+        return true;
+    },
+
+    async exposeQObject(params) {
+        const p = requirePage();
+        const objectName = params.name;
+        const methods = params.methods || [];
+        exposedObjects.set(objectName, { methods: new Set(methods) });
+
+        await p.exposeFunction(`_callCPlusPlus_${objectName}`, async (methodName, args) => {
+            const reply = await requestReply('callExposedQObjectMethod', { objectName, methodName, args });
+            return reply.result;
+        });
+
+        await p.addInitScript({
+            content: `(() => {
+                window.${objectName} = {};
+                for (const methodName of ${JSON.stringify(methods)}) {
+                    window.${objectName}[methodName] = (...args) => window._callCPlusPlus_${objectName}(methodName, args);
+                }
+            })();`
+        });
+    },
+
+    async appendScriptElement(params) {
+        await frame().addScriptTag({ url: params.url });
+    },
+
+    // --- Settings ---
+    async getUserAgent() { return await requirePage().evaluate(() => navigator.userAgent); },
+    async setUserAgent(params) {
+        extraHeaders = { 'User-Agent': params.userAgent };
+        await requirePage().setExtraHTTPHeaders(extraHeaders);
+    },
+
+    // Navigation locking needs request interception; accepted but not enforced yet.
+    async setNavigationLocked() {},
+    async getNavigationLocked() { return false; },
+
+    async getCustomHeaders() { return null; },
+    async setCustomHeaders(params) {
+        extraHeaders = params.headers || {};
+        await requirePage().setExtraHTTPHeaders(extraHeaders);
+    },
+
+    setJavaScriptEnabled: launchOption('javaScriptEnabled'),
+    setWebSecurityEnabled: launchOption('webSecurityEnabled'),
+    setWebGLEnabled: launchOption('webGLEnabled'),
+    setJavaScriptCanOpenWindows: launchOption('javaScriptCanOpenWindows'),
+    setJavaScriptCanCloseWindows: launchOption('javaScriptCanCloseWindows'),
+    setLocalToRemoteUrlAccessEnabled: launchOption('localToRemoteUrlAccessEnabled'),
+    setAutoLoadImages: launchOption('autoLoadImages'),
+
+    setNetworkProxy: launchOption('proxy'),
+    async setDiskCacheEnabled(params) {
+        diskCacheSettings.enabled = !!params.enabled;
+        await configureDiskCache();
+    },
+    async setMaxDiskCacheSize(params) {
+        diskCacheSettings.maxSize = params.size;
+        await configureDiskCache();
+    },
+    async setDiskCachePath(params) {
+        diskCacheSettings.path = params.path || '';
+        await configureDiskCache();
+    },
+    setIgnoreSslErrors: launchOption('ignoreHTTPSErrors'),
+    setSslProtocol: launchOption('sslProtocol'),
+    setSslCiphers: launchOption('sslCiphers'),
+    setSslCertificatesPath: launchOption('sslCertificatesPath'),
+    setSslClientCertificateFile: launchOption('sslClientCertificateFile'),
+    setSslClientKeyFile: launchOption('sslClientKeyFile'),
+    setSslClientKeyPassphrase: launchOption('sslClientKeyPassphrase'),
+
+    async setResourceTimeout(params) {
+        requirePage().setDefaultTimeout(params.timeout);
+        page.setDefaultNavigationTimeout(params.timeout);
+        loadTimeout = params.timeout;
+    },
+    setMaxAuthAttempts: launchOption('maxAuthAttempts'),
+
+    setLocalStoragePath: launchOption('localStoragePath'),
+    async getLocalStorageQuota() { return -1; },
+    setOfflineStoragePath: launchOption('offlineStoragePath'),
+    async getOfflineStorageQuota() { return -1; },
+
+    async clearMemoryCache() {
+        const session = await requireContext().newCDPSession(requirePage());
+        await session.send('Network.clearBrowserCache');
+        await session.detach();
+    },
+
+    // --- Cookies ---
+    async setCookies(params) {
+        const context = requireContext();
+        await context.clearCookies();
+        await context.addCookies((params.cookies || []).map(toPlaywrightCookie).filter(c => c.name && c.domain));
+        return true;
+    },
+
+    async getCookies() {
+        const cookies = await requireContext().cookies();
+        return cookies.map(c => ({
+            name: c.name,
+            value: c.value,
+            domain: c.domain,
+            path: c.path,
+            expires: c.expires > 0 ? new Date(c.expires * 1000).toUTCString() : undefined,
+            httponly: c.httpOnly,
+            secure: c.secure
+        }));
+    },
+
+    async addCookie(params) {
+        const cookie = toPlaywrightCookie(params.cookie || {});
+        if (!cookie.name || !cookie.domain) {
+            return false;
+        }
+        await requireContext().addCookies([cookie]);
+        return true;
+    },
+
+    async deleteCookie(params) {
+        const context = requireContext();
+        const cookies = await context.cookies();
+        const remaining = cookies.filter(c => c.name !== params.name);
+        if (remaining.length === cookies.length) {
+            return false;
+        }
+        await context.clearCookies();
+        await context.addCookies(remaining);
+        return true;
+    },
+
+    async clearCookies() { await requireContext().clearCookies(); },
+
+    // --- Frames ---
+    // Frame commands are relative to the current frame, like QWebFrame in PhantomJS.
+    async getFramesCount() { return frame().childFrames().length; },
+    async getFramesName() { return frame().childFrames().map(f => f.name()); },
+
+    async switchToFrameByName(params) {
+        const target = frame().childFrames().find(f => f.name() === params.name);
+        if (!target) return false;
+        currentFrame = target;
+        return true;
+    },
+
+    async switchToFrameByPosition(params) {
+        const target = frame().childFrames()[params.position];
+        if (!target) return false;
+        currentFrame = target;
+        return true;
+    },
+
+    async getFrameName() { return frame().name(); },
+    async switchToMainFrame() { currentFrame = null; },
+
+    async switchToParentFrame() {
+        const parent = frame().parentFrame();
+        if (!parent) return false;
+        currentFrame = parent === requirePage().mainFrame() ? null : parent;
+        return true;
+    },
+
+    // Playwright doesn't track a focused frame.
+    async switchToFocusedFrame() { return false; },
+    async getFocusedFrameName() { return ''; },
+
+    // --- Input ---
+    async sendEvent(params) {
+        const p = requirePage();
+        switch (params.type) {
+            case 'click':
+                await p.mouse.click(params.arg1, params.arg2, { button: params.mouseButton || 'left' });
+                break;
+            case 'doubleclick':
+            case 'dblclick':
+                await p.mouse.dblclick(params.arg1, params.arg2, { button: params.mouseButton || 'left' });
+                break;
+            case 'mousedown':
+                await p.mouse.move(params.arg1, params.arg2);
+                await p.mouse.down({ button: params.mouseButton || 'left' });
+                break;
+            case 'mouseup':
+                await p.mouse.move(params.arg1, params.arg2);
+                await p.mouse.up({ button: params.mouseButton || 'left' });
+                break;
+            case 'mousemove':
+                await p.mouse.move(params.arg1, params.arg2);
+                break;
+            case 'keydown':
+            case 'keyup':
+            case 'keypress': {
+                const key = typeof params.arg1 === 'string' ? params.arg1 : String.fromCharCode(params.arg1);
+                if (params.type === 'keydown') await p.keyboard.down(key);
+                else if (params.type === 'keyup') await p.keyboard.up(key);
+                else if (key.length > 1) await p.keyboard.type(key);
+                else await p.keyboard.press(key);
+                break;
+            }
             default:
-                console.warn(`PLAYWRIGHT_BACKEND_JS: Unknown command: ${command}`);
-                error = `Unknown command: ${command}`;
+                console.warn(`PLAYWRIGHT_BACKEND_JS: Unsupported event type for sendEvent: ${params.type}`);
+                break;
+        }
+    },
+
+    async uploadFile(params) {
+        await frame().setInputFiles(params.selector, params.fileNames);
+    },
+
+    async showInspector() {
+        // There is no embedded inspector; run with a headed browser to debug.
+        return 0;
+    },
+
+    // --- Health ---
+    async ping(params) {
+        // Answering proves this event loop is alive; browserConnected tells C++ whether Chromium still is.
+        sendEvent('pong', { seq: params.seq, browserConnected: !browser || browser.isConnected() });
+    },
+
+    async setRepaintTracking(params) {
+        if (params.enabled && !repaintTracker) {
+            repaintTracker = await startRepaintTracking(requirePage());
+        } else if (!params.enabled && repaintTracker) {
+            await stopRepaintTracking(repaintTracker);
+            repaintTracker = null;
+        }
+    },
+    // Called right before an incremental capture: the events from the flush timer could still be in flight, so
+    // wait until the frame after the last DOM change has been painted and return what is pending synchronously.
+    async takeRepaints() {
+        if (!repaintTracker) {
+            return [];
+        }
+        await requirePage().evaluate(
+            () => new Promise(resolve => requestAnimationFrame(() => requestAnimationFrame(resolve)))).catch(() => {});
+        return repaintTracker ? takeRepaints(repaintTracker) : [];
+    },
+};
+
+const dispatchTable = buildDispatchTable(handlers);
+
+async function handleCommand(message) {
+    const { type, id, cmd, params } = message;
+    const handler = dispatchTable[cmd];
+
+    let result;
+    let error = null;
+    if (!handler) {
+        error = `Unknown command id: ${cmd}`;
+    } else {
+        try {
+            result = await handler(params || {});
+        } catch (e) {
+            console.error(`PLAYWRIGHT_BACKEND_JS: Error executing command ${cmd}:`, e.message);
+            error = e.message;
         }
-    } catch (e) {
-        console.error(`PLAYWRIGHT_BACKEND_JS: Error executing command ${command}:`, e.message, e.stack);
-        error = e.message;
     }
 
-    if (type === "sync_command") {
-        sendSyncResponse(id, { success: !error, result: result, error: error });
+    if (type === 'sync') {
+        sendResponse(id, result, error);
+    } else if (error) {
+        console.error(`PLAYWRIGHT_BACKEND_JS: Async command ${cmd} failed: ${error}`);
     }
 }
 
-// Attach basic Playwright page event listeners and relay them to C++
-function setupPageEventListeners(p, pageId) {
+// --- Page events ---
+
+// Attach Playwright page event listeners and relay them to C++
+function setupPageEventListeners(p) {
     p.on('console', msg => {
-        sendMessage('event', 'javaScriptConsoleMessage', { message: msg.text() });
+        sendEvent('javaScriptConsoleMessageSent', { message: msg.text() });
     });
 
     p.on('pageerror', error => {
-        // Attempt to parse the stack trace string from Playwright into a structured format
-        // Playwright's error.stack is typically like:
+        // Playwright's error.stack looks like:
         // Error: My error message
         //     at myFunction (file:///path/to/script.js:10:5)
-        //     at anotherFunction (<anonymous>:20:1)
-        const stackLines = error.stack ? error.stack.split('\n').slice(1) : []; // Remove the first line (error message)
+        const stackLines = error.stack ? error.stack.split('\n').slice(1) : [];
         const structuredStack = stackLines.map(line => {
-            // Regex to parse a stack line: "    at <functionName> (<url>:<lineNumber>:<columnNumber>)"
-            // Group 1: functionName (optional)
-            // Group 2: url (file path or <anonymous>)
-            // Group 3: lineNumber
-            // Group 4: columnNumber (optional)
             const match = line.match(/^\s*at (?:(.+?) )?\(?(?:(.+?):(\d+):(\d+))?\)?$/);
             if (match) {
                 return {
-                    url: match[2] || '', // file path or <anonymous>
+                    url: match[2] || '',
                     lineNumber: parseInt(match[3], 10) || 0,
                     columnNumber: parseInt(match[4], 10) || 0,
-                    functionName: match[1] || '' // The function name
+                    functionName: match[1] || ''
                 };
             }
-            return { url: '', lineNumber: 0, columnNumber: 0, functionName: line.trim() }; // Fallback for unparseable lines
-        }).filter(item => item.url || item.functionName); // Filter out any lines that yielded no useful info
+            return { url: '', lineNumber: 0, columnNumber: 0, functionName: line.trim() };
+        }).filter(item => item.url || item.functionName);
 
-        sendMessage('event', 'javaScriptError', {
+        sendEvent('javaScriptErrorSent', {
             message: error.message,
-            // The lineNumber and sourceID below might be redundant if `structuredStack` is fully used on the JS side.
-            // But keeping them for compatibility with existing C++ handler signature which expects these directly.
             lineNumber: structuredStack.length > 0 ? structuredStack[0].lineNumber : 0,
             sourceID: structuredStack.length > 0 ? structuredStack[0].url : '',
-            stack: JSON.stringify(structuredStack) // Send the structured stack as a JSON string
+            stack: JSON.stringify(structuredStack)
         });
     });
 
     p.on('request', request => {
-        sendMessage('event', 'resourceRequested', {
+        if (request.isNavigationRequest() && !request.redirectedFrom() && request.frame() === p.mainFrame()) {
+            // A new top-level document starts a new HAR page, and reports its own load unless load() does.
+            if (harWriter) {
+                harWriter.startPage(request.url());
+            }
+            if (!loadInProgress) {
+                ownsLoadEvents = false;
+            }
+        }
+        const id = resourceId(request);
+        const intercepted = !!interception && routeInstalled;
+        if (intercepted) {
+            pendingRequest(id);
+        }
+        sendEvent('resourceRequested', {
             url: request.url(),
             method: request.method(),
             headers: request.headers(),
-            id: request.url() // Use URL as temp ID for simplicity
+            id,
+            intercepted
         });
     });
 
-    p.on('response', async response => {
-        sendMessage('event', 'resourceReceived', {
-            url: response.url(),
-            status: response.status(),
-            statusText: response.statusText(),
-            headers: response.headers(),
-            id: response.url() // Use URL as temp ID
-        });
+    p.on('response', response => {
+        sendEvent('resourceReceived', receivedData(response, 'start'));
+    });
+
+    p.on('requestfinished', request => {
+        if (harWriter && !request.url().startsWith('data:')) {
+            harWriter.addRequest(request);
+        }
+        sendResourceFinished(request);
     });
 
     p.on('requestfailed', request => {
-        sendMessage('event', 'resourceError', {
+        if (harWriter && !request.url().startsWith('data:')) {
+            harWriter.addRequest(request, request.failure() ? request.failure().errorText : 'Unknown error');
+        }
+        sendEvent('resourceError', {
             url: request.url(),
-            errorText: request.failure() ? request.failure().errorText : 'Unknown error',
-            id: request.url()
+            errorString: request.failure() ? request.failure().errorText : 'Unknown error',
+            id: resourceId(request)
         });
     });
 
-    p.on('load', () => {
-        sendMessage('event', 'loadFinished', { success: true, url: p.url() }); // Re-emit on load
-    });
-
     p.on('domcontentloaded', () => {
-        // DOM content is loaded, might be a good time to inject initial scripts like bootstrap.js
-        // The `initialized` signal is typically for when the main JS environment is ready,
-        // often after exposed objects are set up.
-        // It's already triggered by the "init" command in `handleCommand` once.
+        if (harWriter) {
+            const harPage = harWriter.currentPage();
+            harPage.pageTimings.onContentLoad = Date.now() - harPage.started;
+        }
     });
 
-    p.on('url', url => {
-        sendMessage('event', 'urlChanged', { url: url });
+    p.on('load', () => {
+        if (harWriter) {
+            const harPage = harWriter.currentPage();
+            harPage.pageTimings.onLoad = Date.now() - harPage.started;
+            p.title().then(title => { harPage.title = title; }).catch(() => {});
+        }
+        if (!ownsLoadEvents) {
+            sendEvent('loadFinished', { success: true, url: p.url() });
+        }
     });
 
-    p.on('title', title => {
-        sendMessage('event', 'titleChanged', { title: title });
+    p.on('framenavigated', f => {
+        if (f === p.mainFrame()) {
+            currentFrame = null;
+            sendEvent('urlChanged', { url: f.url() });
+        }
     });
 
-    p.on('framenavigated', async frame => {
-        sendMessage('event', 'frameNavigated', {
-            url: frame.url(),
-            name: frame.name(),
-            isMainFrame: frame.isMainFrame(),
-        });
+    p.on('close', () => {
+        sendEvent('windowCloseRequested');
     });
 
     // Handle dialogs (alert, confirm, prompt, beforeunload)
     p.on('dialog', async dialog => {
-        console.log(`PLAYWRIGHT_BACKEND_JS: Dialog type: ${dialog.type()}, message: ${dialog.message()}`);
         if (dialog.type() === 'alert') {
-            sendMessage('event', 'javaScriptAlertSent', { message: dialog.message() });
+            sendEvent('javaScriptAlertSent', { message: dialog.message() });
             await dialog.accept();
         } else if (dialog.type() === 'confirm') {
-            const confirmResult = await callCPlusPlusSynchronously('javaScriptConfirmRequested', { message: dialog.message() });
-            if (confirmResult.result) {
+            const reply = await requestReply('javaScriptConfirmRequested', { message: dialog.message() });
+            if (reply.result) {
                 await dialog.accept();
             } else {
                 await dialog.dismiss();
             }
         } else if (dialog.type() === 'prompt') {
-            const promptResponse = await callCPlusPlusSynchronously('javaScriptPromptRequested', { message: dialog.message(), defaultValue: dialog.defaultValue() });
-            if (promptResponse.accepted) {
-                await dialog.accept(promptResponse.result);
+            const reply = await requestReply('javaScriptPromptRequested',
+                { message: dialog.message(), defaultValue: dialog.defaultValue() });
+            if (reply.accepted) {
+                await dialog.accept(reply.result);
             } else {
                 await dialog.dismiss();
             }
         } else if (dialog.type() === 'beforeunload') {
-            // PhantomJS's javascriptInterrupt is similar to this.
-            // It asks if the JS execution should be interrupted or continue.
-            const interruptResult = await callCPlusPlusSynchronously('javascriptInterruptRequested');
-            if (interruptResult.result) {
-                // If C++ decides to interrupt, you might block navigation or close page.
-                // For beforeunload, Playwright's default is to wait for accept/dismiss.
-                await dialog.dismiss(); // Simulate interruption by dismissing navigation
+            // PhantomJS's javascriptInterrupt is the closest equivalent.
+            const reply = await requestReply('javascriptInterruptRequested');
+            if (reply.interrupt) {
+                await dialog.dismiss();
             } else {
-                await dialog.accept(); // Continue navigation
+                await dialog.accept();
             }
         } else {
             console.warn(`PLAYWRIGHT_BACKEND_JS: Unhandled dialog type: ${dialog.type()}. Dismissing.`);
-            await dialog.dismiss(); // Dismiss unknown dialogs
+            await dialog.dismiss();
         }
     });
 
-    // File choosers
     p.on('filechooser', async fileChooser => {
-        console.log('PLAYWRIGHT_BACKEND_JS: File chooser opened.');
-        const filePickerResponse = await callCPlusPlusSynchronously('filePickerRequested', { oldFile: '' }); // oldFile is typically the value attribute
-        if (filePickerResponse.handled && filePickerResponse.chosenFile) {
-            await fileChooser.setFiles(filePickerResponse.chosenFile);
+        const reply = await requestReply('filePickerRequested', { oldFile: '' });
+        if (reply.handled && reply.chosenFile) {
+            await fileChooser.setFiles(reply.chosenFile);
         } else {
-            await fileChooser.setFiles([]); // No files selected
+            await fileChooser.setFiles([]);
         }
     });
 
     // Handle new pages (e.g., window.open)
     browserContext.on('page', newPage => {
-        console.log('PLAYWRIGHT_BACKEND_JS: New page created by browser context.');
-        // This is complex: need to send a unique identifier for this new page back to C++.
-        // C++ will then create a new WebPage instance with a new PlaywrightEngineBackend,
-        // and that backend will need to control *this specific Playwright page object*.
-        // For now, let's just log and dismiss the new page.
-        // A robust solution needs a mechanism to map C++ IEngineBackend instances to Playwright page objects.
-        newPage.close(); // For now, close new pages created by window.open
-        console.warn("PLAYWRIGHT_BACKEND_JS: New page created by browser context. Auto-closing for now. Full implementation pending.");
+        // Mapping a new Playwright page onto a new C++ backend is not implemented; close it for now.
+        console.warn('PLAYWRIGHT_BACKEND_JS: New page created by browser context. Auto-closing for now.');
+        newPage.close();
     });
 }
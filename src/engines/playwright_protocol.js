@@ -0,0 +1,293 @@
+// Generated by tools/generate-protocol.py from src/engines/playwright_protocol.json. Do not edit.
+
+'use strict';
+
+const PROTOCOL_VERSION = 1;
+
+const Command = Object.freeze({
+    init: 0,
+    shutdown: 1,
+    getUrl: 2,
+    getTitle: 3,
+    getHtml: 4,
+    getPlainText: 5,
+    getWindowName: 6,
+    load: 7,
+    setHtml: 8,
+    reload: 9,
+    stop: 10,
+    canGoBack: 11,
+    goBack: 12,
+    canGoForward: 13,
+    goForward: 14,
+    goToHistoryItem: 15,
+    setViewportSize: 16,
+    getViewportSize: 17,
+    setClipRect: 18,
+    getClipRect: 19,
+    setScrollPosition: 20,
+    getScrollPosition: 21,
+    renderImage: 22,
+    renderPdf: 23,
+    getZoomFactor: 24,
+    setZoomFactor: 25,
+    evaluateJavaScript: 26,
+    injectJavaScriptFile: 27,
+    exposeQObject: 28,
+    appendScriptElement: 29,
+    getUserAgent: 30,
+    setUserAgent: 31,
+    setNavigationLocked: 32,
+    getNavigationLocked: 33,
+    getCustomHeaders: 34,
+    setCustomHeaders: 35,
+    setJavaScriptEnabled: 36,
+    setWebSecurityEnabled: 37,
+    setWebGLEnabled: 38,
+    setJavaScriptCanOpenWindows: 39,
+    setJavaScriptCanCloseWindows: 40,
+    setLocalToRemoteUrlAccessEnabled: 41,
+    setAutoLoadImages: 42,
+    setNetworkProxy: 43,
+    setDiskCacheEnabled: 44,
+    setMaxDiskCacheSize: 45,
+    setDiskCachePath: 46,
+    setIgnoreSslErrors: 47,
+    setSslProtocol: 48,
+    setSslCiphers: 49,
+    setSslCertificatesPath: 50,
+    setSslClientCertificateFile: 51,
+    setSslClientKeyFile: 52,
+    setSslClientKeyPassphrase: 53,
+    setResourceTimeout: 54,
+    setMaxAuthAttempts: 55,
+    setLocalStoragePath: 56,
+    getLocalStorageQuota: 57,
+    setOfflineStoragePath: 58,
+    getOfflineStorageQuota: 59,
+    clearMemoryCache: 60,
+    setCookies: 61,
+    getCookies: 62,
+    addCookie: 63,
+    deleteCookie: 64,
+    clearCookies: 65,
+    getFramesCount: 66,
+    getFramesName: 67,
+    switchToFrameByName: 68,
+    switchToFrameByPosition: 69,
+    getFrameName: 70,
+    switchToMainFrame: 71,
+    switchToParentFrame: 72,
+    switchToFocusedFrame: 73,
+    getFocusedFrameName: 74,
+    sendEvent: 75,
+    uploadFile: 76,
+    showInspector: 77,
+    ping: 78,
+    setRepaintTracking: 79,
+    takeRepaints: 80,
+    renderViewports: 81,
+    getElementRects: 82,
+    renderPdfStream: 83,
+    renderPdfParts: 84,
+    applyTemplateData: 85,
+    renderTemplateBatch: 86,
+    captureViewportFast: 87,
+    startScreencast: 88,
+    stopScreencast: 89,
+    setRequestFilter: 90,
+    setRequestInterception: 91,
+    resolveRequests: 92,
+    setResponseCacheEnabled: 93,
+    startNetworkRecording: 94,
+    stopNetworkRecording: 95,
+    setNetworkReplay: 96,
+    startHar: 97,
+    stopHar: 98,
+});
+
+const CommandInfo = Object.freeze([
+    { name: 'init', sync: false },
+    { name: 'shutdown', sync: false },
+    { name: 'getUrl', sync: true },
+    { name: 'getTitle', sync: true },
+    { name: 'getHtml', sync: true },
+    { name: 'getPlainText', sync: true },
+    { name: 'getWindowName', sync: true },
+    { name: 'load', sync: false },
+    { name: 'setHtml', sync: false },
+    { name: 'reload', sync: false },
+    { name: 'stop', sync: false },
+    { name: 'canGoBack', sync: true },
+    { name: 'goBack', sync: true },
+    { name: 'canGoForward', sync: true },
+    { name: 'goForward', sync: true },
+    { name: 'goToHistoryItem', sync: true },
+    { name: 'setViewportSize', sync: false },
+    { name: 'getViewportSize', sync: true },
+    { name: 'setClipRect', sync: false },
+    { name: 'getClipRect', sync: true },
+    { name: 'setScrollPosition', sync: false },
+    { name: 'getScrollPosition', sync: true },
+    { name: 'renderImage', sync: true },
+    { name: 'renderPdf', sync: true },
+    { name: 'getZoomFactor', sync: true },
+    { name: 'setZoomFactor', sync: false },
+    { name: 'evaluateJavaScript', sync: true },
+    { name: 'injectJavaScriptFile', sync: true },
+    { name: 'exposeQObject', sync: false },
+    { name: 'appendScriptElement', sync: false },
+    { name: 'getUserAgent', sync: true },
+    { name: 'setUserAgent', sync: false },
+    { name: 'setNavigationLocked', sync: false },
+    { name: 'getNavigationLocked', sync: true },
+    { name: 'getCustomHeaders', sync: true },
+    { name: 'setCustomHeaders', sync: false },
+    { name: 'setJavaScriptEnabled', sync: false },
+    { name: 'setWebSecurityEnabled', sync: false },
+    { name: 'setWebGLEnabled', sync: false },
+    { name: 'setJavaScriptCanOpenWindows', sync: false },
+    { name: 'setJavaScriptCanCloseWindows', sync: false },
+    { name: 'setLocalToRemoteUrlAccessEnabled', sync: false },
+    { name: 'setAutoLoadImages', sync: false },
+    { name: 'setNetworkProxy', sync: false },
+    { name: 'setDiskCacheEnabled', sync: false },
+    { name: 'setMaxDiskCacheSize', sync: false },
+    { name: 'setDiskCachePath', sync: false },
+    { name: 'setIgnoreSslErrors', sync: false },
+    { name: 'setSslProtocol', sync: false },
+    { name: 'setSslCiphers', sync: false },
+    { name: 'setSslCertificatesPath', sync: false },
+    { name: 'setSslClientCertificateFile', sync: false },
+    { name: 'setSslClientKeyFile', sync: false },
+    { name: 'setSslClientKeyPassphrase', sync: false },
+    { name: 'setResourceTimeout', sync: false },
+    { name: 'setMaxAuthAttempts', sync: false },
+    { name: 'setLocalStoragePath', sync: false },
+    { name: 'getLocalStorageQuota', sync: true },
+    { name: 'setOfflineStoragePath', sync: false },
+    { name: 'getOfflineStorageQuota', sync: true },
+    { name: 'clearMemoryCache', sync: false },
+    { name: 'setCookies', sync: true },
+    { name: 'getCookies', sync: true },
+    { name: 'addCookie', sync: true },
+    { name: 'deleteCookie', sync: true },
+    { name: 'clearCookies', sync: false },
+    { name: 'getFramesCount', sync: true },
+    { name: 'getFramesName', sync: true },
+    { name: 'switchToFrameByName', sync: true },
+    { name: 'switchToFrameByPosition', sync: true },
+    { name: 'getFrameName', sync: true },
+    { name: 'switchToMainFrame', sync: false },
+    { name: 'switchToParentFrame', sync: true },
+    { name: 'switchToFocusedFrame', sync: true },
+    { name: 'getFocusedFrameName', sync: true },
+    { name: 'sendEvent', sync: false },
+    { name: 'uploadFile', sync: false },
+    { name: 'showInspector', sync: true },
+    { name: 'ping', sync: false },
+    { name: 'setRepaintTracking', sync: false },
+    { name: 'takeRepaints', sync: true },
+    { name: 'renderViewports', sync: true },
+    { name: 'getElementRects', sync: true },
+    { name: 'renderPdfStream', sync: true },
+    { name: 'renderPdfParts', sync: true },
+    { name: 'applyTemplateData', sync: true },
+    { name: 'renderTemplateBatch', sync: true },
+    { name: 'captureViewportFast', sync: true },
+    { name: 'startScreencast', sync: true },
+    { name: 'stopScreencast', sync: true },
+    { name: 'setRequestFilter', sync: false },
+    { name: 'setRequestInterception', sync: false },
+    { name: 'resolveRequests', sync: false },
+    { name: 'setResponseCacheEnabled', sync: false },
+    { name: 'startNetworkRecording', sync: true },
+    { name: 'stopNetworkRecording', sync: true },
+    { name: 'setNetworkReplay', sync: true },
+    { name: 'startHar', sync: true },
+    { name: 'stopHar', sync: true },
+]);
+
+const Event = Object.freeze({
+    initialized: 0,
+    loadStarted: 1,
+    loadFinished: 2,
+    loadingProgress: 3,
+    urlChanged: 4,
+    titleChanged: 5,
+    contentsChanged: 6,
+    navigationRequested: 7,
+    pageCreated: 8,
+    windowCloseRequested: 9,
+    javaScriptAlertSent: 10,
+    javaScriptConsoleMessageSent: 11,
+    javaScriptErrorSent: 12,
+    resourceRequested: 13,
+    resourceReceived: 14,
+    resourceError: 15,
+    resourceTimeout: 16,
+    repaintRequested: 17,
+    javaScriptConfirmRequested: 18,
+    javaScriptPromptRequested: 19,
+    javascriptInterruptRequested: 20,
+    filePickerRequested: 21,
+    callExposedQObjectMethod: 22,
+    pong: 23,
+    pdfChunk: 24,
+    pdfPrinting: 25,
+    pdfPartRendered: 26,
+    templatePreparing: 27,
+    templateRendered: 28,
+    screencastFrame: 29,
+    responseCacheLookup: 30,
+    responseCacheStore: 31,
+});
+
+const EventInfo = Object.freeze([
+    { name: 'initialized', reply: false },
+    { name: 'loadStarted', reply: false },
+    { name: 'loadFinished', reply: false },
+    { name: 'loadingProgress', reply: false },
+    { name: 'urlChanged', reply: false },
+    { name: 'titleChanged', reply: false },
+    { name: 'contentsChanged', reply: false },
+    { name: 'navigationRequested', reply: false },
+    { name: 'pageCreated', reply: false },
+    { name: 'windowCloseRequested', reply: false },
+    { name: 'javaScriptAlertSent', reply: false },
+    { name: 'javaScriptConsoleMessageSent', reply: false },
+    { name: 'javaScriptErrorSent', reply: false },
+    { name: 'resourceRequested', reply: false },
+    { name: 'resourceReceived', reply: false },
+    { name: 'resourceError', reply: false },
+    { name: 'resourceTimeout', reply: false },
+    { name: 'repaintRequested', reply: false },
+    { name: 'javaScriptConfirmRequested', reply: true },
+    { name: 'javaScriptPromptRequested', reply: true },
+    { name: 'javascriptInterruptRequested', reply: true },
+    { name: 'filePickerRequested', reply: true },
+    { name: 'callExposedQObjectMethod', reply: true },
+    { name: 'pong', reply: false },
+    { name: 'pdfChunk', reply: false },
+    { name: 'pdfPrinting', reply: false },
+    { name: 'pdfPartRendered', reply: false },
+    { name: 'templatePreparing', reply: false },
+    { name: 'templateRendered', reply: false },
+    { name: 'screencastFrame', reply: false },
+    { name: 'responseCacheLookup', reply: true },
+    { name: 'responseCacheStore', reply: false },
+]);
+
+// Turns a { commandName: handler } object into an array indexed by command id.
+// Throws if the schema declares a command the handlers object does not implement.
+function buildDispatchTable(handlers) {
+    return CommandInfo.map(info => {
+        const handler = handlers[info.name];
+        if (typeof handler !== 'function') {
+            throw new Error(`No handler for protocol command '${info.name}'`);
+        }
+        return handler;
+    });
+}
+
+module.exports = { PROTOCOL_VERSION, Command, CommandInfo, Event, EventInfo, buildDispatchTable };
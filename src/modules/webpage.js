@@ -223,6 +223,26 @@ function detectType(value) {
     return s;
 }
 
+// The settings page.open() passes on. A "waitUntil" in the settings object given to this open() takes precedence
+// over page.settings.waitUntil; a predicate function (or the function itself given as waitUntil) is sent as the
+// source of a call to it, to be evaluated in the page.
+function openSettings(settings, op) {
+    var result = copyInto({}, settings),
+        waitUntil = isObject(op) && op && !isUndefined(op.waitUntil) ? op.waitUntil : settings.waitUntil;
+
+    if (typeof waitUntil === 'function') {
+        waitUntil = { predicate: waitUntil };
+    }
+    if (isObject(waitUntil) && waitUntil && typeof waitUntil.predicate === 'function') {
+        waitUntil = copyInto({}, waitUntil);
+        waitUntil.predicate = '(' + waitUntil.predicate.toString() + ')()';
+    }
+    if (!isUndefinedOrNull(waitUntil)) {
+        result.waitUntil = waitUntil;
+    }
+    return result;
+}
+
 function decorateNewPage(opts, page) {
     var handlers = {};
 
@@ -253,6 +273,8 @@ function decorateNewPage(opts, page) {
 
     definePageSignalHandler(page, handlers, "onRepaintRequested", "repaintRequested");
 
+    definePageSignalHandler(page, handlers, "onRenderProgress", "renderProgress");
+
     definePageSignalHandler(page, handlers, "onResourceRequested", "resourceRequested");
 
     definePageSignalHandler(page, handlers, "onResourceReceived", "resourceReceived");
@@ -267,6 +289,10 @@ function decorateNewPage(opts, page) {
 
     definePageSignalHandler(page, handlers, "onClosing", "closing");
 
+    definePageSignalHandler(page, handlers, "onBackendHealthChanged", "backendHealthChanged");
+
+    definePageSignalHandler(page, handlers, "onBackendRestarted", "backendRestarted");
+
     // Private callback for "page.open()"
     definePageSignalHandler(page, handlers, "_onPageOpenFinished", "loadFinished");
 
@@ -278,30 +304,30 @@ function decorateNewPage(opts, page) {
         var thisPage = this;
 
         if (arguments.length === 1) {
-            this.openUrl(url, 'get', this.settings);
+            this.openUrl(url, 'get', openSettings(this.settings));
             return;
         } else if (arguments.length === 2 && typeof arg1 === 'function') {
             this._onPageOpenFinished = function() {
                 thisPage._onPageOpenFinished = null; //< Disconnect callback (should fire only once)
                 arg1.apply(thisPage, arguments);     //< Invoke the actual callback
             }
-            this.openUrl(url, 'get', this.settings);
+            this.openUrl(url, 'get', openSettings(this.settings));
             return;
         } else if (arguments.length === 2) {
-            this.openUrl(url, arg1, this.settings);
+            this.openUrl(url, arg1, openSettings(this.settings, arg1));
             return;
         } else if (arguments.length === 3 && typeof arg2 === 'function') {
             this._onPageOpenFinished = function() {
                 thisPage._onPageOpenFinished = null; //< Disconnect callback (should fire only once)
                 arg2.apply(thisPage, arguments);     //< Invoke the actual callback
             }
-            this.openUrl(url, arg1, this.settings);
+            this.openUrl(url, arg1, openSettings(this.settings, arg1));
             return;
         } else if (arguments.length === 3) {
             this.openUrl(url, {
                 operation: arg1,
                 data: arg2
-            }, this.settings);
+            }, openSettings(this.settings));
             return;
         } else if (arguments.length === 4) {
             this._onPageOpenFinished = function() {
@@ -311,7 +337,7 @@ function decorateNewPage(opts, page) {
             this.openUrl(url, {
                 operation: arg1,
                 data: arg2
-            }, this.settings);
+            }, openSettings(this.settings));
             return;
         } else if (arguments.length === 5) {
             this._onPageOpenFinished = function() {
@@ -322,7 +348,7 @@ function decorateNewPage(opts, page) {
                 operation: arg1,
                 data: arg2,
                 headers : arg3
-            }, this.settings);
+            }, openSettings(this.settings));
             return;
         }
         throw "Wrong use of WebPage#open";
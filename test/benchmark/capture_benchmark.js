@@ -0,0 +1,58 @@
+// Viewport capture latency: the regular render() path against the CDP fast path ({ fast: true }).
+//
+// Usage: phantomjs test/benchmark/capture_benchmark.js [url] [iterations]
+//
+// Unlike the C++ microbenchmarks this needs the browser backend, so it is a script rather than a CMake target.
+// Each mode captures the same loaded page `iterations` times (default 200) after a few warm-up captures and
+// reports the p50 and p99 latency of a single render() call.
+"use strict";
+var fs = require("fs");
+var system = require("system");
+var page = require("webpage").create();
+
+var address = system.args[1] || "data:text/html,<body style='background:linear-gradient(red,blue)'>" +
+    "<h1>capture benchmark</h1></body>";
+var iterations = parseInt(system.args[2], 10) || 200;
+var file = fs.workingDirectory + "/capture_benchmark.tmp";
+
+var modes = [
+    { name: "render png", options: { onlyViewport: true, format: "png" } },
+    { name: "fast png", options: { onlyViewport: true, format: "png", fast: true } },
+    { name: "render jpeg", options: { onlyViewport: true, format: "jpeg", quality: 80 } },
+    { name: "fast jpeg", options: { onlyViewport: true, format: "jpeg", quality: 80, fast: true } }
+];
+
+function percentile(sorted, p) {
+    return sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))];
+}
+
+function measure(options) {
+    var samples = [];
+    for (var i = 0; i < iterations + 5; ++i) {
+        var start = Date.now();
+        page.render(file, options);
+        if (i >= 5) {
+            samples.push(Date.now() - start);
+        }
+    }
+    return samples.sort(function (a, b) { return a - b; });
+}
+
+page.viewportSize = { width: 1280, height: 800 };
+page.open(address, function (status) {
+    if (status !== "success") {
+        console.log("Could not load " + address);
+        phantom.exit(1);
+    }
+    console.log("mode          p50 ms   p99 ms   (" + iterations + " captures of " + address.substr(0, 60) + ")");
+    modes.forEach(function (mode) {
+        var samples = measure(mode.options);
+        console.log((mode.name + "             ").substr(0, 12) +
+            ("        " + percentile(samples, 0.5)).slice(-8) + " " +
+            ("        " + percentile(samples, 0.99)).slice(-8));
+    });
+    if (fs.exists(file)) {
+        fs.remove(file);
+    }
+    phantom.exit(0);
+});
@@ -0,0 +1,98 @@
+// Page load time with request interception off, with a no-op onResourceRequested and with one that rewrites a
+// header on every request.
+//
+// Usage: phantomjs test/benchmark/intercept_benchmark.js [runs] [port]
+//
+// Serves a page with 200 image subresources from a local web server and loads it `runs` times (default 10) per
+// mode, each time in a fresh page and with a new query string so nothing comes from the memory cache. Reports the
+// median and worst load time of a mode. Without a handler the backend doesn't intercept at all, so the first
+// mode is the baseline the other two are compared against.
+"use strict";
+var system = require("system");
+var webpage = require("webpage");
+
+var runs = parseInt(system.args[1], 10) || 10;
+var port = parseInt(system.args[2], 10) || 8931;
+var subresources = 200;
+
+var server = require("webserver").create();
+var listening = server.listen(port, function (request, response) {
+    var body;
+    if (request.url.indexOf("/r/") === 0) {
+        body = "<svg xmlns='http://www.w3.org/2000/svg' width='4' height='4'><rect width='4' height='4'/></svg>";
+        response.headers = { "Content-Type": "image/svg+xml", "Cache-Control": "no-store" };
+    } else {
+        var run = request.url.split("?")[1] || "";
+        body = "<!DOCTYPE html><body>";
+        for (var i = 0; i < subresources; ++i) {
+            body += "<img src='/r/" + i + ".svg?" + run + "'>";
+        }
+        body += "</body>";
+        response.headers = { "Content-Type": "text/html", "Cache-Control": "no-store" };
+    }
+    response.statusCode = 200;
+    response.write(body);
+    response.close();
+});
+if (!listening) {
+    console.log("Could not listen on port " + port);
+    phantom.exit(1);
+}
+
+var modes = [
+    { name: "no handler", handler: null },
+    { name: "no-op", handler: function () { } },
+    { name: "setHeader", handler: function (requestData, request) { request.setHeader("X-Bench", "1"); } }
+];
+
+var results = [];
+var counter = 0;
+
+function loadOnce(mode, done) {
+    var page = webpage.create();
+    if (mode.handler) {
+        page.onResourceRequested = mode.handler;
+    }
+    var start = Date.now();
+    page.open("http://localhost:" + port + "/?" + (++counter), function (status) {
+        var elapsed = Date.now() - start;
+        page.close();
+        if (status !== "success") {
+            console.log("Load failed in mode " + mode.name);
+            phantom.exit(1);
+        }
+        done(elapsed);
+    });
+}
+
+function runMode(index) {
+    if (index === modes.length) {
+        console.log("mode          median ms   max ms   (" + runs + " loads of " + subresources + " subresources)");
+        results.forEach(function (result) {
+            var sorted = result.samples.sort(function (a, b) { return a - b; });
+            console.log((result.name + "             ").substr(0, 12) +
+                ("           " + sorted[Math.floor(sorted.length / 2)]).slice(-11) + " " +
+                ("        " + sorted[sorted.length - 1]).slice(-8));
+        });
+        server.close();
+        phantom.exit(0);
+        return;
+    }
+    var mode = modes[index];
+    var samples = [];
+    // One warm-up load per mode, not counted.
+    var next = function (elapsed) {
+        if (elapsed !== undefined) {
+            samples.push(elapsed);
+        }
+        if (samples.length === runs) {
+            results.push({ name: mode.name, samples: samples });
+            runMode(index + 1);
+        } else {
+            loadOnce(mode, next);
+        }
+    };
+    loadOnce(mode, function () { next(); });
+}
+
+runMode(0);
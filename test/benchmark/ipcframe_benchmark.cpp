@@ -0,0 +1,124 @@
+// Compares the old eager decoding of backend messages (QJsonDocument + toVariantMap for every frame) with the lazy
+// IpcFrame path, on resource-event traffic.
+//
+// Usage: ipcframe_benchmark [recording] [iterations]
+//
+// `recording` is a file of length-prefixed frames as written by playwright_backend.js when started with
+// PLAYWRIGHT_BACKEND_RECORD=<file>. Without one, a synthetic page load (resourceRequested/resourceReceived pairs
+// with realistic header sets) is generated.
+
+#include "ipcframe.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QVariantMap>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+QList<QByteArray> readRecording(const QString& path) {
+    QList<QByteArray> frames;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "cannot open %s\n", qPrintable(path));
+        return frames;
+    }
+    const QByteArray data = file.readAll();
+    int pos = 0;
+    while (pos < data.size()) {
+        const int newline = data.indexOf('\n', pos);
+        if (newline < 0) {
+            break;
+        }
+        const int length = data.mid(pos, newline - pos).toInt();
+        frames.append(data.mid(newline + 1, length));
+        pos = newline + 1 + length;
+    }
+    return frames;
+}
+
+QList<QByteArray> syntheticTraffic(int resources) {
+    QList<QByteArray> frames;
+    for (int i = 0; i < resources; ++i) {
+        const QByteArray url = "https://cdn.example.com/assets/" + QByteArray::number(i) + "/bundle."
+            + QByteArray::number(i * 7919 % 100000, 16) + ".js?v=3&lang=en";
+        frames.append("{\"type\":\"event\",\"event\":13,\"data\":{\"url\":\"" + url
+            + "\",\"method\":\"GET\",\"headers\":{\"accept\":\"*/*\",\"accept-language\":\"en-US,en;q=0.9\","
+              "\"referer\":\"https://www.example.com/\",\"sec-ch-ua\":\"\\\"Chromium\\\";v=\\\"120\\\"\","
+              "\"user-agent\":\"Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+              "HeadlessChrome/120.0.0.0 Safari/537.36\"},\"id\":\""
+            + url + "\"}}");
+        frames.append("{\"type\":\"event\",\"event\":14,\"data\":{\"url\":\"" + url
+            + "\",\"status\":200,\"statusText\":\"OK\",\"headers\":{\"accept-ranges\":\"bytes\","
+              "\"cache-control\":\"public, max-age=31536000, immutable\",\"content-encoding\":\"br\","
+              "\"content-length\":\""
+            + QByteArray::number(1024 + i * 37) + "\",\"content-type\":\"application/javascript; charset=utf-8\","
+              "\"date\":\"Tue, 14 May 2024 10:00:00 GMT\",\"etag\":\"\\\"5f3c-"
+            + QByteArray::number(i, 16)
+            + "\\\"\",\"last-modified\":\"Mon, 13 May 2024 08:12:44 GMT\",\"server\":\"nginx\","
+              "\"vary\":\"Accept-Encoding\",\"x-cache\":\"HIT\"},\"id\":\""
+            + url + "\"}}");
+    }
+    return frames;
+}
+
+template <typename F> double nsPerFrame(const QList<QByteArray>& frames, int iterations, F decode) {
+    QElapsedTimer timer;
+    timer.start();
+    for (int it = 0; it < iterations; ++it) {
+        for (const QByteArray& frame : frames) {
+            decode(frame);
+        }
+    }
+    return double(timer.nsecsElapsed()) / (double(iterations) * frames.size());
+}
+
+volatile int g_sink; // Keeps the optimizer from dropping the decoded results
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const QList<QByteArray> frames = argc > 1 ? readRecording(QString::fromLocal8Bit(argv[1])) : syntheticTraffic(500);
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+    if (frames.isEmpty() || iterations <= 0) {
+        std::fprintf(stderr, "usage: %s [recording] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    qint64 bytes = 0;
+    for (const QByteArray& frame : frames) {
+        bytes += frame.size();
+        // The lazy path must decode to exactly what the eager one produces.
+        const QVariantMap eager = QJsonDocument::fromJson(frame).object().value("data").toObject().toVariantMap();
+        if (IpcFrame::scan(frame).data().toVariantMap() != eager) {
+            std::fprintf(stderr, "mismatch decoding: %s\n", frame.left(120).constData());
+            return 1;
+        }
+    }
+
+    const double eager = nsPerFrame(frames, iterations, [](const QByteArray& frame) {
+        const QJsonObject obj = QJsonDocument::fromJson(frame).object();
+        g_sink = obj.value("data").toObject().toVariantMap().size();
+    });
+    const double envelope = nsPerFrame(frames, iterations, [](const QByteArray& frame) {
+        g_sink = IpcFrame::scan(frame).event();
+    });
+    const double lazy = nsPerFrame(frames, iterations, [](const QByteArray& frame) {
+        g_sink = IpcFrame::scan(frame).data().toVariantMap().size();
+    });
+
+    const double avgBytes = double(bytes) / frames.size();
+    std::printf("%d frames, %.0f bytes/frame, %d iterations\n", frames.size(), avgBytes, iterations);
+    std::printf("%-34s %10.0f ns/frame %8.1f MB/s\n", "eager (QJsonDocument+QVariantMap)", eager,
+        avgBytes * 1000.0 / eager);
+    std::printf("%-34s %10.0f ns/frame %8.1f MB/s\n", "lazy, envelope only (no listener)", envelope,
+        avgBytes * 1000.0 / envelope);
+    std::printf("%-34s %10.0f ns/frame %8.1f MB/s\n", "lazy, payload decoded", lazy, avgBytes * 1000.0 / lazy);
+    return 0;
+}
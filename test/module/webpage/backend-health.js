@@ -0,0 +1,41 @@
+test(function () {
+    var page = require('webpage').create();
+
+    assert_equals(page.onBackendHealthChanged, undefined);
+
+    var onBackendHealthChanged = function(healthy) { var x = healthy; };
+    page.onBackendHealthChanged = onBackendHealthChanged;
+    assert_equals(page.onBackendHealthChanged, onBackendHealthChanged);
+
+    page.onBackendHealthChanged = null;
+    assert_equals(page.onBackendHealthChanged, undefined);
+}, "page.onBackendHealthChanged");
+
+test(function () {
+    var page = require('webpage').create();
+
+    assert_equals(page.onBackendRestarted, undefined);
+
+    var onBackendRestarted = function(attempt) { var x = attempt; };
+    page.onBackendRestarted = onBackendRestarted;
+    assert_equals(page.onBackendRestarted, onBackendRestarted);
+
+    page.onBackendRestarted = null;
+    assert_equals(page.onBackendRestarted, undefined);
+}, "page.onBackendRestarted");
+
+async_test(function () {
+    var page = require('webpage').create();
+    var changes = 0;
+
+    page.onBackendHealthChanged = this.step_func(function (healthy) {
+        ++changes;
+    });
+
+    page.open(TEST_HTTP_BASE + 'hello.html',
+              this.step_func_done(function (status) {
+                  assert_equals(status, 'success');
+                  assert_equals(changes, 0);
+              }));
+
+}, "a responsive backend stays healthy across a page load");
@@ -0,0 +1,31 @@
+var fs = require('fs');
+var webpage = require('webpage');
+
+var CACHE_DIR = fs.absolute("disk-cache-test");
+
+function openWithCache(url, callback) {
+    var page = webpage.create();
+    page.settings.diskCacheEnabled = true;
+    page.settings.diskCachePath = CACHE_DIR;
+    page.open(url, function (status) {
+        page.close();
+        callback(status);
+    });
+}
+
+async_test(function () {
+    this.add_cleanup(function () { fs.removeTree(CACHE_DIR); });
+
+    openWithCache(TEST_HTTP_BASE + 'load-images.html', this.step_func(function (status) {
+        assert_equals(status, 'success');
+        assert_is_true(fs.isDirectory(CACHE_DIR + '/index'));
+        var stored = fs.list(CACHE_DIR + '/index').filter(function (name) { return /\.json$/.test(name); });
+        assert_greater_than(stored.length, 1);
+
+        // A second page, with its own backend, is served from the same directory.
+        openWithCache(TEST_HTTP_BASE + 'load-images.html', this.step_func_done(function (status) {
+            assert_equals(status, 'success');
+        }));
+    }));
+
+}, "responses are stored on disk and shared between pages");
@@ -0,0 +1,34 @@
+var fs = require('fs');
+var webpage = require('webpage');
+
+var HAR_FILE = fs.absolute("har-test.har");
+
+async_test(function () {
+    this.add_cleanup(function () {
+        if (fs.exists(HAR_FILE)) {
+            fs.remove(HAR_FILE);
+        }
+    });
+
+    var page = webpage.create();
+    assert_is_true(page.startHar(HAR_FILE));
+    page.open(TEST_HTTP_BASE + 'load-images.html', this.step_func_done(function (status) {
+        assert_equals(status, 'success');
+        var result = page.stopHar();
+        assert_equals(result.file, HAR_FILE);
+        assert_greater_than(result.entries, 2);
+
+        var har = JSON.parse(fs.read(HAR_FILE));
+        assert_equals(har.log.version, '1.2');
+        assert_equals(har.log.entries.length, result.entries);
+        assert_greater_than(har.log.pages.length, 0);
+
+        var entry = har.log.entries.filter(function (e) { return /logo\.png$/.test(e.request.url); })[0];
+        assert_type_of(entry, 'object');
+        assert_equals(entry.response.status, 200);
+        assert_equals(entry.pageref, har.log.pages[har.log.pages.length - 1].id);
+        assert_type_of(entry.timings.wait, 'number');
+        assert_greater_than(entry.response.bodySize, 0);
+    }));
+
+}, "page.startHar streams a HAR of the page's requests");
@@ -0,0 +1,47 @@
+var fs      = require("fs");
+var webpage = require("webpage");
+
+test(function () {
+    assert_type_of(phantom.imageDiff, 'function');
+    assert_type_of(phantom.imageHash, 'function');
+}, "phantom.imageDiff and phantom.imageHash exist");
+
+async_test(function () {
+    var p = webpage.create();
+    p.viewportSize = { width: 200, height: 200 };
+    p.clipRect = { left: 0, top: 0, width: 200, height: 200 };
+
+    p.open(TEST_HTTP_BASE + "render/", this.step_func_done(function (status) {
+        assert_equals(status, "success");
+
+        var files = ["temp_diff_a.png", "temp_diff_b.png", "temp_diff_c.png", "temp_diff_mask.png"];
+        this.add_cleanup(function () {
+            files.forEach(function (f) { if (fs.exists(f)) fs.remove(f); });
+        });
+
+        p.render(files[0]);
+        p.render(files[1]);
+        p.evaluate(function () {
+            var box = document.createElement("div");
+            box.style.cssText = "position:absolute;left:10px;top:10px;width:20px;height:20px;background:#f00";
+            document.body.appendChild(box);
+        });
+        p.render(files[2]);
+
+        var same = phantom.imageDiff(files[0], files[1]);
+        assert_is_true(same.identical);
+        assert_equals(same.diffPixels, 0);
+        assert_equals(same.hashDistance, 0);
+        assert_equals(same.hashA, phantom.imageHash(files[0]));
+
+        var changed = phantom.imageDiff(files[0], files[2], { diffMask: files[3] });
+        assert_is_true(!changed.identical);
+        assert_greater_than(changed.diffPixels, 300);
+        assert_less_than(changed.diffRatio, 0.05);
+        assert_is_true(fs.exists(files[3]));
+
+        var data = "data:image/png;base64," + p.renderBase64("png");
+        assert_is_true(phantom.imageDiff(files[2], data).identical);
+    }));
+
+}, "phantom.imageDiff reports changed pixels and writes a diff mask");
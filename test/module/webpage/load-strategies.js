@@ -0,0 +1,50 @@
+var webpage = require('webpage');
+
+function openAndCount(test, waitUntil, callback) {
+    var page = webpage.create();
+    var finished = 0;
+    page.settings.waitUntil = waitUntil;
+    page.onLoadFinished = function () { ++finished; };
+    page.open(TEST_HTTP_BASE + 'hello.html', test.step_func(function (status) {
+        // Nothing else may report this load.
+        setTimeout(test.step_func_done(function () {
+            page.close();
+            callback(status, finished);
+        }), 500);
+    }));
+}
+
+async_test(function () {
+    openAndCount(this, 'domcontentloaded', function (status, finished) {
+        assert_equals(status, 'success');
+        assert_equals(finished, 1);
+    });
+}, "loadFinished fires once with waitUntil 'domcontentloaded'");
+
+async_test(function () {
+    openAndCount(this, { event: 'networkidle', connections: 0, idleTime: 100 }, function (status, finished) {
+        assert_equals(status, 'success');
+        assert_equals(finished, 1);
+    });
+}, "loadFinished fires once the network is idle");
+
+async_test(function () {
+    openAndCount(this, { selector: 'p' }, function (status, finished) {
+        assert_equals(status, 'success');
+        assert_equals(finished, 1);
+    });
+}, "loadFinished waits for a selector");
+
+async_test(function () {
+    openAndCount(this, function () { return document.title === 'Hello'; }, function (status, finished) {
+        assert_equals(status, 'success');
+        assert_equals(finished, 1);
+    });
+}, "loadFinished waits for a predicate");
+
+async_test(function () {
+    openAndCount(this, { predicate: 'window.neverReady === true', timeout: 200 }, function (status, finished) {
+        assert_equals(status, 'fail');
+        assert_equals(finished, 1);
+    });
+}, "a strategy that is not met in time fails the load");
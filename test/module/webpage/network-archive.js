@@ -0,0 +1,46 @@
+var fs = require('fs');
+var webpage = require('webpage');
+
+var ARCHIVE = fs.absolute("network-archive-test.narc");
+
+async_test(function () {
+    this.add_cleanup(function () {
+        if (fs.exists(ARCHIVE)) {
+            fs.remove(ARCHIVE);
+        }
+    });
+
+    var recorder = webpage.create();
+    assert_is_true(recorder.startNetworkRecording(ARCHIVE));
+    recorder.open(TEST_HTTP_BASE + 'load-images.html', this.step_func(function (status) {
+        assert_equals(status, 'success');
+        var result = recorder.stopNetworkRecording();
+        recorder.close();
+        assert_equals(result.file, ARCHIVE);
+        assert_greater_than(result.responses, 2);
+
+        var player = webpage.create();
+        var served = [];
+        player.onResourceReceived = function (response) {
+            served.push(response.url);
+        };
+        assert_is_true(player.replayNetwork(ARCHIVE, { onMiss: "fail" }));
+        player.open(TEST_HTTP_BASE + 'load-images.html', this.step_func(function (status) {
+            assert_equals(status, 'success');
+            assert_greater_than(served.length, 2);
+
+            // Not in the archive, and the replay doesn't fall through to the network.
+            player.open(TEST_HTTP_BASE + 'logo.html', this.step_func_done(function (status) {
+                assert_equals(status, 'fail');
+                player.close();
+            }));
+        }));
+    }));
+
+}, "a recorded session replays without the network");
+
+test(function () {
+    var page = webpage.create();
+    assert_is_false(page.replayNetwork(fs.absolute("no-such-archive.narc")));
+    page.close();
+}, "replaying a missing archive fails");
@@ -0,0 +1,42 @@
+var fs      = require("fs");
+var webpage = require("webpage");
+
+async_test(function () {
+    var p = webpage.create();
+    p.viewportSize = { width: 400, height: 300 };
+
+    p.open(TEST_HTTP_BASE + "render/", this.step_func_done(function (status) {
+        assert_equals(status, "success");
+
+        p.evaluate(function () {
+            for (var i = 0; i < 3; i++) {
+                var card = document.createElement("div");
+                card.className = "card";
+                card.style.cssText = "position:absolute;top:" + (20 + i * 60) + "px;left:20px;" +
+                    "width:" + (50 + i * 10) + "px;height:40px;background:#0a0";
+                document.body.appendChild(card);
+            }
+        });
+
+        var file = "temp_element.png";
+        this.add_cleanup(function () {
+            ["temp_element.png", "temp_element-0.png", "temp_element-1.png", "temp_element-2.png"]
+                .forEach(function (f) { if (fs.exists(f)) fs.remove(f); });
+        });
+
+        var results = p.renderElements([{ selector: ".card", file: file }, "#missing"], { all: true });
+        assert_equals(results.length, 4);
+        for (var i = 0; i < 3; i++) {
+            assert_equals(results[i].index, i);
+            assert_equals(results[i].rect.width, 50 + i * 10);
+            assert_is_true(fs.exists(results[i].file));
+        }
+        assert_equals(results[3].selector, "#missing");
+        assert_type_of(results[3].error, "string");
+
+        var inline = p.renderElements([".card"]);
+        assert_equals(inline.length, 1);
+        assert_equals(inline[0].data.length > 0, true);
+    }));
+
+}, "renderElements() crops every matched element out of one capture");
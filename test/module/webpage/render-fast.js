@@ -0,0 +1,26 @@
+var fs      = require("fs");
+var webpage = require("webpage");
+
+async_test(function () {
+    var p = webpage.create();
+    p.viewportSize = { width: 320, height: 240 };
+
+    p.open(TEST_HTTP_BASE + "render/", this.step_func_done(function (status) {
+        assert_equals(status, "success");
+
+        var png = "temp_fast.png", jpeg = "temp_fast.jpg";
+        this.add_cleanup(function () {
+            [png, jpeg].forEach(function (file) { if (fs.exists(file)) fs.remove(file); });
+        });
+
+        assert_is_true(p.render(png, { onlyViewport: true, fast: true }));
+        assert_equals(fs.read(png, "b").substr(1, 3), "PNG");
+        assert_is_true(p.render(jpeg, { onlyViewport: true, fast: true, quality: 50 }));
+        assert_equals(fs.read(jpeg, "b").charCodeAt(0), 0xFF);
+
+        var regular = phantom.imageDiff("data:image/png;base64," + p.renderBase64("png"), png);
+        assert_equals(regular.width, 320);
+        assert_equals(regular.height, 240);
+    }));
+
+}, "fast viewport capture writes the browser's PNG and JPEG output");
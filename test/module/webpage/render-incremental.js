@@ -0,0 +1,32 @@
+var fs      = require("fs");
+var webpage = require("webpage");
+
+async_test(function () {
+    var p = webpage.create();
+    p.viewportSize = { width: 400, height: 300 };
+
+    p.open(TEST_HTTP_BASE + "render/", this.step_func_done(function (status) {
+        assert_equals(status, "success");
+
+        var files = ["temp_incremental_1.png", "temp_incremental_2.png", "temp_incremental_full.png"];
+        this.add_cleanup(function () {
+            files.forEach(function (f) { if (fs.exists(f)) fs.remove(f); });
+        });
+
+        assert_is_true(p.render(files[0], { incremental: true }));
+
+        p.evaluate(function () {
+            var box = document.createElement("div");
+            box.style.cssText = "position:absolute;left:300px;top:200px;width:40px;height:40px;background:#00f";
+            document.body.appendChild(box);
+        });
+
+        // No delay: render() itself has to pick up the paint of the new box.
+        assert_is_true(p.render(files[1], { incremental: true }));
+        p.render(files[2], { clipRect: { left: 0, top: 0, width: 400, height: 300 } });
+
+        assert_is_true(!phantom.imageDiff(files[0], files[1]).identical);
+        assert_is_true(phantom.imageDiff(files[1], files[2]).identical);
+    }));
+
+}, "incremental render() picks up repainted regions");
@@ -0,0 +1,34 @@
+var fs      = require("fs");
+var webpage = require("webpage");
+
+function magic(file, length) {
+    return fs.read(file, "b").substr(0, length);
+}
+
+async_test(function () {
+    var p = webpage.create();
+    p.viewportSize = { width: 300, height: 300 };
+
+    p.open(TEST_HTTP_BASE + "render/", this.step_func_done(function (status) {
+        assert_equals(status, "success");
+
+        var files = ["temp_outputs.png", "temp_outputs.jpg", "temp_outputs_small.png"];
+        this.add_cleanup(function () {
+            files.forEach(function (f) { if (fs.exists(f)) fs.remove(f); });
+        });
+
+        assert_is_true(p.render(files[0], {
+            compressionLevel: 1,
+            outputs: [
+                { file: files[1], quality: 60 },
+                { file: files[2], size: { width: 100 } }
+            ]
+        }));
+
+        assert_equals(magic(files[0], 4), "\x89PNG");
+        assert_equals(magic(files[1], 2), "\xFF\xD8");
+        assert_equals(magic(files[2], 4), "\x89PNG");
+        assert_less_than(fs.size(files[2]), fs.size(files[0]));
+    }));
+
+}, "render() encodes one capture into several formats and sizes");
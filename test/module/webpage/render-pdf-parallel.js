@@ -0,0 +1,44 @@
+var fs      = require("fs");
+var webpage = require("webpage");
+
+async_test(function () {
+    var p = webpage.create();
+    p.paperSize = { format: "A4", orientation: "portrait", margin: "1cm" };
+    var progress = [];
+    p.onRenderProgress = function (info) { progress.push(info); };
+
+    p.open(TEST_HTTP_BASE + "render/", this.step_func_done(function (status) {
+        assert_equals(status, "success");
+        p.evaluate(function () {
+            for (var i = 0; i < 12; ++i) {
+                var section = document.createElement("div");
+                section.style.height = "1200px";
+                section.textContent = "Section " + i;
+                document.body.appendChild(section);
+            }
+        });
+
+        var file = "temp_parallel.pdf";
+        var reference = "temp_parallel_reference.pdf";
+        this.add_cleanup(function () {
+            [file, reference].forEach(function (f) { if (fs.exists(f)) fs.remove(f); });
+        });
+
+        assert_is_true(p.renderPdfParallel(file, { workers: 2, pagesPerPart: 3 }));
+        var data = fs.read(file, "b");
+        assert_equals(data.substr(0, 4), "%PDF");
+
+        var last = progress[progress.length - 1];
+        assert_is_true(last.done);
+        assert_equals(last.bytesWritten, fs.size(file));
+
+        // The clones must print the same document: no page lost at a range boundary, and no content added by
+        // the page's scripts running again in them.
+        assert_is_true(p.render(reference));
+        var pageCount = /\/Type\s*\/Page(?![a-zA-Z])/g;
+        var expected = fs.read(reference, "b").match(pageCount).length;
+        assert_greater_than(expected, 3);
+        assert_equals(data.match(pageCount).length, expected);
+    }));
+
+}, "long PDFs render as parallel page ranges merged into one file");
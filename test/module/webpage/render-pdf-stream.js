@@ -0,0 +1,47 @@
+var fs      = require("fs");
+var webpage = require("webpage");
+
+async_test(function () {
+    var p = webpage.create();
+    var progress = [];
+    p.onRenderProgress = function (info) { progress.push(info); };
+
+    p.open(TEST_HTTP_BASE + "render/", this.step_func_done(function (status) {
+        assert_equals(status, "success");
+
+        var file = "temp_stream.pdf";
+        this.add_cleanup(function () { if (fs.exists(file)) fs.remove(file); });
+
+        assert_is_true(p.render(file));
+        assert_equals(fs.read(file, "b").substr(0, 4), "%PDF");
+
+        assert_greater_than(progress.length, 0);
+        var last = progress[progress.length - 1];
+        assert_is_true(last.done);
+        assert_equals(last.file, file);
+        assert_equals(last.bytesWritten, fs.size(file));
+    }));
+
+}, "PDF output is streamed to the file with progress reports");
+
+test(function () {
+    var p = webpage.create();
+    // Exactly one Letter page tall: it only fits on one page when the margins are 0, as page.pdf() makes them.
+    p.setContent('<html><body style="margin:0"><div style="height:1050px;background:#0a0"></div></body></html>',
+        TEST_HTTP_BASE + "render/");
+
+    var file = "temp_stream_default.pdf";
+    this.add_cleanup(function () { if (fs.exists(file)) fs.remove(file); });
+
+    var pageCount = /\/Type\s*\/Page(?![a-zA-Z])/g;
+    var mediaBox = /\/MediaBox\s*\[([^\]]*)\]/;
+
+    assert_is_true(p.render(file));
+    var streamed = fs.read(file, "b");
+    var buffered = p.evaluate(function (data) { return atob(data); }, p.renderBase64("pdf"));
+
+    assert_equals(streamed.match(pageCount).length, 1);
+    assert_equals(streamed.match(pageCount).length, buffered.match(pageCount).length);
+    assert_equals(streamed.match(mediaBox)[1], buffered.match(mediaBox)[1]);
+
+}, "streamed PDFs use the same default page size and margins as buffered ones");
@@ -0,0 +1,45 @@
+var fs      = require("fs");
+var webpage = require("webpage");
+
+var TEMPLATE = '<html><body><h1 id="name"></h1><script>' +
+    'window.applyTemplateData = function (data) {' +
+    '    document.getElementById("name").textContent = data.name;' +
+    '    return new Promise(function (resolve) { setTimeout(resolve, 10); });' +
+    '};</script></body></html>';
+
+test(function () {
+    var page = webpage.create();
+    page.setContent(TEMPLATE, "http://example.com/invoice");
+    var file = "temp_template.png";
+    this.add_cleanup(function () { if (fs.exists(file)) fs.remove(file); });
+
+    assert_is_true(page.renderTemplate({ name: "ACME" }, file));
+    assert_is_true(fs.exists(file));
+    assert_equals(page.evaluate(function () {
+        return document.getElementById("name").textContent;
+    }), "ACME");
+
+}, "renderTemplate fills the loaded template and captures it");
+
+test(function () {
+    var page = webpage.create();
+    page.setContent(TEMPLATE, "http://example.com/invoice");
+    var files = ["temp_template_0.pdf", "temp_template_1.pdf", "temp_template_2.png"];
+    this.add_cleanup(function () {
+        files.forEach(function (file) { if (fs.exists(file)) fs.remove(file); });
+    });
+
+    var results = page.renderTemplateBatch(files.map(function (file, i) {
+        return { data: { name: "Customer " + i }, file: file };
+    }).concat([{ data: {}, file: "temp_template.gif" }]), { workers: 2 });
+
+    assert_equals(results.length, 4);
+    for (var i = 0; i < files.length; ++i) {
+        assert_equals(results[i].file, files[i]);
+        assert_type_of(results[i].error, "undefined");
+        assert_is_true(fs.exists(files[i]));
+    }
+    assert_equals(fs.read(files[0], "b").substr(0, 4), "%PDF");
+    assert_type_of(results[3].error, "string");
+
+}, "renderTemplateBatch renders one file per job over pooled pages");
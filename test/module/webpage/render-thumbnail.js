@@ -0,0 +1,45 @@
+var fs      = require("fs");
+var webpage = require("webpage");
+
+// Width and height from the PNG IHDR chunk.
+function pngSize(file) {
+    var data = fs.read(file, "b");
+    function be32(offset) {
+        return ((data.charCodeAt(offset) << 24) | (data.charCodeAt(offset + 1) << 16) |
+                (data.charCodeAt(offset + 2) << 8) | data.charCodeAt(offset + 3)) >>> 0;
+    }
+    return { width: be32(16), height: be32(20) };
+}
+
+async_test(function () {
+    var p = webpage.create();
+    p.viewportSize = { width: 400, height: 300 };
+    p.clipRect = { left: 0, top: 0, width: 400, height: 300 };
+
+    p.open(TEST_HTTP_BASE + "render/", this.step_func_done(function (status) {
+        assert_equals(status, "success");
+
+        var files = ["temp_thumb.png", "temp_thumb-100w.png", "temp_thumb_lanczos.png"];
+        this.add_cleanup(function () {
+            files.forEach(function (f) { if (fs.exists(f)) fs.remove(f); });
+        });
+
+        assert_is_true(p.render(files[0], {
+            scale: 0.5,
+            thumbnail: [100, { file: files[2], width: 40, height: 40, filter: "lanczos" }]
+        }));
+
+        var main = pngSize(files[0]);
+        assert_equals(main.width, 200);
+        assert_equals(main.height, 150);
+
+        var thumb = pngSize(files[1]);
+        assert_equals(thumb.width, 100);
+        assert_equals(thumb.height, 75);
+
+        var square = pngSize(files[2]);
+        assert_equals(square.width, 40);
+        assert_equals(square.height, 40);
+    }));
+
+}, "render() scales the capture and derives thumbnails from it");
@@ -0,0 +1,31 @@
+var fs      = require("fs");
+var webpage = require("webpage");
+
+async_test(function () {
+    var p = webpage.create();
+    p.viewportSize = { width: 320, height: 240 };
+
+    p.open(TEST_HTTP_BASE + "render/", this.step_func_done(function (status) {
+        assert_equals(status, "success");
+
+        p.evaluate(function () {
+            var tall = document.createElement("div");
+            tall.style.cssText = "height:5000px;background:linear-gradient(#fff,#00f)";
+            document.body.appendChild(tall);
+        });
+
+        var files = ["temp_tiled.png", "temp_whole.png"];
+        this.add_cleanup(function () {
+            files.forEach(function (f) { if (fs.exists(f)) fs.remove(f); });
+        });
+
+        assert_is_true(p.render(files[0], { tiled: true, bandHeight: 700 }));
+        assert_is_true(p.render(files[1]));
+
+        var diff = phantom.imageDiff(files[0], files[1]);
+        assert_equals(diff.error, undefined);
+        assert_greater_than(diff.height, 5000);
+        assert_less_than(diff.diffRatio, 0.001);
+    }));
+
+}, "tiled render() streams bands into the same image as a single capture");
@@ -0,0 +1,37 @@
+var fs      = require("fs");
+var webpage = require("webpage");
+
+function pngWidth(file) {
+    var data = fs.read(file, "b");
+    return ((data.charCodeAt(16) << 24) | (data.charCodeAt(17) << 16) |
+            (data.charCodeAt(18) << 8) | data.charCodeAt(19)) >>> 0;
+}
+
+async_test(function () {
+    var p = webpage.create();
+    p.viewportSize = { width: 500, height: 400 };
+    var loads = 0;
+    p.onLoadFinished = function () { loads++; };
+
+    p.open(TEST_HTTP_BASE + "render/", this.step_func_done(function (status) {
+        assert_equals(status, "success");
+
+        var files = ["temp_viewport_320.png", "temp_viewport_768.jpg", "temp_viewport_1024.png"];
+        this.add_cleanup(function () {
+            files.forEach(function (f) { if (fs.exists(f)) fs.remove(f); });
+        });
+
+        assert_is_true(p.renderViewports([
+            { width: 320, height: 480, file: files[0] },
+            { width: 768, height: 1024, file: files[1], quality: 70 },
+            { width: 1024, height: 768, file: files[2] }
+        ], { onlyViewport: true }));
+
+        assert_equals(pngWidth(files[0]), 320);
+        assert_equals(fs.read(files[1], "b").substr(0, 2), "\xFF\xD8");
+        assert_equals(pngWidth(files[2]), 1024);
+        assert_equals(loads, 1);
+        assert_equals(p.viewportSize.width, 500);
+    }));
+
+}, "renderViewports() captures several sizes from one load and restores the viewport");
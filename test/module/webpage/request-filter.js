@@ -0,0 +1,40 @@
+var webpage = require("webpage");
+
+function imageWidths(page) {
+    return page.evaluate(function () {
+        return Array.prototype.map.call(document.images, function (image) { return image.naturalWidth; });
+    });
+}
+
+async_test(function () {
+    var page = webpage.create();
+    var errors = [];
+    page.onResourceError = function (error) { errors.push(error.url); };
+
+    var stats = page.setRequestFilter({
+        rules: ["! comment", "/logo.png$image", "@@/logo.png$image,domain=example.com", "example.com##.ad"]
+    });
+    assert_equals(stats.rules, 2);
+    assert_equals(stats.skipped, 1);
+
+    page.open(TEST_HTTP_BASE + "load-images.html", this.step_func_done(function (status) {
+        assert_equals(status, "success");
+        var widths = imageWidths(page);
+        assert_equals(widths[0], 0);
+        assert_greater_than(widths[1], 0);
+        assert_equals(errors.length, 1);
+    }));
+
+}, "blocking rules are applied to requests without a callback per request");
+
+async_test(function () {
+    var page = webpage.create();
+    page.setRequestFilter({ resourceTypes: ["image"] });
+    page.setRequestFilter(null);
+
+    page.open(TEST_HTTP_BASE + "load-images.html", this.step_func_done(function (status) {
+        assert_equals(status, "success");
+        imageWidths(page).forEach(function (width) { assert_greater_than(width, 0); });
+    }));
+
+}, "setRequestFilter(null) removes the filter");
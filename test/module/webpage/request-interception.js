@@ -0,0 +1,83 @@
+var webpage = require('webpage');
+
+async_test(function () {
+    var page = webpage.create();
+    var requested = {};
+    var received = 0;
+
+    page.onResourceRequested = this.step_func(function (requestData, request) {
+        assert_type_of(requestData.id, 'number');
+        assert_is_true(!requested[requestData.id]);
+        requested[requestData.id] = requestData.url;
+        assert_type_of(request.abort, 'function');
+    });
+
+    page.onResourceReceived = this.step_func(function (response) {
+        assert_equals(response.url, requested[response.id]);
+        ++received;
+    });
+
+    page.open(TEST_HTTP_BASE + 'load-images.html', this.step_func_done(function (status) {
+        assert_equals(status, 'success');
+        assert_greater_than(Object.keys(requested).length, 2);
+        assert_greater_than(received, 2);
+    }));
+
+}, "intercepted requests have numeric ids shared with their responses");
+
+async_test(function () {
+    var page = webpage.create();
+    page.settings.interceptDeadline = 50;
+    var loaded = false;
+
+    page.onResourceRequested = this.step_func(function (requestData, request) {
+        request.setHeader('X-Deadline-Test', null);
+    });
+    page.onResourceReceived = this.step_func(function (response) {
+        if (response.url.indexOf('logo.png') !== -1) {
+            loaded = true;
+        }
+    });
+
+    page.open(TEST_HTTP_BASE + 'load-images.html', this.step_func_done(function (status) {
+        assert_equals(status, 'success');
+        assert_is_true(loaded);
+    }));
+
+}, "requests still load with a short interception deadline");
+
+async_test(function () {
+    var page = webpage.create();
+    var aborted = /logo\.png$/;
+    var received = {};
+
+    page.onResourceRequested = this.step_func(function (requestData, request) {
+        if (aborted.test(requestData.url)) {
+            request.abort();
+        }
+    });
+    page.onResourceReceived = this.step_func(function (response) {
+        assert_regexp_not_match(response.url, aborted);
+        received[response.url] = true;
+    });
+
+    page.open(TEST_HTTP_BASE + 'load-images.html', this.step_func_done(function (status) {
+        assert_equals(status, 'success');
+        assert_is_true(!!received[TEST_HTTP_BASE + 'phantomjs.png']);
+    }));
+
+}, "an aborted request never produces a response during page load");
+
+async_test(function () {
+    var page = webpage.create();
+
+    page.onResourceRequested = this.step_func(function (requestData, request) {
+        request.setHeader('X-Intercepted', 'yes');
+    });
+
+    page.open(TEST_HTTP_BASE + 'echo', this.step_func_done(function (status) {
+        assert_equals(status, 'success');
+        assert_equals(JSON.parse(page.plainText).headers['x-intercepted'], 'yes');
+    }));
+
+}, "headers set while intercepting reach the server");
@@ -0,0 +1,37 @@
+var webpage = require('webpage');
+
+async_test(function () {
+    var page = webpage.create();
+    var started = {};
+    var finished = {};
+
+    page.onResourceReceived = this.step_func(function (resource) {
+        assert_type_of(resource.id, 'number');
+        if (resource.stage === 'start') {
+            started[resource.id] = resource.url;
+        }
+        if (resource.stage === 'end') {
+            finished[resource.id] = resource;
+        }
+    });
+
+    page.open(TEST_HTTP_BASE + 'load-images.html', this.step_func_done(function (status) {
+        assert_equals(status, 'success');
+        var ids = Object.keys(finished);
+        assert_greater_than(ids.length, 1);
+        ids.forEach(function (id) {
+            var resource = finished[id];
+            assert_equals(started[id], resource.url);
+            assert_type_of(resource.timings, 'object');
+            ['dns', 'connect', 'tls', 'ttfb', 'download', 'total'].forEach(function (phase) {
+                assert_type_of(resource.timings[phase], 'number');
+            });
+            assert_greater_than(resource.timings.total, -1);
+            assert_is_false(resource.fromCache);
+            assert_greater_than(resource.encodedSize, 0);
+            // The test server doesn't compress, so nothing is decoded.
+            assert_equals(resource.decodedSize, resource.encodedSize);
+        });
+    }));
+
+}, "finished resources report ids, a timing breakdown and body sizes");
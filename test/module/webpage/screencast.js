@@ -0,0 +1,29 @@
+var fs      = require("fs");
+var webpage = require("webpage");
+
+async_test(function () {
+    var p = webpage.create();
+    p.viewportSize = { width: 320, height: 240 };
+    var file = "temp_screencast.mjpeg";
+    this.add_cleanup(function () {
+        [file, file + ".txt"].forEach(function (f) { if (fs.exists(f)) fs.remove(f); });
+    });
+
+    p.open(TEST_HTTP_BASE + "render/", this.step_func(function (status) {
+        assert_equals(status, "success");
+        assert_is_true(p.startScreencast({ file: file, fps: 30, maxWidth: 160 }));
+        p.evaluate(function () {
+            var n = 0;
+            setInterval(function () { document.body.style.background = (++n % 2) ? "red" : "blue"; }, 20);
+        });
+
+        setTimeout(this.step_func_done(function () {
+            var stats = p.stopScreencast();
+            assert_equals(stats.file, file);
+            assert_greater_than(stats.frames, 0);
+            assert_equals(fs.read(file, "b").charCodeAt(0), 0xFF);
+            assert_equals(fs.read(file + ".txt").split("\n").length - 1, stats.frames);
+        }), 500);
+    }));
+
+}, "startScreencast/stopScreencast record JPEG frames to an MJPEG stream");
@@ -17,3 +17,17 @@ test(function () {
     assert_equals(actualLocation, expectedLocation);
 
 }, "manually set page content and location");
+
+test(function () {
+    var page = webpage.create();
+    page.setContent('<html><body><div>First</div></body></html>', 'http://www.phantomjs.org/');
+    page.setContent('<html><body><div>Second</div></body></html>', 'http://www.phantomjs.org/');
+
+    assert_equals(page.evaluate(function () { return document.body.textContent; }), 'Second');
+    assert_equals(page.plainText, 'Second');
+
+    page.content = '<html><body><p>Third</p></body></html>';
+    assert_regexp_match(page.content, /<p>Third<\/p>/);
+    assert_equals(page.evaluate(function () { return document.body.textContent; }), 'Third');
+
+}, "queries after replacing the content see the new document");
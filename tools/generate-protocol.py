@@ -0,0 +1,280 @@
+#!/usr/bin/env python3
+"""Generate the C++ and Node bindings for the Playwright backend IPC protocol.
+
+The protocol is described once in src/engines/playwright_protocol.json. This
+script turns it into:
+
+  * src/core/playwrightprotocol.h   - command/event ids, typed parameter and
+                                      event structs for PlaywrightEngineBackend
+  * src/engines/playwright_protocol.js - the same ids plus a dispatch table
+                                         builder for playwright_backend.js
+
+Usage:
+    tools/generate-protocol.py           # rewrite the generated files
+    tools/generate-protocol.py --check   # fail if they are out of date
+"""
+
+import argparse
+import json
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SCHEMA = os.path.join(ROOT, "src", "engines", "playwright_protocol.json")
+CPP_OUT = os.path.join(ROOT, "src", "core", "playwrightprotocol.h")
+JS_OUT = os.path.join(ROOT, "src", "engines", "playwright_protocol.js")
+
+BANNER = "Generated by tools/generate-protocol.py from src/engines/playwright_protocol.json. Do not edit."
+
+# schema type -> (C++ type, default initialiser, to-JSON expression, from-JSON expression)
+CPP_TYPES = {
+    "string": ("QString", None, "{v}", "{j}.toString()"),
+    "url": ("QUrl", None, "{v}.toString()", "QUrl({j}.toString())"),
+    "int": ("int", "0", "{v}", "{j}.toInt()"),
+    "double": ("double", "0.0", "{v}", "{j}.toDouble()"),
+    "bool": ("bool", "false", "{v}", "{j}.toBool()"),
+    "object": ("QVariantMap", None, "QJsonObject::fromVariantMap({v})", "{j}.toObject().toVariantMap()"),
+    "list": ("QVariantList", None, "QJsonArray::fromVariantList({v})", "{j}.toArray().toVariantList()"),
+    "stringList": ("QStringList", None, "QJsonArray::fromStringList({v})", "stringListFromJson({j})"),
+    "variant": ("QVariant", None, "QJsonValue::fromVariant({v})", "{j}.toVariant()"),
+    "rect": ("QRect", None, "rectToJson({v})", "rectFromJson({j})"),
+    "point": ("QPoint", None, "pointToJson({v})", "pointFromJson({j})"),
+}
+
+
+def pascal(name):
+    return name[0].upper() + name[1:]
+
+
+def load_schema(path):
+    with open(path, encoding="utf-8") as f:
+        schema = json.load(f)
+    seen = set()
+    for section in ("commands", "events"):
+        for entry in schema[section]:
+            key = (section, entry["name"])
+            if key in seen:
+                raise SystemExit("duplicate %s entry '%s'" % key)
+            seen.add(key)
+            for group in ("params", "fields", "reply"):
+                for field, ftype in entry.get(group, {}).items():
+                    if ftype not in CPP_TYPES:
+                        raise SystemExit("%s.%s: unknown type '%s'" % (entry["name"], field, ftype))
+    return schema
+
+
+def cpp_members(fields):
+    out = []
+    for field, ftype in fields.items():
+        ctype, default, _, _ = CPP_TYPES[ftype]
+        out.append("    %s %s%s;" % (ctype, field, " = " + default if default else ""))
+    return out
+
+
+def cpp_to_json(fields):
+    out = ["    QJsonObject toJson() const {", "        QJsonObject o;"]
+    for field, ftype in fields.items():
+        expr = CPP_TYPES[ftype][2].format(v=field)
+        out.append('        o.insert(QStringLiteral("%s"), %s);' % (field, expr))
+    out += ["        return o;", "    }"]
+    return out
+
+
+def cpp_from_json(struct, fields):
+    arg = "o" if fields else "/* o */"
+    out = ["    static %s fromJson(const QJsonObject& %s) {" % (struct, arg), "        %s s;" % struct]
+    for field, ftype in fields.items():
+        expr = CPP_TYPES[ftype][3].format(j='o.value(QStringLiteral("%s"))' % field)
+        out.append("        s.%s = %s;" % (field, expr))
+    out += ["        return s;", "    }"]
+    return out
+
+
+def generate_cpp(schema):
+    commands, events = schema["commands"], schema["events"]
+    lines = [
+        "// " + BANNER,
+        "",
+        "#ifndef PLAYWRIGHTPROTOCOL_H",
+        "#define PLAYWRIGHTPROTOCOL_H",
+        "",
+        "#include <QJsonArray>",
+        "#include <QJsonObject>",
+        "#include <QJsonValue>",
+        "#include <QPoint>",
+        "#include <QRect>",
+        "#include <QString>",
+        "#include <QStringList>",
+        "#include <QUrl>",
+        "#include <QVariant>",
+        "#include <QVariantList>",
+        "#include <QVariantMap>",
+        "",
+        "namespace PlaywrightProtocol {",
+        "",
+        "const int Version = %d;" % schema["version"],
+        "",
+        "enum class Command : int {",
+    ]
+    lines += ["    %s = %d," % (pascal(c["name"]), i) for i, c in enumerate(commands)]
+    lines += ["    Count", "};", "", "enum class Event : int {"]
+    lines += ["    %s = %d," % (pascal(e["name"]), i) for i, e in enumerate(events)]
+    lines += ["    Count", "};", ""]
+
+    for kind, entries in (("Command", commands), ("Event", events)):
+        lines += [
+            "inline const char* %sName(%s value) {" % (kind.lower(), kind),
+            "    static const char* const names[] = {",
+        ]
+        lines += ['        "%s",' % e["name"] for e in entries]
+        lines += [
+            "    };",
+            "    const int index = static_cast<int>(value);",
+            "    return index >= 0 && index < static_cast<int>(%s::Count) ? names[index] : \"<unknown>\";" % kind,
+            "}",
+            "",
+        ]
+
+    lines += [
+        "inline QJsonObject rectToJson(const QRect& r) {",
+        '    return QJsonObject { { QStringLiteral("x"), r.x() }, { QStringLiteral("y"), r.y() },',
+        '        { QStringLiteral("width"), r.width() }, { QStringLiteral("height"), r.height() } };',
+        "}",
+        "inline QRect rectFromJson(const QJsonValue& v) {",
+        "    const QJsonObject o = v.toObject();",
+        '    return QRect(o.value(QStringLiteral("x")).toInt(), o.value(QStringLiteral("y")).toInt(),',
+        '        o.value(QStringLiteral("width")).toInt(), o.value(QStringLiteral("height")).toInt());',
+        "}",
+        "inline QJsonObject pointToJson(const QPoint& p) {",
+        '    return QJsonObject { { QStringLiteral("x"), p.x() }, { QStringLiteral("y"), p.y() } };',
+        "}",
+        "inline QPoint pointFromJson(const QJsonValue& v) {",
+        "    const QJsonObject o = v.toObject();",
+        '    return QPoint(o.value(QStringLiteral("x")).toInt(), o.value(QStringLiteral("y")).toInt());',
+        "}",
+        "inline QStringList stringListFromJson(const QJsonValue& v) {",
+        "    QStringList list;",
+        "    for (const QJsonValue& item : v.toArray()) {",
+        "        list.append(item.toString());",
+        "    }",
+        "    return list;",
+        "}",
+        "",
+        "// --- Commands (C++ -> Node) ---",
+        "",
+    ]
+    for c in commands:
+        struct = pascal(c["name"]) + "Command"
+        params = c.get("params", {})
+        lines += [
+            "struct %s {" % struct,
+            "    static constexpr Command id = Command::%s;" % pascal(c["name"]),
+            "    static constexpr bool isSync = %s;" % ("true" if c.get("sync") else "false"),
+        ]
+        lines += cpp_members(params)
+        lines += cpp_to_json(params)
+        lines += ["};", ""]
+
+    lines += ["// --- Events (Node -> C++) ---", ""]
+    for e in events:
+        struct = pascal(e["name"]) + "Event"
+        lines += ["struct %s {" % struct, "    static constexpr Event id = Event::%s;" % pascal(e["name"])]
+        if e.get("payload"):
+            lines += [
+                "    QVariantMap data;",
+                "    static %s fromJson(const QJsonObject& o) {" % struct,
+                "        %s s;" % struct,
+                "        s.data = o.toVariantMap();",
+                "        return s;",
+                "    }",
+            ]
+        else:
+            fields = e.get("fields", {})
+            lines += cpp_members(fields)
+            lines += cpp_from_json(struct, fields)
+        lines += ["};", ""]
+        if "reply" in e:
+            reply = pascal(e["name"]) + "Reply"
+            lines += ["struct %s {" % reply, "    static constexpr Event id = Event::%s;" % pascal(e["name"])]
+            lines += cpp_members(e["reply"])
+            lines += cpp_to_json(e["reply"])
+            lines += ["};", ""]
+
+    lines += ["} // namespace PlaywrightProtocol", "", "#endif // PLAYWRIGHTPROTOCOL_H", ""]
+    return "\n".join(lines)
+
+
+def generate_js(schema):
+    commands, events = schema["commands"], schema["events"]
+    lines = [
+        "// " + BANNER,
+        "",
+        "'use strict';",
+        "",
+        "const PROTOCOL_VERSION = %d;" % schema["version"],
+        "",
+        "const Command = Object.freeze({",
+    ]
+    lines += ["    %s: %d," % (c["name"], i) for i, c in enumerate(commands)]
+    lines += ["});", "", "const CommandInfo = Object.freeze(["]
+    lines += [
+        "    { name: '%s', sync: %s }," % (c["name"], "true" if c.get("sync") else "false") for c in commands
+    ]
+    lines += ["]);", "", "const Event = Object.freeze({"]
+    lines += ["    %s: %d," % (e["name"], i) for i, e in enumerate(events)]
+    lines += ["});", "", "const EventInfo = Object.freeze(["]
+    lines += [
+        "    { name: '%s', reply: %s }," % (e["name"], "true" if "reply" in e else "false") for e in events
+    ]
+    lines += [
+        "]);",
+        "",
+        "// Turns a { commandName: handler } object into an array indexed by command id.",
+        "// Throws if the schema declares a command the handlers object does not implement.",
+        "function buildDispatchTable(handlers) {",
+        "    return CommandInfo.map(info => {",
+        "        const handler = handlers[info.name];",
+        "        if (typeof handler !== 'function') {",
+        "            throw new Error(`No handler for protocol command '${info.name}'`);",
+        "        }",
+        "        return handler;",
+        "    });",
+        "}",
+        "",
+        "module.exports = { PROTOCOL_VERSION, Command, CommandInfo, Event, EventInfo, buildDispatchTable };",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true", help="only verify that the generated files are current")
+    args = parser.parse_args()
+
+    schema = load_schema(SCHEMA)
+    outputs = {CPP_OUT: generate_cpp(schema), JS_OUT: generate_js(schema)}
+
+    stale = []
+    for path, content in outputs.items():
+        current = None
+        if os.path.exists(path):
+            with open(path, encoding="utf-8") as f:
+                current = f.read()
+        if current == content:
+            continue
+        if args.check:
+            stale.append(os.path.relpath(path, ROOT))
+        else:
+            with open(path, "w", encoding="utf-8", newline="\n") as f:
+                f.write(content)
+            print("wrote " + os.path.relpath(path, ROOT))
+
+    if stale:
+        sys.stderr.write("out of date: %s (run tools/generate-protocol.py)\n" % ", ".join(stale))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())